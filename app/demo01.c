@@ -104,8 +104,7 @@ void Demo01Main(float dt)
     SrpTransformerSetRotationf(vRot, sg_angle);
     SrpTransformerSetScalef(vScale);
 
-    SrpTransRenderListLocToCam(sg_pRl);
-    SrpTransRenderListCamToProj(sg_pRl);
+    SrpTransRenderListLocToClip(sg_pRl);
     SrpTransRenderListProjToScr(sg_pRl); 
 
     SrpDrawRenderList(sg_pRl);
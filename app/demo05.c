@@ -7,6 +7,7 @@
 #include "vector_srp.h"
 #include "renderee_srp.h"
 #include "model_srp.h"
+#include "octree_srp.h"
 #include "math_srp.h"
 
 #define TANK_ROW 8
@@ -16,12 +17,14 @@
 static RENDER_LIST *sg_pRl;
 static MODEL *sg_pModel;
 static OBJECT *sg_pTanks[TANK_NUM];
+static OCTREE *sg_pOctree;
 
 void Demo05Init(void)
 {
     int i, j;
     float tankRadius, tankSpace, tankSpanRow, tankSpanCol;
     float tankX, tankZ;
+    VECTOR3F center;
 
     if (!SrpCreateRenderList(&sg_pRl))
     {
@@ -40,6 +43,15 @@ void Demo05Init(void)
     tankSpanRow = (tankRadius * TANK_COL + tankSpace * (TANK_COL - 1)) * 0.5f;
     tankSpanCol = (tankRadius * TANK_ROW + tankSpace * (TANK_ROW - 1)) * 0.5f;
 
+    SrpVectorLoad3f(center, 0.0f, 0.0f, 0.0f);
+    if (!SrpCreateOctree(&sg_pOctree, center, 
+                         SrpMathMax(tankSpanRow, tankSpanCol) + tankRadius, 
+                         3))
+    {
+        printf("Demo Init error.\n");
+        return;
+    }
+
     for (i = 0; i < TANK_ROW; i++)
     {
         for (j = 0; j < TANK_COL; j++)
@@ -57,6 +69,13 @@ void Demo05Init(void)
                 printf("Demo Init error.\n");
                 return;
             }
+
+            if (!SrpOctreeInsertObject(sg_pOctree, 
+                                       sg_pTanks[i * TANK_ROW + j]))
+            {
+                printf("Demo Init error.\n");
+                return;
+            }
         }
     }
 
@@ -106,8 +125,8 @@ void Demo05Main(float dt)
     for (i = 0; i < TANK_NUM; i++)
     {
         SrpRotateObject(sg_pTanks[i], 0.0f, objectAngle, 0.0f);
-        SrpDrawObject(sg_pTanks[i], sg_pRl);
     }
+    SrpOctreeDrawObjects(sg_pOctree, sg_pRl);
     SrpTransRenderListCamToProj(sg_pRl);
     SrpTransRenderListProjToScr(sg_pRl); 
 
@@ -118,6 +137,7 @@ void Demo05Quit(void)
 {
     int i;
 
+    SrpDeleteOctree(sg_pOctree);
     for (i = 0; i < TANK_NUM; i++)
     {
         SrpDeleteObject(sg_pTanks[i]);
@@ -7,6 +7,9 @@
 #include "vector_srp.h"
 #include "renderee_srp.h"
 #include "model_srp.h"
+#include "loader_srp.h"
+#include "scene_srp.h"
+#include "pool_srp.h"
 #include "math_srp.h"
 
 #define MARKER_NUM_SIZE    21
@@ -21,15 +24,37 @@
 
 static RENDER_LIST *sg_pRl;
 static MODEL *sg_pModelMarker, *sg_pModelTower, *sg_pModelPlayer;
-static OBJECT *sg_pMarkers[MARKER_NUM], *sg_pTowers[TOWER_NUM], *sg_pPlayer;
+static MODEL *sg_pModelProxy;
+static OBJECT_POOL *sg_pPool;
+static OBJECT *sg_pPlayer;
+static SCENE_NODE *sg_pScene;
 
 static VECTOR3F sg_cam;
 
+static void Demo06PlayerLoaded(int ticket, MODEL *pModel, void *pUser)
+{
+    (void)ticket;
+    (void)pUser;
+
+    if (pModel == NULL)
+    {
+        printf("Demo load error.\n");
+        return;
+    }
+
+    sg_pModelPlayer = pModel;
+    SrpSetObjectModel(sg_pPlayer, sg_pModelPlayer);
+}
+
 void Demo06Init(void)
 {
     int i, j;
     float objectRadius;
     float objectX, objectZ;
+    SCENE_NODE *pRow, *pNode;
+    OBJECT_HANDLE handle;
+    VECTOR3F proxyMin = {-70.0f, 0.0f, -100.0f};
+    VECTOR3F proxyMax = {70.0f, 70.0f, 100.0f};
 
     if (!SrpCreateRenderList(&sg_pRl))
     {
@@ -45,22 +70,50 @@ void Demo06Init(void)
 
     objectRadius = SrpModelGetRadius(sg_pModelMarker);
 
+    if (!SrpCreateObjectPool(&sg_pPool, MARKER_NUM + TOWER_NUM))
+    {
+        printf("Demo Init error.\n");
+        return;
+    }
+
+    if (!SrpCreateSceneNode(&sg_pScene, NULL))
+    {
+        printf("Demo Init error.\n");
+        return;
+    }
+
+    /* Markers are grouped by rows, so a row out of sight is culled at once */
     for (i = 0; i < MARKER_NUM_SIZE; i++)
     {
+        if (!SrpCreateSceneNode(&pRow, NULL))
+        {
+            printf("Demo Init error.\n");
+            return;
+        }
+        SrpSceneNodeAddChild(sg_pScene, pRow);
+
         for (j = 0; j < MARKER_NUM_SIZE; j++)
         {
             objectX = GRID_SIZE * j - UNIVERSE_RADIUS;
             objectZ = GRID_SIZE * i - UNIVERSE_RADIUS;
 
-            if (!SrpCreateObject(&sg_pMarkers[i * MARKER_NUM_SIZE + j], 
-                                 sg_pModelMarker, 
-                                 objectX, objectRadius, objectZ,
-                                 0.0f, 0.0f, 0.0f,
-                                 5.0f, 5.0f, 5.0f))
+            if (!SrpPoolCreateObject(sg_pPool, &handle, 
+                                     sg_pModelMarker, 
+                                     objectX, objectRadius, objectZ,
+                                     0.0f, 0.0f, 0.0f,
+                                     5.0f, 5.0f, 5.0f))
             {
                 printf("Demo Init error.\n");
                 return;
             }
+
+            if (!SrpCreateSceneNode(&pNode, 
+                                    SrpPoolGetObject(sg_pPool, handle)))
+            {
+                printf("Demo Init error.\n");
+                return;
+            }
+            SrpSceneNodeAddChild(pRow, pNode);
         }
     }
 
@@ -75,24 +128,38 @@ void Demo06Init(void)
         objectX = rand() % (int)(UNIVERSE_RADIUS * 2.0f)  - UNIVERSE_RADIUS;
         objectZ = rand() % (int)(UNIVERSE_RADIUS * 2.0f)  - UNIVERSE_RADIUS;
 
-        if (!SrpCreateObject(&sg_pTowers[i], 
-                             sg_pModelTower, 
-                             objectX, 0.0f, objectZ,
-                             0.0f, 0.0f, 0.0f,
-                             1.0f, 5.0f, 1.0f))
+        if (!SrpPoolCreateObject(sg_pPool, &handle, 
+                                 sg_pModelTower, 
+                                 objectX, 0.0f, objectZ,
+                                 0.0f, 0.0f, 0.0f,
+                                 1.0f, 5.0f, 1.0f))
+        {
+            printf("Demo Init error.\n");
+            return;
+        }
+
+        if (!SrpCreateSceneNode(&pNode, SrpPoolGetObject(sg_pPool, handle)))
         {
             printf("Demo Init error.\n");
             return;
         }
+        SrpSceneNodeAddChild(sg_pScene, pNode);
     }
 
-    if (!SrpModelLoadPLG(&sg_pModelPlayer, "./model/tank1.plg"))
+    /* Show a box until the player's model is loaded */
+    if (!SrpModelCreateBox(&sg_pModelProxy, proxyMin, proxyMax))
     {
         printf("Demo Init error.\n");
         return;
     }
 
-    if (!SrpCreateObject(&sg_pPlayer, sg_pModelPlayer, 
+    if (!SrpModelLoadAsync("./model/tank1.plg", Demo06PlayerLoaded, NULL))
+    {
+        printf("Demo Init error.\n");
+        return;
+    }
+
+    if (!SrpCreateObject(&sg_pPlayer, sg_pModelProxy, 
                          0.0f, 0.0f, -500.0f,
                          0.0f, 180.0f, 0.0f,
                          1.0f, 1.0f, 1.0f))
@@ -115,6 +182,8 @@ void Demo06Init(void)
     SrpRCSetClearColor(0, 0, 0, 0);
 
     SrpRCEnable(SRP_CULL_OBJECT);
+    SrpRCEnable(SRP_LOD_OBJECT);
+    SrpRCEnable(SRP_CULL_MESHLET);
 
     SrpVectorLoad3f(sg_cam, 0.0f, 80.0f, 0.0f);
 }
@@ -125,9 +194,10 @@ void Demo06Main(float dt)
     static float yTurning = 0.0f;
 
     float playerSpeed;
-    int i;
     VECTOR3F trans;
 
+    SrpModelPollAsync();
+
     if (KEYDOWN(VK_SPACE))
     {
         playerSpeed = PLAYER_SPEED * 4.0f;
@@ -199,15 +269,7 @@ void Demo06Main(float dt)
     SrpVectorSubtract3f(trans, ZERO_VECTOR, sg_cam);
     SrpTransformerSetTranslationf(trans);
 
-    for (i = 0; i < MARKER_NUM; i++)
-    {
-        SrpDrawObject(sg_pMarkers[i], sg_pRl);
-    }
-
-    for (i = 0; i < TOWER_NUM; i++)
-    {
-        SrpDrawObject(sg_pTowers[i], sg_pRl);
-    }
+    SrpSceneDraw(sg_pScene, sg_pRl);
 
     SrpTransRenderListCamToProj(sg_pRl);
     SrpTransRenderListProjToScr(sg_pRl); 
@@ -217,23 +279,20 @@ void Demo06Main(float dt)
 
 void Demo06Quit(void)
 {
-    int i;
+    SrpModelStopAsync();
 
-    for (i = 0; i < MARKER_NUM; i++)
-    {
-        SrpDeleteObject(sg_pMarkers[i]);
-    }
-
-    for (i = 0; i < TOWER_NUM; i++)
-    {
-        SrpDeleteObject(sg_pTowers[i]);
-    }
+    SrpDeleteSceneNode(sg_pScene);
+    SrpDeleteObjectPool(sg_pPool);
 
     SrpDeleteObject(sg_pPlayer);
 
     SrpModelRelease(sg_pModelMarker);
     SrpModelRelease(sg_pModelTower);
-    SrpModelRelease(sg_pModelPlayer);
+    SrpModelRelease(sg_pModelProxy);
+    if (sg_pModelPlayer != NULL)
+    {
+        SrpModelRelease(sg_pModelPlayer);
+    }
 
     SrpDeleteRenderList(sg_pRl);
 }
@@ -39,9 +39,9 @@ LRESULT CALLBACK WindowProc(HWND hwnd,
   
     case WM_PAINT: 
     {
-        // simply validate the window
+        // frames only blit what changed, so paint the last one whole
         hdc = BeginPaint(hwnd,&ps);      
-        // you would do all your painting here
+        SrpRepaint();
         EndPaint(hwnd,&ps);
 
         // return success
@@ -19,10 +19,27 @@
 
 /* Object */
 #define SRP_CULL_OBJECT    0x00000011
+#define SRP_LOD_OBJECT     0x00000012
+#define SRP_CULL_MESHLET   0x00000013
+#define SRP_CULL_SMALL     0x00000014
+#define SRP_VERTEX_STREAM  0x00000015
+
+/* What becomes of objects culled by SRP_CULL_SMALL */
+#define SRP_SMALL_DROP     0x00000000
+#define SRP_SMALL_SPLAT    0x00000001
 
 /* Polygon */
 #define SRP_CULL_FACE      0x00000021
 
+/* Buffer */
+#define SRP_LAZY_CLEAR     0x00000031
+
+/* Pixel format, named by its bytes from the lowest address */
+#define SRP_FORMAT_BGRA8   0x00000041
+#define SRP_FORMAT_RGBA8   0x00000042
+#define SRP_FORMAT_RGB565  0x00000043  /* A 16 bit word, in CPU byte order */
+#define SRP_FORMAT_INDEX8  0x00000044  /* An index into the RC's palette */
+
 #define SET_BIT(word, flag)       ((word) = (word) | (flag))
 #define RESET_BIT(word, flag)     ((word) = (word) & ~(flag))
 #define CLEAN_BIT(word)           ((word) = (word) & 0x0)
@@ -9,7 +9,10 @@
 #ifndef _FRUSTUM_SRP_H
 #define _FRUSTUM_SRP_H
 
+#include "datadef_ig.h"
 #include "vector_srp.h"
+#include "matrix_srp.h"
+#include "stream_srp.h"
 
 /*----------------------------------------------------------------------------*/
 /*                         Macros and Type Definitions                        */
@@ -18,6 +21,25 @@
 struct FRUSTUM_T;
 typedef struct FRUSTUM_T FRUSTUM;
 
+/*
+ * Where a sphere is with respect to a frustum
+ */
+#define FRUSTUM_OUTSIDE           0
+#define FRUSTUM_INTERSECT         1
+#define FRUSTUM_INSIDE            2
+
+/*
+ * Planes of a frustum to be tested, one bit each
+ */
+#define FRUSTUM_NUM_PLANES        6
+#define FRUSTUM_PLANES_ALL        0x0000003F
+#define FRUSTUM_PLANE_NEAR        0x00000001
+
+/*
+ * Most vertices a triangle clipped against a frustum can have
+ */
+#define FRUSTUM_MAX_CLIP_VERTICES (3 + FRUSTUM_NUM_PLANES)
+
 /*----------------------------------------------------------------------------*/
 /*                           Function Declarations                            */
 /*----------------------------------------------------------------------------*/
@@ -39,6 +61,14 @@ extern void SrpDeleteFrustum(FRUSTUM *pFrustum);
 extern void SrpSetFrustum(FRUSTUM *pFrustum, float fovy, float aspect, 
                           float near, float far);
 
+/*
+ * Transform a frustum into another space, m being the transformation 
+ * from that space to the frustum's, e.g. the modelview matrix for 
+ * a frustum in camera space to be put in world space.
+ */
+extern void SrpTransformFrustum(FRUSTUM *pOut, const FRUSTUM *pFrustum, 
+                                const MATRIX43F m);
+
 /* 
  * Check if an object is visible with a frustum.
  * The object is define by its postion and radius.
@@ -46,4 +76,67 @@ extern void SrpSetFrustum(FRUSTUM *pFrustum, float fovy, float aspect,
 extern int SrpIsVisibleInFrustum(const FRUSTUM *pFrustum, const VECTOR3F pos, 
                                  float radius);
 
+/* 
+ * Check if a point is inside a frustum.
+ */
+extern int SrpIsInsideFrustum(const FRUSTUM *pFrustum, const VECTOR3F pos);
+
+/*
+ * Get the outcodes of n points with a frustum, only against the planes 
+ * set in planeMask. pOutcode[i] has a bit set for each plane point i is 
+ * outside of, in the same order as in plane masks, 0 if it's inside.
+ */
+extern void SrpGetFrustumOutcodeArray(const FRUSTUM *pFrustum, 
+                                      const VECTOR3F *pos, int n, 
+                                      int planeMask, int *pOutcode);
+
+/*
+ * The same as SrpGetFrustumOutcodeArray, for the points of a stream.
+ */
+extern void SrpGetFrustumOutcodeStream(const FRUSTUM *pFrustum, 
+                                       const VEC3_STREAM *pStream, 
+                                       int planeMask, int *pOutcode);
+
+/*
+ * Clip a triangle against the planes of a frustum set in planeMask. 
+ * pPoly holds the triangle and has room for FRUSTUM_MAX_CLIP_VERTICES, 
+ * the number of vertices of the convex polygon left there is returned.
+ */
+extern int SrpClipTriangleInFrustum(const FRUSTUM *pFrustum, 
+                                    VECTOR3F *pPoly, int planeMask);
+
+/*
+ * Check if a sphere is outside, intersecting or completely inside 
+ * a frustum.
+ */
+extern int SrpClassifySphereInFrustum(const FRUSTUM *pFrustum, 
+                                      const VECTOR3F pos, float radius);
+
+/*
+ * Check a sphere against the planes of a frustum in *pPlaneMask, the 
+ * plane *pLastPlane first. Planes the sphere is completely inside are 
+ * cleared from the mask, and the plane culling it is kept in *pLastPlane.
+ */
+extern int SrpCullSphereInFrustum(const FRUSTUM *pFrustum, 
+                                  const VECTOR3F pos, float radius, 
+                                  int *pPlaneMask, int *pLastPlane);
+
+/*
+ * Check if n spheres are visible with a frustum, 8 or 4 at a time where 
+ * AVX or SSE is available. Centers are transformed with m first, unless 
+ * m is NULL. pVisible[i] is set to TRUE or FALSE for sphere i.
+ */
+extern void SrpCullSpheresBatch(const FRUSTUM *pFrustum, const MATRIX43F m,
+                                const float *x, const float *y, 
+                                const float *z, const float *r, int n, 
+                                byte *pVisible);
+
+/*
+ * Get the outcode of a point in homogeneous clip space, see 
+ * SrpMatrixMakePerspective44f. A bit is set for each frustum plane 
+ * the point is outside of, in the same order as in plane masks, so 
+ * a triangle whose vertices' outcodes AND to non-zero is invisible.
+ */
+extern int SrpGetClipOutcode(const VECTOR4F clip);
+
 #endif /* _FRUSTUM_SRP_H */
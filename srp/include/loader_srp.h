@@ -0,0 +1,47 @@
+/*******************************************************************************
+ * File   : loader_srp.h
+ * Content: Asynchronous model loading
+ *
+ * Coder  : Ean Jee
+ * Time   : 2026-10-19 11:05
+ ******************************************************************************/
+
+#ifndef _LOADER_SRP_H
+#define _LOADER_SRP_H
+
+#include "model_srp.h"
+
+/*----------------------------------------------------------------------------*/
+/*                         Macros and Type Definitions                        */
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Called back when a model requested with SrpModelLoadAsync is ready,
+ * pModel is NULL if loading failed. The model belongs to the callee.
+ */
+typedef void (*SRP_LOAD_CALLBACK)(int ticket, MODEL *pModel, void *pUser);
+
+/*----------------------------------------------------------------------------*/
+/*                           Function Declarations                            */
+/*----------------------------------------------------------------------------*/
+
+/* 
+ * Load model from PLG file on the loader thread, return a ticket which
+ * is handed back to pfCallback, 0 if the request can't be queued.
+ */
+extern int SrpModelLoadAsync(const char *fileName, 
+                             SRP_LOAD_CALLBACK pfCallback, void *pUser);
+
+/* 
+ * Call back for every model loaded since last time, return the number
+ * of them. Should be called once per frame.
+ */
+extern int SrpModelPollAsync(void);
+
+/* 
+ * Stop the loader thread. Pending requests are dropped, models loaded
+ * but not handed back are released.
+ */
+extern void SrpModelStopAsync(void);
+
+#endif /* _LOADER_SRP_H */
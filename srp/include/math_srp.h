@@ -53,9 +53,95 @@
 #define SrpMathFloatIsZero(a)  (fabsf(a) < EPSILON_E5F)
 #define SrpMathDoubleIsZero(a) (fabs(a) < EPSILON_E5D)
 
+/*
+ * Math the pipeline uses in its hot spots. They map to the C library, 
+ * or to the SrpMathFast* approximations below when the library and 
+ * the application are built with SRP_FAST_MATH defined. Call the fast 
+ * versions directly to use them at a single call site.
+ */
+#if defined(SRP_FAST_MATH)
+#define SrpMathSinf(x)          SrpMathFastSinf(x)
+#define SrpMathCosf(x)          SrpMathFastCosf(x)
+#define SrpMathTanf(x)          SrpMathFastTanf(x)
+#define SrpMathSinCosf(x, s, c) SrpMathFastSinCosf(x, s, c)
+#define SrpMathRsqrtf(x)        SrpMathFastRsqrtf(x)
+#define SrpMathRcpf(x)          SrpMathFastRcpf(x)
+#else
+#define SrpMathSinf(x)          sinf(x)
+#define SrpMathCosf(x)          cosf(x)
+#define SrpMathTanf(x)          tanf(x)
+#define SrpMathSinCosf(x, s, c) (*(s) = sinf(x), *(c) = cosf(x))
+#define SrpMathRsqrtf(x)        (1.0f / sqrtf(x))
+#define SrpMathRcpf(x)          (1.0f / (x))
+#endif
+
+/* Beyond this the fast trigonometric functions fall back to the C ones */
+#define SRP_FAST_TRIG_RANGE     8192.0f
+
+/* 
+ * Max errors of the fast functions against double precision, relative 
+ * but for sine and cosine, as measured over every float in range. 
+ * SrpMathCheckFast holds them to these.
+ */
+#define SRP_FAST_RSQRT_ERROR        3.0E-7
+#define SRP_FAST_RSQRT_ERROR_NO_SSE 5.0E-6
+#define SRP_FAST_RCP_ERROR          2.1E-7
+#define SRP_FAST_SINCOS_ERROR       1.0E-7
+#define SRP_FAST_TAN_ERROR          2.6E-7
+
+/*
+ * 16.16 fixed point numbers, integer part in the high 16 bits. The 
+ * rasterizer steps its edges with them when built with SRP_FIXED_POINT.
+ */
+typedef int FIXED16;
+
+#define FIXED16_SHIFT           16
+#define FIXED16_ONE             (1 << FIXED16_SHIFT)
+#define FIXED16_HALF            (1 << (FIXED16_SHIFT - 1))
+
+#define SrpFixedFromInt(i)      ((FIXED16)(i) * FIXED16_ONE)
+#define SrpFixedFromFloat(f)    ((FIXED16)((f) * (float)FIXED16_ONE))
+#define SrpFixedToFloat(x)      ((float)(x) * (1.0f / FIXED16_ONE))
+#define SrpFixedToInt(x)        ((x) >> FIXED16_SHIFT)
+#define SrpFixedRound(x)        (((x) + FIXED16_HALF) >> FIXED16_SHIFT)
+
 /*----------------------------------------------------------------------------*/
 /*                           Function Declarations                            */
 /*----------------------------------------------------------------------------*/
 
+/*
+ * Approximate 1 / sqrt(x), x > 0, within SRP_FAST_RSQRT_ERROR, or 
+ * SRP_FAST_RSQRT_ERROR_NO_SSE on targets without SSE.
+ */
+extern float SrpMathFastRsqrtf(float x);
+
+/*
+ * Approximate 1 / x, x != 0, within SRP_FAST_RCP_ERROR.
+ */
+extern float SrpMathFastRcpf(float x);
+
+/*
+ * Approximate sine and cosine of x in radians, within 
+ * SRP_FAST_SINCOS_ERROR for |x| <= SRP_FAST_TRIG_RANGE.
+ */
+extern float SrpMathFastSinf(float x);
+extern float SrpMathFastCosf(float x);
+extern void SrpMathFastSinCosf(float x, float *pSin, float *pCos);
+
+/*
+ * Approximate tangent of x in radians, within SRP_FAST_TAN_ERROR for 
+ * |x| < 1.4, and where |sin x| and |cos x| are both at least 0.1. Near 
+ * the poles, and near the zeros of larger x, the error of sine and 
+ * cosine gets divided by a small number.
+ */
+extern float SrpMathFastTanf(float x);
+
+/*
+ * Check the fast functions against the C library in double precision, 
+ * on every step-th float of their ranges. Return FALSE, and print how 
+ * far off, if one is outside its bound. With step 1 it checks all of 
+ * them, in a few minutes.
+ */
+extern int SrpMathCheckFast(int step);
 
 #endif /* _MATH_SRP_H */
@@ -1,6 +1,6 @@
 /*******************************************************************************
  * File   : matrix_srp.h
- * Content: Matrix functions. For now, just 4X3 matrix.
+ * Content: Matrix functions, 4X3 matrix and 4X4 matrix for projection.
  *
  * Coder  : Ean Jee
  * Time   : 2011-04-20 11:51
@@ -26,6 +26,18 @@
 typedef float MATRIX43F[12];
 typedef double MATRIX43D[12];
 
+/*
+ * 4X4 matrix, row major, used where a 4X3 one can't do, i.e. 
+ * projection into homogeneous clip space. Aligned so each row 
+ * loads into one SSE register.
+ *
+ * |  0  1  2  3 |
+ * |  4  5  6  7 |
+ * |  8  9 10 11 |
+ * | 12 13 14 15 |
+ */
+typedef SRP_ALIGN(16) float MATRIX44F[16];
+
 /*----------------------------------------------------------------------------*/
 /*                           Function Declarations                            */
 /*----------------------------------------------------------------------------*/
@@ -33,22 +45,22 @@ typedef double MATRIX43D[12];
 /*
  * Load identity.
  */
-extern void SrpMatrixLoadIdentity43f(MATRIX43F m);
-extern void SrpMatrixLoadIdentity43d(MATRIX43D m);
+SRP_MATH_API void SrpMatrixLoadIdentity43f(MATRIX43F m);
+SRP_MATH_API void SrpMatrixLoadIdentity43d(MATRIX43D m);
 
 /*
  * Copy Matrix.
  */
-extern void SrpMatrixCopy43f(MATRIX43F dst, const MATRIX43F src);
-extern void SrpMatrixCopy43d(MATRIX43D dst, const MATRIX43D src);
+SRP_MATH_API void SrpMatrixCopy43f(MATRIX43F dst, const MATRIX43F src);
+SRP_MATH_API void SrpMatrixCopy43d(MATRIX43D dst, const MATRIX43D src);
 
 /*
  * Multiply matrix, out = a * b.
  */
-extern void SrpMatrixMultiply43f(MATRIX43F out, const MATRIX43F a, 
-                                 const MATRIX43F b);
-extern void SrpMatrixMultiply43d(MATRIX43D out, const MATRIX43D a, 
-                                 const MATRIX43D b);
+SRP_MATH_API void SrpMatrixMultiply43f(float *SRP_RESTRICT out, 
+                                       const MATRIX43F a, const MATRIX43F b);
+SRP_MATH_API void SrpMatrixMultiply43d(double *SRP_RESTRICT out, 
+                                       const MATRIX43D a, const MATRIX43D b);
 
 /*
  * Invert matrix.
@@ -56,6 +68,13 @@ extern void SrpMatrixMultiply43d(MATRIX43D out, const MATRIX43D a,
 extern int SrpMatrixInvert43f(MATRIX43F out, const MATRIX43F m);
 extern int SrpMatrixInvert43d(MATRIX43D out, const MATRIX43D m);
 
+/*
+ * Check if a matrix is rigid, i.e. rotation and translation only, 
+ * and invert such a matrix, much cheaper than SrpMatrixInvert43f.
+ */
+extern int SrpMatrixIsRigid43f(const MATRIX43F m);
+extern void SrpMatrixInvertRigid43f(MATRIX43F out, const MATRIX43F m);
+
 /*
  * Make a 'pure' translation matrix for 'object' transformation 
  * from local to parent space.
@@ -92,19 +111,76 @@ extern void SrpMatrixMakeScale43d(MATRIX43D out, const VECTOR3D v);
 /*
  * Transform vector, out = v * m.
  */
-extern void SrpMatrixTransformVector3f(VECTOR3F out, const VECTOR3F v, 
-                                       const MATRIX43F m);
-extern void SrpMatrixTransformVector3d(VECTOR3D out, const VECTOR3D v, 
-                                       const MATRIX43D m);
-extern void SrpMatrixTransformVector4f(VECTOR4F out, const VECTOR4F v, 
-                                       const MATRIX43F m);
-extern void SrpMatrixTransformVector4d(VECTOR4D out, const VECTOR4D v, 
-                                       const MATRIX43D m);
+SRP_MATH_API void SrpMatrixTransformVector3f(float *SRP_RESTRICT out, 
+                                             const VECTOR3F v, 
+                                             const MATRIX43F m);
+SRP_MATH_API void SrpMatrixTransformVector3d(double *SRP_RESTRICT out, 
+                                             const VECTOR3D v, 
+                                             const MATRIX43D m);
+SRP_MATH_API void SrpMatrixTransformVector4f(float *SRP_RESTRICT out, 
+                                             const VECTOR4F v, 
+                                             const MATRIX43F m);
+SRP_MATH_API void SrpMatrixTransformVector4d(double *SRP_RESTRICT out, 
+                                             const VECTOR4D v, 
+                                             const MATRIX43D m);
+
+/*
+ * Transform an array of vectors, out[i] = in[i] * m.
+ */
+extern void SrpMatrixTransformVectors3f(VECTOR3F *out, const VECTOR3F *in, 
+                                        int count, const MATRIX43F m);
+
+/*
+ * 4X4 matrix functions, like the 4X3 ones above.
+ */
+extern void SrpMatrixLoadIdentity44f(MATRIX44F m);
+extern void SrpMatrixCopy44f(MATRIX44F dst, const MATRIX44F src);
+extern void SrpMatrixMultiply44f(float *SRP_RESTRICT out, 
+                                 const MATRIX44F a, const MATRIX44F b);
+
+/*
+ * Expand a 4X3 matrix into a 4X4 one, the last column being (0 0 0 1).
+ */
+extern void SrpMatrixExpand43f(MATRIX44F out, const MATRIX43F m);
+
+/*
+ * Multiply a 4X3 matrix by a 4X4 one, out = a * b, e.g. the modelview 
+ * and projection matrices fused into one.
+ */
+extern void SrpMatrixMultiply43x44f(float *SRP_RESTRICT out, 
+                                    const MATRIX43F a, const MATRIX44F b);
+
+/*
+ * Make a perspective projection matrix from camera space, camera 
+ * looking down -z, into homogeneous clip space, where a point is 
+ * inside the frustum when -w <= x, y, z <= w. fovy, aspect, near and 
+ * far are as SrpTransformerSetProjection takes them.
+ */
+extern void SrpMatrixMakePerspective44f(MATRIX44F out, float fovy, 
+                                        float aspect, float near, float far);
+
+/*
+ * Transform point v, w being 1, into homogeneous vector out = v * m.
+ */
+extern void SrpMatrixTransformVector44f(float *SRP_RESTRICT out, 
+                                        const VECTOR3F v, const MATRIX44F m);
+
+/*
+ * Transform an array of points into homogeneous vectors, 
+ * out[i] = in[i] * m.
+ */
+extern void SrpMatrixTransformVectors44f(VECTOR4F *out, const VECTOR3F *in, 
+                                         int count, const MATRIX44F m);
 
 /*
  * Print matrix.
  */
 extern void SrpMatrixPrint43f(const MATRIX43F m, const char *name);
 extern void SrpMatrixPrint43d(const MATRIX43D m, const char *name);
+extern void SrpMatrixPrint44f(const MATRIX44F m, const char *name);
+
+#if defined(SRP_INLINE_MATH)
+#include "matrixinline_srp.h"
+#endif
 
 #endif /* _MATRIX_SRP_H */
@@ -0,0 +1,171 @@
+/*******************************************************************************
+ * File   : matrixinline_srp.h
+ * Content: Matrix functions defined inline, see SRP_INLINE_MATH in 
+ *          vector_srp.h.
+ *
+ * Coder  : Ean Jee
+ * Time   : 2026-10-19 11:20
+ ******************************************************************************/
+
+#ifndef _MATRIXINLINE_SRP_H
+#define _MATRIXINLINE_SRP_H
+
+#include <string.h>
+#include "matrix_srp.h"
+
+/*----------------------------------------------------------------------------*/
+/*                            Function Definitions                            */
+/*----------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------
+ * void SrpMatrixLoadIdentity43f(MATRIX43F m)
+ * void SrpMatrixLoadIdentity43d(MATRIX43D m)
+ *
+ * These functions load identity matrix into the argument. 
+ */
+void SrpMatrixLoadIdentity43f(MATRIX43F m)
+{
+    static MATRIX43F s_identity = {
+        1.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f,
+        0.0f, 0.0f, 1.0f,
+        0.0f, 0.0f, 0.0f
+    };
+
+    memcpy(m, s_identity, sizeof(MATRIX43F));
+}
+
+void SrpMatrixLoadIdentity43d(MATRIX43D m)
+{
+    static MATRIX43D s_identity = {
+        1.0, 0.0, 0.0,
+        0.0, 1.0, 0.0,
+        0.0, 0.0, 1.0,
+        0.0, 0.0, 0.0
+    };
+
+    memcpy(m, s_identity, sizeof(MATRIX43D));
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpMatrixCopy43f(MATRIX43F dst, const MATRIX43F src)
+ * void SrpMatrixCopy43d(MATRIX43D dst, const MATRIX43D src)
+ *
+ * These functions copy matrix src into dst.
+ */
+void SrpMatrixCopy43f(MATRIX43F dst, const MATRIX43F src)
+{
+    memcpy(dst, src, sizeof(MATRIX43F));
+}
+
+void SrpMatrixCopy43d(MATRIX43D dst, const MATRIX43D src)
+{
+    memcpy(dst, src, sizeof(MATRIX43D));
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpMatrixMultiply43f(float *SRP_RESTRICT out, const MATRIX43F a, 
+ *                           const MATRIX43F b)
+ * void SrpMatrixMultiply43d(double *SRP_RESTRICT out, const MATRIX43D a, 
+ *                           const MATRIX43D b)
+ *
+ * These functions do 4X3 matrix multiplication. out = a * b.
+ * Each of those 4X3 matrices has a invisible 4th column [0, 0, 0, 1]T.
+ *
+ * | 0  1  2 '0' |     | 0  1  2 '0' |
+ * | 3  4  5 '0' |  X  | 3  4  5 '0' |
+ * | 6  7  8 '0' |     | 6  7  8 '0' |
+ * | 9 10 11 '1' |     | 9 10 11 '1' |
+ */
+void SrpMatrixMultiply43f(float *SRP_RESTRICT out, const MATRIX43F a, 
+                          const MATRIX43F b)
+{
+    /* The linear transformation portion is the same as 3X3 Matrix. */
+    out[0] = a[0] * b[0] + a[1] * b[3] + a[2] * b[6];
+    out[1] = a[0] * b[1] + a[1] * b[4] + a[2] * b[7];
+    out[2] = a[0] * b[2] + a[1] * b[5] + a[2] * b[8];
+
+    out[3] = a[3] * b[0] + a[4] * b[3] + a[5] * b[6];
+    out[4] = a[3] * b[1] + a[4] * b[4] + a[5] * b[7];
+    out[5] = a[3] * b[2] + a[4] * b[5] + a[5] * b[8];
+
+    out[6] = a[6] * b[0] + a[7] * b[3] + a[8] * b[6];
+    out[7] = a[6] * b[1] + a[7] * b[4] + a[8] * b[7];
+    out[8] = a[6] * b[2] + a[7] * b[5] + a[8] * b[8];
+
+    /* Now the translation portion. */
+    out[9]  = a[9] * b[0] + a[10] * b[3] + a[11] * b[6] + b[9];
+    out[10] = a[9] * b[1] + a[10] * b[4] + a[11] * b[7] + b[10];
+    out[11] = a[9] * b[2] + a[10] * b[5] + a[11] * b[8] + b[11];
+}
+
+void SrpMatrixMultiply43d(double *SRP_RESTRICT out, const MATRIX43D a, 
+                          const MATRIX43D b)
+{
+    /* The linear transformation portion is the same as 3X3 Matrix. */
+    out[0] = a[0] * b[0] + a[1] * b[3] + a[2] * b[6];
+    out[1] = a[0] * b[1] + a[1] * b[4] + a[2] * b[7];
+    out[2] = a[0] * b[2] + a[1] * b[5] + a[2] * b[8];
+
+    out[3] = a[3] * b[0] + a[4] * b[3] + a[5] * b[6];
+    out[4] = a[3] * b[1] + a[4] * b[4] + a[5] * b[7];
+    out[5] = a[3] * b[2] + a[4] * b[5] + a[5] * b[8];
+
+    out[6] = a[6] * b[0] + a[7] * b[3] + a[8] * b[6];
+    out[7] = a[6] * b[1] + a[7] * b[4] + a[8] * b[7];
+    out[8] = a[6] * b[2] + a[7] * b[5] + a[8] * b[8];
+
+    /* Now the translation portion. */
+    out[9]  = a[9] * b[0] + a[10] * b[3] + a[11] * b[6] + b[9];
+    out[10] = a[9] * b[1] + a[10] * b[4] + a[11] * b[7] + b[10];
+    out[11] = a[9] * b[2] + a[10] * b[5] + a[11] * b[8] + b[11];
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpMatrixTransformVector3f(float *SRP_RESTRICT out, const VECTOR3F v, 
+ *                                 const MATRIX43F m)
+ * void SrpMatrixTransformVector3d(double *SRP_RESTRICT out, const VECTOR3D v, 
+ *                                 const MATRIX43D m)
+ * void SrpMatrixTransformVector4f(float *SRP_RESTRICT out, const VECTOR4F v, 
+ *                                 const MATRIX43F m)
+ * void SrpMatrixTransformVector4d(double *SRP_RESTRICT out, const VECTOR4D v, 
+ *                                 const MATRIX43D m)
+ *
+ * These functions transform vector with 4X3 matrix m,
+ * and store the result in vector out.
+ */
+void SrpMatrixTransformVector3f(float *SRP_RESTRICT out, const VECTOR3F v, 
+                                const MATRIX43F m)
+{
+    out[0] = v[0] * m[0] + v[1] * m[3] + v[2] * m[6] + m[9];
+    out[1] = v[0] * m[1] + v[1] * m[4] + v[2] * m[7] + m[10];
+    out[2] = v[0] * m[2] + v[1] * m[5] + v[2] * m[8] + m[11];
+}
+
+void SrpMatrixTransformVector3d(double *SRP_RESTRICT out, const VECTOR3D v, 
+                                const MATRIX43D m)
+{
+    out[0] = v[0] * m[0] + v[1] * m[3] + v[2] * m[6] + m[9];
+    out[1] = v[0] * m[1] + v[1] * m[4] + v[2] * m[7] + m[10];
+    out[2] = v[0] * m[2] + v[1] * m[5] + v[2] * m[8] + m[11];
+}
+
+void SrpMatrixTransformVector4f(float *SRP_RESTRICT out, const VECTOR4F v, 
+                                const MATRIX43F m)
+{
+    out[0] = v[0] * m[0] + v[1] * m[3] + v[2] * m[6] + v[3] * m[9];
+    out[1] = v[0] * m[1] + v[1] * m[4] + v[2] * m[7] + v[3] * m[10];
+    out[2] = v[0] * m[2] + v[1] * m[5] + v[2] * m[8] + v[3] * m[11];
+    out[3] = v[3];
+}
+
+void SrpMatrixTransformVector4d(double *SRP_RESTRICT out, const VECTOR4D v, 
+                                const MATRIX43D m)
+{
+    out[0] = v[0] * m[0] + v[1] * m[3] + v[2] * m[6] + v[3] * m[9];
+    out[1] = v[0] * m[1] + v[1] * m[4] + v[2] * m[7] + v[3] * m[10];
+    out[2] = v[0] * m[2] + v[1] * m[5] + v[2] * m[8] + v[3] * m[11];
+    out[3] = v[3];
+}
+
+#endif /* _MATRIXINLINE_SRP_H */
@@ -28,6 +28,11 @@ typedef struct MODEL_T MODEL;
 struct OBJECT_T;
 typedef struct OBJECT_T OBJECT;
 
+/*
+ * Where an object is in an octree, see octree_srp.h
+ */
+struct OCTREE_ENTRY_T;
+
 /*----------------------------------------------------------------------------*/
 /*                           Function Declarations                            */
 /*----------------------------------------------------------------------------*/
@@ -41,7 +46,31 @@ extern int SrpCreateObject(OBJECT **ppObj, MODEL *pModel,
                            float scaleX, float scaleY, float scaleZ);
 
 /*
- * Delete object.
+ * Initialize object in memory provided by the caller.
+ */
+extern void SrpInitObject(OBJECT *pObj, MODEL *pModel, 
+                          float positionX, float positionY, float positionZ, 
+                          float directionX, float directionY, float directionZ,
+                          float scaleX, float scaleY, float scaleZ);
+
+/*
+ * Get the size of an object in bytes.
+ */
+extern int SrpGetObjectSize(void);
+
+/*
+ * Make an object use another model.
+ */
+extern void SrpSetObjectModel(OBJECT *pObj, MODEL *pModel);
+
+/*
+ * Set or get where an object is in an octree, for the octree only.
+ */
+extern void SrpSetObjectEntry(OBJECT *pObj, struct OCTREE_ENTRY_T *pEntry);
+extern struct OCTREE_ENTRY_T *SrpGetObjectEntry(const OBJECT *pObj);
+
+/*
+ * Delete object, removing it from the octree it's in.
  */
 extern void SrpDeleteObject(OBJECT *pObj);
 
@@ -57,12 +86,24 @@ extern void SrpTranslateObject(OBJECT *pObj, float x, float y, float z);
  */
 extern void SrpRotateObject(OBJECT *pObj, float x, float y, float z);
 
+/* 
+ * Turn Object incrementally, by angle degrees about axis in its 
+ * local space. The next SrpRotateObject overrides the turns.
+ */
+extern void SrpTurnObject(OBJECT *pObj, const VECTOR3F axis, float angle);
+
 /* 
  * Scale Object.
  * x, y and z are scale on Cardinal X, Y and Z respectively.
  */
 extern void SrpScaleObject(OBJECT *pObj, float x, float y, float z);
 
+/*
+ * Get the bounding sphere of an object in its parent space.
+ */
+extern void SrpGetObjectBounds(const OBJECT *pObj, VECTOR3F center, 
+                               float *pRadius);
+
 /* 
  * Draw Object.
  */
@@ -78,6 +119,13 @@ extern void SrpPrintObject(const OBJECT *pObj);
  */
 extern int SrpModelLoadPLG(MODEL **ppModel, const char *fileName);
 
+/*
+ * Create an axis aligned box model, e.g. as a stand-in while the real 
+ * model is being loaded.
+ */
+extern int SrpModelCreateBox(MODEL **ppModel, const VECTOR3F minCorner, 
+                             const VECTOR3F maxCorner);
+
 /* 
  * Release model.
  */
@@ -88,4 +136,14 @@ extern void SrpModelRelease(MODEL *pModel);
  */
 float SrpModelGetRadius(const MODEL *pModel);
 
+/*
+ * Replace the generated levels of detail of a model with a hand made chain.
+ */
+extern void SrpModelAttachLod(MODEL *pModel, MODEL *pLod);
+
+/*
+ * Get the number of levels of detail of a model, itself included.
+ */
+extern int SrpModelGetNumLods(const MODEL *pModel);
+
 #endif /* _MODEL_SRP_H */
@@ -0,0 +1,77 @@
+/*******************************************************************************
+ * File   : octree_srp.h
+ * Content: Loose octree of objects
+ *
+ * Coder  : Ean Jee
+ * Time   : 2026-10-19 15:10
+ ******************************************************************************/
+
+#ifndef _OCTREE_SRP_H
+#define _OCTREE_SRP_H
+
+#include "vector_srp.h"
+#include "model_srp.h"
+#include "renderee_srp.h"
+
+/*----------------------------------------------------------------------------*/
+/*                         Macros and Type Definitions                        */
+/*----------------------------------------------------------------------------*/
+
+/*
+ * A loose octree indexing objects in world space by their bounding 
+ * spheres, so culling skips whole regions out of sight at once.
+ */
+struct OCTREE_T;
+typedef struct OCTREE_T OCTREE;
+
+/*
+ * Where an object is in an octree, kept by the object
+ */
+struct OCTREE_ENTRY_T;
+typedef struct OCTREE_ENTRY_T OCTREE_ENTRY;
+
+/*----------------------------------------------------------------------------*/
+/*                           Function Declarations                            */
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Create octree over the cube of halfSize around center, subdivided 
+ * maxDepth levels at most. Objects outside the cube are still accepted.
+ */
+extern int SrpCreateOctree(OCTREE **ppTree, const VECTOR3F center, 
+                           float halfSize, int maxDepth);
+
+/*
+ * Delete octree. Objects are removed from it, not deleted.
+ */
+extern void SrpDeleteOctree(OCTREE *pTree);
+
+/*
+ * Insert object into octree. An object is in one octree at most.
+ */
+extern int SrpOctreeInsertObject(OCTREE *pTree, OBJECT *pObj);
+
+/*
+ * Remove object from the octree it's in.
+ */
+extern void SrpOctreeRemoveObject(OBJECT *pObj);
+
+/*
+ * Move object to where its bounds are now in the octree it's in. 
+ * Translating, scaling or changing model of an object calls it.
+ */
+extern void SrpOctreeUpdateObject(OBJECT *pObj);
+
+/*
+ * Get the number of objects in octree.
+ */
+extern int SrpOctreeGetNumObjects(const OCTREE *pTree);
+
+/*
+ * Draw objects of octree which are visible with current frustum into 
+ * render list, with current modelview matrix as the world to camera 
+ * transformation.
+ */
+extern void SrpOctreeDrawObjects(OCTREE *pTree, RENDER_LIST *pRl);
+
+#endif /* _OCTREE_SRP_H */
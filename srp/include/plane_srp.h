@@ -39,4 +39,10 @@ extern void SrpPlaneGetEquation(PLANE plane, const VECTOR3F p1,
  */
 extern float SrpPlaneGetDistance(const PLANE plane, const VECTOR3F p);
 
+/* 
+ * Get the distances from an array of points to the plane.
+ */
+extern void SrpPlaneDistanceArray(const PLANE plane, const VECTOR3F *p, 
+                                  int count, float *pDist);
+
 #endif /* _PLANE_SRP_H */
@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * File   : pool_srp.h
+ * Content: Object pool
+ *
+ * Coder  : Ean Jee
+ * Time   : 2026-10-19 15:05
+ ******************************************************************************/
+
+#ifndef _POOL_SRP_H
+#define _POOL_SRP_H
+
+#include "model_srp.h"
+#include "renderee_srp.h"
+
+/*----------------------------------------------------------------------------*/
+/*                         Macros and Type Definitions                        */
+/*----------------------------------------------------------------------------*/
+
+/*
+ * A fixed number of objects allocated at once, with the fields culling
+ * needs kept apart in contiguous arrays.
+ */
+struct OBJECT_POOL_T;
+typedef struct OBJECT_POOL_T OBJECT_POOL;
+
+/*
+ * Stable handle of an object in a pool, 0 is never a valid one.
+ * A handle goes stale when its object is deleted, even if the slot 
+ * is reused afterwards.
+ */
+typedef int OBJECT_HANDLE;
+
+#define OBJECT_HANDLE_NULL 0
+
+/*----------------------------------------------------------------------------*/
+/*                           Function Declarations                            */
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Create object pool holding up to capacity objects.
+ */
+extern int SrpCreateObjectPool(OBJECT_POOL **ppPool, int capacity);
+
+/*
+ * Delete object pool, with all the objects in it.
+ */
+extern void SrpDeleteObjectPool(OBJECT_POOL *pPool);
+
+/*
+ * Create object in a pool, see SrpCreateObject.
+ */
+extern int SrpPoolCreateObject(OBJECT_POOL *pPool, OBJECT_HANDLE *pHandle, 
+                               MODEL *pModel, 
+                               float positionX, float positionY, 
+                               float positionZ, 
+                               float directionX, float directionY, 
+                               float directionZ,
+                               float scaleX, float scaleY, float scaleZ);
+
+/*
+ * Delete object from a pool.
+ */
+extern void SrpPoolDeleteObject(OBJECT_POOL *pPool, OBJECT_HANDLE handle);
+
+/*
+ * Get object by handle, NULL if the handle is stale.
+ * The address stays the same until the object is deleted.
+ */
+extern OBJECT* SrpPoolGetObject(const OBJECT_POOL *pPool, 
+                                OBJECT_HANDLE handle);
+
+/*
+ * Get the number of objects in a pool.
+ */
+extern int SrpPoolGetNumObjects(const OBJECT_POOL *pPool);
+
+/*
+ * Translate object in a pool, see SrpTranslateObject.
+ */
+extern void SrpPoolTranslateObject(OBJECT_POOL *pPool, OBJECT_HANDLE handle,
+                                   float x, float y, float z);
+
+/*
+ * Tell the pool an object has been changed otherwise, e.g. scaled.
+ */
+extern void SrpPoolUpdateObject(OBJECT_POOL *pPool, OBJECT_HANDLE handle);
+
+/*
+ * Cull every object of a pool, then draw the visible ones.
+ */
+extern void SrpPoolDrawObjects(OBJECT_POOL *pPool, RENDER_LIST *pRl);
+
+#endif /* _POOL_SRP_H */
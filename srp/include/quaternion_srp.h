@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * File   : quaternion_srp.h
+ * Content: Quaternion functions.
+ *
+ * Coder  : Ean Jee
+ * Time   : 2026-10-19 10:12
+ ******************************************************************************/
+
+#ifndef _QUATERNION_SRP_H
+#define _QUATERNION_SRP_H
+
+#include "vector_srp.h"
+#include "matrix_srp.h"
+
+/*----------------------------------------------------------------------------*/
+/*                         Macros and Type Definitions                        */
+/*----------------------------------------------------------------------------*/
+
+/* 
+ * Stored as (x, y, z, w), w being the real part.
+ */
+typedef float QUATERNION[4];
+
+/*----------------------------------------------------------------------------*/
+/*                           Function Declarations                            */
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Load identity quaternion, which doesn't rotate.
+ */
+extern void SrpQuaternionLoadIdentity(QUATERNION q);
+
+/*
+ * Copy quaternion.
+ */
+extern void SrpQuaternionCopy(QUATERNION dst, const QUATERNION src);
+
+/*
+ * Make a quaternion rotating angle t about the axis v.
+ * t is the amount of rotation in radians.
+ */
+extern void SrpQuaternionMakeRotation(QUATERNION out, const VECTOR3F v, 
+                                      float t);
+
+/*
+ * Make a quaternion from Euler angles in radians, with YXZ sequence
+ * as objects do, i.e. rotate about z first, then x, then y.
+ */
+extern void SrpQuaternionMakeEuler(QUATERNION out, float x, float y, float z);
+
+/*
+ * Quaternion multiplication. out = a * b.
+ * Rotating by out is rotating by b first, then by a.
+ */
+extern void SrpQuaternionMultiply(QUATERNION out, const QUATERNION a, 
+                                  const QUATERNION b);
+
+/*
+ * Normalize quaternion.
+ */
+extern void SrpQuaternionNormalize(QUATERNION out, const QUATERNION q);
+
+/*
+ * Dot product.
+ */
+extern float SrpQuaternionDotProduct(const QUATERNION a, const QUATERNION b);
+
+/*
+ * Interpolate between unit quaternions a and b, along the shorter arc.
+ * Nlerp is cheaper but doesn't keep a constant angular speed as slerp does.
+ */
+extern void SrpQuaternionNlerp(QUATERNION out, const QUATERNION a, 
+                               const QUATERNION b, float t);
+extern void SrpQuaternionSlerp(QUATERNION out, const QUATERNION a, 
+                               const QUATERNION b, float t);
+
+/*
+ * Make a 'pure' rotation matrix from a unit quaternion.
+ */
+extern void SrpQuaternionToMatrix43f(MATRIX43F out, const QUATERNION q);
+
+/*
+ * Print quaternion, used for debugging.
+ */
+extern void SrpQuaternionPrint(const QUATERNION q, const char *name);
+
+#endif /* _QUATERNION_SRP_H */
@@ -23,6 +23,13 @@ typedef struct tagPOINT2I
 /*                           Function Declarations                            */
 /*----------------------------------------------------------------------------*/
 
+/*
+ * Built with SRP_FIXED_POINT defined, lines and filled polygons are 
+ * drawn with integer arithmetic only, for targets where float is slow. 
+ * Pixels then land exactly where the true edge, rounded half up, puts 
+ * them; the float path, adding up a rounded step, is often a pixel off 
+ * on some scanline. SrpRasterCheck tells them apart.
+ */
 extern void SrpDrawPixel(int x, int y);
 extern void SrpDrawLine(int x0, int y0, int x1, int y1);
 
@@ -39,4 +46,13 @@ extern void SrpDrawTriangleFill(int x0, int y0, int x1, int y1, int x2, int y2);
 extern void SrpDrawPolygonWire(const POINT2I *pBuffer, int count);
 extern void SrpDrawPolygonFill(const POINT2I *pBuffer, int count);
 
+/*
+ * Check SrpDrawPolygonFill and SrpDrawLine against an exact reference on 
+ * the current rendering context, with count random triangles and lines, 
+ * and print how many are off and how long they take. The clearing and 
+ * drawing colors are changed. Return TRUE if every pixel matches, which 
+ * only SRP_FIXED_POINT promises; the float path is expected to fail.
+ */
+extern int SrpRasterCheck(int count);
+
 #endif /* _RASTER_SRP_H */
@@ -9,20 +9,75 @@
 #ifndef _RCMANAGER_SRP_H
 #define _RCMANAGER_SRP_H
 
+#include "datadef_ig.h"
 #include "vector_srp.h"
 #include "matrix_srp.h"
+#include "frustum_srp.h"
 
 /*----------------------------------------------------------------------------*/
 /*                         Macros and Type Definitions                        */
 /*----------------------------------------------------------------------------*/
 
+/*
+ * A rendering context, its frame buffer, matrix stacks, frustum and 
+ * states. All SrpRC* functions, and everything built on them, work on 
+ * the calling thread's current RC, so N threads can render N scenes 
+ * at once, each with its own RC current.
+ */
+struct SRP_RC_T;
+typedef struct SRP_RC_T SRP_RC;
+
+/* Most buffers a swap chain has */
+#define SRP_MAX_SWAP_BUFFERS  3
+
+/* Dirty tiles are SRP_DIRTY_TILE_SIZE pixels square */
+#define SRP_DIRTY_TILE_SHIFT  5
+#define SRP_DIRTY_TILE_SIZE   (1 << SRP_DIRTY_TILE_SHIFT)
+
+/*
+ * The current RC's frame buffer, locked for writing directly. Rows are 
+ * pitch bytes apart, pixels are bit / 8 bytes of the format.
+ */
+typedef struct tagSRP_TARGET
+{
+    unsigned char *pBits;
+    int pitch;
+    int format;
+    int bit;
+    int width;
+    int height;
+} SRP_TARGET;
+
 /*----------------------------------------------------------------------------*/
 /*                           Function Declarations                            */
 /*----------------------------------------------------------------------------*/
 
+/*
+ * Create a rendering context, made current on the calling thread, 
+ * or delete it. A thread creates one this way at most.
+ */
 extern int SrpCreateRC(int width, int height, int bit);
 extern void SrpDeleteRC(void);
 
+/*
+ * Create a rendering context, not made current, or delete one. 
+ * SrpCreateRCEx picks the pixel format for the bits, SRP_FORMAT_BGRA8, 
+ * SRP_FORMAT_RGB565 or SRP_FORMAT_INDEX8.
+ */
+extern int SrpCreateRCEx(SRP_RC **ppRC, int width, int height, int bit);
+extern int SrpCreateRCFormat(SRP_RC **ppRC, int width, int height, 
+                             int format);
+extern void SrpDeleteRCEx(SRP_RC *pRC);
+
+/*
+ * Make pRC current on the calling thread, NULL for none, or get the 
+ * current one. An RC should be current on one thread at a time. Models 
+ * keep their transformed vertices, so objects of the same model should 
+ * not be drawn by two threads at a time either.
+ */
+extern void SrpRCMakeCurrent(SRP_RC *pRC);
+extern SRP_RC* SrpRCGetCurrent(void);
+
 /* 
  * RC gets and sets.
  */
@@ -30,17 +85,34 @@ extern void SrpDeleteRC(void);
 extern int SrpRCGetWidth(void);
 extern int SrpRCGetHeight(void);
 extern int SrpRCGetBit(void);
+extern int SrpRCGetFormat(void);
 extern int SrpRCGetPitch(void);
 extern int SrpRCGetSize(void);
 extern const unsigned char* SrpRCGetBuffer(void);
+extern const unsigned char* SrpRCGetFrontBuffer(void);
+extern const unsigned char* SrpRCGetPalette(void);
 extern float SrpRCGetFovy(void);
 extern float SrpRCGetAspect(void);
-extern MATRIX43F* SrpRCGetModelView(void);
+extern const MATRIX43F* SrpRCGetModelView(void);
+extern const MATRIX44F* SrpRCGetProjection(void);
 
 extern void SrpRCSetWidth(int width);
 extern void SrpRCSetHeight(int height);
 extern void SrpRCSetFrustum(float fovy, float aspect, float near, float far);
 
+/*
+ * Get matrices derived from the current matrices, cached and only 
+ * recomputed when those change through the RC: modelview x projection 
+ * into clip space (see SrpMatrixMakePerspective44f), that x viewport, 
+ * the inverse modelview, the normal matrix, and the camera position 
+ * in the space modelview transforms from.
+ */
+extern const MATRIX44F* SrpRCGetModelViewProjection(void);
+extern const MATRIX44F* SrpRCGetModelViewProjViewport(void);
+extern const MATRIX43F* SrpRCGetInverseModelView(void);
+extern const MATRIX43F* SrpRCGetNormalMatrix(void);
+extern void SrpRCGetEyePosition(VECTOR3F out);
+
 extern void SrpRCPrintMatrix(void);
 extern void SrpRCPrintStack(int depth);
 
@@ -57,12 +129,54 @@ extern void SrpRCSetDrawColor(int red, int green, int blue, int alpha);
 extern void SrpRCSetClearColor(int red, int green, int blue, int alpha);
 
 /*
- * Sets the color at (sg_pRC->buffer + offset)
+ * Set the 256 rgb colors of SRP_FORMAT_INDEX8, a 3-3-2 palette by 
+ * default. Colors set are matched to the nearest of them.
+ */
+extern void SrpRCSetPalette(const unsigned char *pPalette);
+
+/*
+ * Sets the color at (sg_pRC->buffer + offset), or of count pixels in 
+ * a row from there
  */
 extern void SrpRCSetPixel(size_t offset);
+extern void SrpRCSetSpan(size_t offset, int count);
+
+/*
+ * Set how many buffers the swap chain has, 1 by default, 2 or 3 to 
+ * double or triple buffer. SrpRCSwap makes the frame drawn the front 
+ * buffer, for SrpRCGetFrontBuffer, and goes on drawing on the next. A 
+ * front buffer stays as it is for count - 1 swaps, so a blit or encoder 
+ * still reading it isn't drawn over by the next frame. The RC belongs 
+ * to the calling thread, as with every SrpRC function; only the pointer 
+ * from SrpRCGetFrontBuffer may be handed to another. Return FALSE, with 
+ * one buffer left, if there is not enough memory.
+ */
+extern int SrpRCSetSwapBuffers(int count);
+extern void SrpRCSwap(void);
+
+/*
+ * Mark a rectangle, both ends included, as drawn on, and get what 
+ * changed from one front buffer to the next, one byte per tile, so a 
+ * presenter or encoder can send only those tiles. The rasterizer marks 
+ * what it draws. SrpRCSetPixel, SrpRCSetSpan and locked targets don't, 
+ * code writing through them marks with SrpRCMarkDirty. All tiles are 
+ * dirty after the clearing color, palette or swap chain changes.
+ */
+extern void SrpRCMarkDirty(int xMin, int yMin, int xMax, int yMax);
+extern const unsigned char* SrpRCGetDirtyTiles(int *pTilesX, int *pTilesY);
+
+/*
+ * Lock the frame buffer for writing directly, or unlock it. Lazy 
+ * clears are done first, and SrpRCClear clears at once while locked. 
+ * SrpRCSetPixel and the rasterizer can still be used in between, a 
+ * locked target is just not checked for them.
+ */
+extern int SrpRCLockTarget(SRP_TARGET *pTarget);
+extern void SrpRCUnlockTarget(void);
 
 /* 
- * Clear the buffer with current clearing color
+ * Clear the buffer with current clearing color, with SRP_LAZY_CLEAR only 
+ * tiles are marked, and cleared when drawn on or the buffer is got
  */
 extern void SrpRCClear(void);
 
@@ -99,6 +213,73 @@ extern void SrpRCLoadIdentity(void);
  */
 extern int SrpRCIsVisible(const VECTOR3F pos, float radius);
 
+/*
+ * Check if a point is inside current frustum in RC.
+ */
+extern int SrpRCIsInside(const VECTOR3F pos);
+
+/*
+ * Get the outcodes of n points with current frustum in RC, only against 
+ * the planes set in planeMask, see SrpGetFrustumOutcodeArray.
+ */
+extern void SrpRCGetOutcodeArray(const VECTOR3F *pos, int n, int planeMask, 
+                                 int *pOutcode);
+
+/*
+ * The same as SrpRCGetOutcodeArray, for the points of a stream.
+ */
+extern void SrpRCGetOutcodeStream(const VEC3_STREAM *pStream, int planeMask, 
+                                  int *pOutcode);
+
+/*
+ * Clip a triangle against current frustum in RC, only against the 
+ * planes set in planeMask, see SrpClipTriangleInFrustum.
+ */
+extern int SrpRCClipTriangle(VECTOR3F *pPoly, int planeMask);
+
+/*
+ * Check if a sphere is outside, intersecting or completely inside 
+ * current frustum in RC, see SrpClassifySphereInFrustum.
+ */
+extern int SrpRCClassifySphere(const VECTOR3F pos, float radius);
+
+/*
+ * Check a sphere against some planes of current frustum in RC, see 
+ * SrpCullSphereInFrustum.
+ */
+extern int SrpRCCullSphere(const VECTOR3F pos, float radius, 
+                           int *pPlaneMask, int *pLastPlane);
+
+/*
+ * Set or get the frustum planes objects are tested against when drawn,
+ * FRUSTUM_PLANES_ALL by default.
+ */
+extern void SrpRCSetCullPlaneMask(int planeMask);
+extern int SrpRCGetCullPlaneMask(void);
+
+/*
+ * Set how SRP_CULL_SMALL works, objects under pixels in diameter on 
+ * screen are dropped with SRP_SMALL_DROP, or drawn as a point with 
+ * SRP_SMALL_SPLAT.
+ */
+extern void SrpRCSetSmallObject(float pixels, int mode);
+extern float SrpRCGetSmallPixels(void);
+extern int SrpRCGetSmallMode(void);
+
+/*
+ * Get current frustum in world space, rebuilt only when the modelview 
+ * matrix or the frustum has changed.
+ */
+extern const FRUSTUM* SrpRCGetWorldFrustum(void);
+
+/*
+ * Check if n spheres in world space are visible with current frustum 
+ * in RC.
+ */
+extern void SrpRCCullSpheresBatch(const float *x, const float *y, 
+                                  const float *z, const float *r, int n, 
+                                  byte *pVisible);
+
 /* 
  * Enable a specific capability.
  */
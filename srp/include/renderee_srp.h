@@ -89,6 +89,15 @@ extern void SrpTransRenderListLocToCam(RENDER_LIST *pRl);
  */
 extern void SrpTransRenderListCamToProj(RENDER_LIST *pRl);
 
+/*
+ * Transfrom render list from camera space, or local space, through 
+ * homogeneous clip space to projection space, dropping and clipping 
+ * triangles on the way. Return FALSE if the list ran out of room for 
+ * the triangles added by near plane clipping.
+ */
+extern int SrpTransRenderListCamToClip(RENDER_LIST *pRl);
+extern int SrpTransRenderListLocToClip(RENDER_LIST *pRl);
+
 /*
  * Transfrom render list from projection space to screen space.
  */
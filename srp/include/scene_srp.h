@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * File   : scene_srp.h
+ * Content: Scene graph
+ *
+ * Coder  : Ean Jee
+ * Time   : 2026-10-19 13:40
+ ******************************************************************************/
+
+#ifndef _SCENE_SRP_H
+#define _SCENE_SRP_H
+
+#include "vector_srp.h"
+#include "quaternion_srp.h"
+#include "model_srp.h"
+#include "renderee_srp.h"
+
+/*----------------------------------------------------------------------------*/
+/*                         Macros and Type Definitions                        */
+/*----------------------------------------------------------------------------*/
+
+/*
+ * A node of the scene graph, with a local transformation relative to 
+ * its parent, and optionally an object placed in its space.
+ */
+struct SCENE_NODE_T;
+typedef struct SCENE_NODE_T SCENE_NODE;
+
+/*----------------------------------------------------------------------------*/
+/*                           Function Declarations                            */
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Create scene node, pObj may be NULL for a node grouping its children.
+ */
+extern int SrpCreateSceneNode(SCENE_NODE **ppNode, OBJECT *pObj);
+
+/*
+ * Delete scene node and its subtree. Objects are not deleted.
+ */
+extern void SrpDeleteSceneNode(SCENE_NODE *pNode);
+
+/*
+ * Add a child to a node, the child must not have a parent yet.
+ */
+extern void SrpSceneNodeAddChild(SCENE_NODE *pParent, SCENE_NODE *pChild);
+
+/*
+ * Detach a node with its subtree from its parent.
+ */
+extern void SrpSceneNodeDetach(SCENE_NODE *pNode);
+
+/*
+ * Set the local transformation of a node.
+ */
+extern void SrpSceneNodeSetTranslation(SCENE_NODE *pNode, 
+                                       float x, float y, float z);
+extern void SrpSceneNodeSetOrientation(SCENE_NODE *pNode, 
+                                       const QUATERNION orientation);
+extern void SrpSceneNodeSetScale(SCENE_NODE *pNode, float x, float y, float z);
+
+/*
+ * Tell the node its object has been moved, so its bounds are updated.
+ */
+extern void SrpSceneNodeInvalidate(SCENE_NODE *pNode);
+
+/*
+ * Get the bounding sphere of a node and its subtree in world space,
+ * radius is negative if there is nothing to bound.
+ */
+extern void SrpSceneNodeGetBounds(const SCENE_NODE *pNode, VECTOR3F center, 
+                                  float *pRadius);
+
+/*
+ * Update world matrices and bounds of the nodes changed since last time.
+ */
+extern void SrpSceneUpdate(SCENE_NODE *pRoot);
+
+/*
+ * Update the scene, then draw every object of it into render list, 
+ * with current modelview matrix as the world to camera transformation.
+ */
+extern void SrpSceneDraw(SCENE_NODE *pRoot, RENDER_LIST *pRl);
+
+#endif /* _SCENE_SRP_H */
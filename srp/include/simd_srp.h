@@ -0,0 +1,160 @@
+/*******************************************************************************
+ * File   : simd_srp.h
+ * Content: SIMD support, instruction sets detected at run time and 
+ *          helpers shared by the batch kernels.
+ *
+ * Coder  : Ean Jee
+ * Time   : 2026-10-19 10:12
+ ******************************************************************************/
+
+#ifndef _SIMD_SRP_H
+#define _SIMD_SRP_H
+
+/*----------------------------------------------------------------------------*/
+/*                         Macros and Type Definitions                        */
+/*----------------------------------------------------------------------------*/
+
+/* SIMD levels, each one includes those below it */
+#define SRP_SIMD_NONE             0
+#define SRP_SIMD_SSE2             1
+#define SRP_SIMD_AVX2             2 /* AVX2 and FMA */
+#define SRP_SIMD_AVX512           3 /* AVX-512F */
+
+#if defined(__x86_64__) || defined(__i386__) || \
+    defined(_M_X64) || defined(_M_IX86)
+#define SRP_SIMD_X86
+#include <immintrin.h>
+
+/* 
+ * Kernels above the compiler's baseline are built for their own 
+ * instruction set and only called when SrpSimdGetLevel() allows.
+ */
+#if defined(__GNUC__)
+#define SRP_TARGET_SSE2           __attribute__((target("sse2")))
+#define SRP_TARGET_AVX2           __attribute__((target("avx2,fma")))
+#define SRP_TARGET_AVX512         __attribute__((target("avx512f")))
+#else
+#define SRP_TARGET_SSE2
+#define SRP_TARGET_AVX2
+#define SRP_TARGET_AVX512
+#endif
+
+/*
+ * Load 4, 8 or 16 packed VECTOR3F from p into 3 registers, 4 vectors 
+ * in each 128-bit lane as x0y0z0x1, y1z1x2y2, z2x3y3z3.
+ */
+#define SRP_SIMD_LOAD3_128(p, m03, m14, m25)                                  \
+do {                                                                          \
+    m03 = _mm_loadu_ps((p));                                                  \
+    m14 = _mm_loadu_ps((p) + 4);                                              \
+    m25 = _mm_loadu_ps((p) + 8);                                              \
+} while (0)
+
+#define SRP_SIMD_LOAD3_256(p, m03, m14, m25)                                  \
+do {                                                                          \
+    m03 = _mm256_insertf128_ps(_mm256_castps128_ps256(                        \
+              _mm_loadu_ps((p))), _mm_loadu_ps((p) + 12), 1);                 \
+    m14 = _mm256_insertf128_ps(_mm256_castps128_ps256(                        \
+              _mm_loadu_ps((p) + 4)), _mm_loadu_ps((p) + 16), 1);             \
+    m25 = _mm256_insertf128_ps(_mm256_castps128_ps256(                        \
+              _mm_loadu_ps((p) + 8)), _mm_loadu_ps((p) + 20), 1);             \
+} while (0)
+
+#define SRP_SIMD_LOAD3_512(p, m03, m14, m25)                                  \
+do {                                                                          \
+    m03 = _mm512_insertf32x4(_mm512_insertf32x4(_mm512_insertf32x4(          \
+              _mm512_castps128_ps512(_mm_loadu_ps((p))),                      \
+              _mm_loadu_ps((p) + 12), 1), _mm_loadu_ps((p) + 24), 2),         \
+              _mm_loadu_ps((p) + 36), 3);                                     \
+    m14 = _mm512_insertf32x4(_mm512_insertf32x4(_mm512_insertf32x4(          \
+              _mm512_castps128_ps512(_mm_loadu_ps((p) + 4)),                  \
+              _mm_loadu_ps((p) + 16), 1), _mm_loadu_ps((p) + 28), 2),         \
+              _mm_loadu_ps((p) + 40), 3);                                     \
+    m25 = _mm512_insertf32x4(_mm512_insertf32x4(_mm512_insertf32x4(          \
+              _mm512_castps128_ps512(_mm_loadu_ps((p) + 8)),                  \
+              _mm_loadu_ps((p) + 20), 1), _mm_loadu_ps((p) + 32), 2),         \
+              _mm_loadu_ps((p) + 44), 3);                                     \
+} while (0)
+
+/*
+ * Store 3 registers laid out as above back to p.
+ */
+#define SRP_SIMD_STORE3_128(p, m03, m14, m25)                                 \
+do {                                                                          \
+    _mm_storeu_ps((p), m03);                                                  \
+    _mm_storeu_ps((p) + 4, m14);                                              \
+    _mm_storeu_ps((p) + 8, m25);                                              \
+} while (0)
+
+#define SRP_SIMD_STORE3_256(p, m03, m14, m25)                                 \
+do {                                                                          \
+    _mm_storeu_ps((p), _mm256_castps256_ps128(m03));                          \
+    _mm_storeu_ps((p) + 4, _mm256_castps256_ps128(m14));                      \
+    _mm_storeu_ps((p) + 8, _mm256_castps256_ps128(m25));                      \
+    _mm_storeu_ps((p) + 12, _mm256_extractf128_ps(m03, 1));                   \
+    _mm_storeu_ps((p) + 16, _mm256_extractf128_ps(m14, 1));                   \
+    _mm_storeu_ps((p) + 20, _mm256_extractf128_ps(m25, 1));                   \
+} while (0)
+
+#define SRP_SIMD_STORE3_512(p, m03, m14, m25)                                 \
+do {                                                                          \
+    _mm_storeu_ps((p), _mm512_castps512_ps128(m03));                          \
+    _mm_storeu_ps((p) + 4, _mm512_castps512_ps128(m14));                      \
+    _mm_storeu_ps((p) + 8, _mm512_castps512_ps128(m25));                      \
+    _mm_storeu_ps((p) + 12, _mm512_extractf32x4_ps(m03, 1));                  \
+    _mm_storeu_ps((p) + 16, _mm512_extractf32x4_ps(m14, 1));                  \
+    _mm_storeu_ps((p) + 20, _mm512_extractf32x4_ps(m25, 1));                  \
+    _mm_storeu_ps((p) + 24, _mm512_extractf32x4_ps(m03, 2));                  \
+    _mm_storeu_ps((p) + 28, _mm512_extractf32x4_ps(m14, 2));                  \
+    _mm_storeu_ps((p) + 32, _mm512_extractf32x4_ps(m25, 2));                  \
+    _mm_storeu_ps((p) + 36, _mm512_extractf32x4_ps(m03, 3));                  \
+    _mm_storeu_ps((p) + 40, _mm512_extractf32x4_ps(m14, 3));                  \
+    _mm_storeu_ps((p) + 44, _mm512_extractf32x4_ps(m25, 3));                  \
+} while (0)
+
+/*
+ * Turn the loaded registers into x, y and z of every vector, and back.
+ * SHUFFLE is _mm_shuffle_ps, _mm256_shuffle_ps or _mm512_shuffle_ps 
+ * and T the register type matching it, they work on each lane alike.
+ */
+#define SRP_SIMD_AOS_TO_SOA(SHUFFLE, T, m03, m14, m25, x, y, z)               \
+do {                                                                          \
+    T xy_, yz_;                                                               \
+    xy_ = SHUFFLE(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));                         \
+    yz_ = SHUFFLE(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));                         \
+    x = SHUFFLE(m03, xy_, _MM_SHUFFLE(2, 0, 3, 0));                           \
+    y = SHUFFLE(yz_, xy_, _MM_SHUFFLE(3, 1, 2, 0));                           \
+    z = SHUFFLE(yz_, m25, _MM_SHUFFLE(3, 0, 3, 1));                           \
+} while (0)
+
+#define SRP_SIMD_SOA_TO_AOS(SHUFFLE, T, x, y, z, m03, m14, m25)               \
+do {                                                                          \
+    T xy_, yz_, zx_;                                                          \
+    xy_ = SHUFFLE(x, y, _MM_SHUFFLE(2, 0, 2, 0));                             \
+    yz_ = SHUFFLE(y, z, _MM_SHUFFLE(3, 1, 3, 1));                             \
+    zx_ = SHUFFLE(z, x, _MM_SHUFFLE(3, 1, 2, 0));                             \
+    m03 = SHUFFLE(xy_, zx_, _MM_SHUFFLE(2, 0, 2, 0));                         \
+    m14 = SHUFFLE(yz_, xy_, _MM_SHUFFLE(3, 1, 2, 0));                         \
+    m25 = SHUFFLE(zx_, yz_, _MM_SHUFFLE(3, 1, 3, 1));                         \
+} while (0)
+
+#endif /* x86 */
+
+/*----------------------------------------------------------------------------*/
+/*                           Function Declarations                            */
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Get the highest SIMD level both the CPU and the OS support, 
+ * detected on the first call.
+ */
+extern int SrpSimdGetLevel(void);
+
+/*
+ * Limit the SIMD level used by the batch functions, e.g. 
+ * SRP_SIMD_NONE for the scalar code. It can't be raised above what 
+ * is detected.
+ */
+extern void SrpSimdSetLevel(int level);
+
+#endif /* _SIMD_SRP_H */
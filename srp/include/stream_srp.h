@@ -0,0 +1,94 @@
+/*******************************************************************************
+ * File   : stream_srp.h
+ * Content: Vector streams, arrays of 3D vectors stored as x, y and z planes
+ *
+ * Coder  : Ean Jee
+ * Time   : 2026-10-19 14:05
+ ******************************************************************************/
+
+#ifndef _STREAM_SRP_H
+#define _STREAM_SRP_H
+
+#include "vector_srp.h"
+#include "matrix_srp.h"
+#include "plane_srp.h"
+
+/*----------------------------------------------------------------------------*/
+/*                         Macros and Type Definitions                        */
+/*----------------------------------------------------------------------------*/
+
+/*
+ * A stream of 3D vectors, the SoA counterpart of an array of VECTOR3F: 
+ * vector i is (x[i], y[i], z[i]), so SIMD code loads 4, 8 or 16 of 
+ * them with no shuffling. Streams created by SrpCreateVec3Stream have 
+ * each plane aligned to 64 bytes. A view made by SrpVec3StreamView 
+ * shares a range of another stream's planes and owns nothing.
+ */
+struct VEC3_STREAM_T
+{
+    float *x;
+    float *y;
+    float *z;
+    int count;
+
+    void *pBlock;         /* Memory of the planes, NULL for a view */
+};
+
+typedef struct VEC3_STREAM_T VEC3_STREAM;
+
+/*----------------------------------------------------------------------------*/
+/*                           Function Declarations                            */
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Create a stream of count vectors, or delete it.
+ */
+extern int SrpCreateVec3Stream(VEC3_STREAM **ppStream, int count);
+extern void SrpDeleteVec3Stream(VEC3_STREAM *pStream);
+
+/*
+ * Make pView a view of count vectors of pStream from vector first on.
+ */
+extern void SrpVec3StreamView(VEC3_STREAM *pView, const VEC3_STREAM *pStream, 
+                              int first, int count);
+
+/*
+ * Load a stream from an array of vectors, or store it into one. 
+ * The array has as many vectors as the stream.
+ */
+extern void SrpVec3StreamLoad(VEC3_STREAM *pStream, const VECTOR3F *v);
+extern void SrpVec3StreamStore(VECTOR3F *v, const VEC3_STREAM *pStream);
+
+/*
+ * Stream versions of the vector functions, working on every vector 
+ * of streams with the same count. out may be any of the inputs.
+ */
+extern void SrpVec3StreamAdd(VEC3_STREAM *out, const VEC3_STREAM *u, 
+                             const VEC3_STREAM *v);
+extern void SrpVec3StreamSubtract(VEC3_STREAM *out, const VEC3_STREAM *u, 
+                                  const VEC3_STREAM *v);
+extern void SrpVec3StreamScale(VEC3_STREAM *out, const VEC3_STREAM *v, 
+                               float scale);
+extern void SrpVec3StreamDotProduct(float *out, const VEC3_STREAM *u, 
+                                    const VEC3_STREAM *v);
+extern void SrpVec3StreamCrossProduct(VEC3_STREAM *out, const VEC3_STREAM *u, 
+                                      const VEC3_STREAM *v);
+
+/*
+ * Normalize every vector, zero vectors are copied silently.
+ */
+extern void SrpVec3StreamNormalize(VEC3_STREAM *out, const VEC3_STREAM *v);
+
+/*
+ * Transform every vector with 4X3 matrix m, out[i] = v[i] * m.
+ */
+extern void SrpVec3StreamTransform(VEC3_STREAM *out, const VEC3_STREAM *v, 
+                                   const MATRIX43F m);
+
+/*
+ * Get the distance from every vector to a plane.
+ */
+extern void SrpVec3StreamPlaneDistance(float *pDist, const PLANE plane, 
+                                       const VEC3_STREAM *v);
+
+#endif /* _STREAM_SRP_H */
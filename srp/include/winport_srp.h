@@ -16,6 +16,7 @@
 
 extern int SrpInit(HWND hwnd, int width, int height, int bit);
 extern void SrpMain(void);
+extern void SrpRepaint(void);
 extern void SrpQuit(HWND hwnd);
 extern void SrpWinportSetDemoEntry(void (*init)(void), void (*main)(float), 
                                    void (*quit)(void));
@@ -7,23 +7,34 @@
  ******************************************************************************/
 
 #include <stdio.h>
+#include <memory.h>
 #include "datadef_ig.h"
 #include "assert_ig.h"
 #include "malloc_ig.h"
+#include "datadef_srp.h"
 #include "frustum_srp.h"
 #include "plane_srp.h"
 #include "math_srp.h"
 #include "vector_srp.h"
+#include "simd_srp.h"
 
 /*----------------------------------------------------------------------------*/
 /*                               Data Structure                               */
 /*----------------------------------------------------------------------------*/
 
+#define FRUSTUM_NEAR              0
+#define FRUSTUM_FAR               1
+#define FRUSTUM_TOP               2
+#define FRUSTUM_DOWN              3
+#define FRUSTUM_LEFT              4
+#define FRUSTUM_RIGHT             5
+
+/* Points SrpGetFrustumOutcodeArray measures against a plane at once */
+#define FRUSTUM_POINT_BATCH       64
+
 struct FRUSTUM_T
 {
-    PLANE near, far;
-    PLANE top, down;
-    PLANE left, right;
+    PLANE planes[FRUSTUM_NUM_PLANES];
 };
 
 /*----------------------------------------------------------------------------*/
@@ -34,10 +45,210 @@ struct FRUSTUM_T
 /*                       Private Function Declarations                        */
 /*----------------------------------------------------------------------------*/
 
+static void SrpCullSpheresScalar(const PLANE *pPlanes, const MATRIX43F m,
+                                 const float *x, const float *y, 
+                                 const float *z, const float *r, int n, 
+                                 byte *pVisible);
+#if defined(SRP_SIMD_X86)
+static int SrpCullSpheresSse2(const PLANE *planes, const MATRIX43F m,
+                              const float *x, const float *y, 
+                              const float *z, const float *r, int n, 
+                              byte *pVisible);
+static int SrpCullSpheresAvx2(const PLANE *planes, const MATRIX43F m,
+                              const float *x, const float *y, 
+                              const float *z, const float *r, int n, 
+                              byte *pVisible);
+#endif
+
 /*----------------------------------------------------------------------------*/
 /*                             Private Functions                              */
 /*----------------------------------------------------------------------------*/
 
+/*------------------------------------------------------------------------------
+ * void SrpCullSpheresScalar(const PLANE *pPlanes, const MATRIX43F m,
+ *                           const float *x, const float *y, 
+ *                           const float *z, const float *r, int n, 
+ *                           byte *pVisible)
+ *
+ * One sphere at a time, for the spheres left over by the SIMD loop.
+ */
+static void SrpCullSpheresScalar(const PLANE *pPlanes, const MATRIX43F m,
+                                 const float *x, const float *y, 
+                                 const float *z, const float *r, int n, 
+                                 byte *pVisible)
+{
+    int i, j;
+    VECTOR3F pos, posT;
+
+    for (i = 0; i < n; i++)
+    {
+        SrpVectorLoad3f(pos, x[i], y[i], z[i]);
+        if (m != NULL)
+        {
+            SrpMatrixTransformVector3f(posT, pos, m);
+        }
+        else
+        {
+            SrpVectorCopy3f(posT, pos);
+        }
+
+        pVisible[i] = TRUE;
+        for (j = 0; j < FRUSTUM_NUM_PLANES; j++)
+        {
+            if (SrpPlaneGetDistance(pPlanes[j], posT) < -r[i])
+            {
+                pVisible[i] = FALSE;
+                break;
+            }
+        }
+    }
+}
+
+#if defined(SRP_SIMD_X86)
+/*------------------------------------------------------------------------------
+ * int SrpCullSpheresSse2(const PLANE *planes, const MATRIX43F m,
+ *                        const float *x, const float *y, 
+ *                        const float *z, const float *r, int n, 
+ *                        byte *pVisible)
+ * int SrpCullSpheresAvx2(const PLANE *planes, const MATRIX43F m,
+ *                        const float *x, const float *y, 
+ *                        const float *z, const float *r, int n, 
+ *                        byte *pVisible)
+ *
+ * Transform and test 4 or 8 spheres per iteration against all six 
+ * planes without a branch. Return how many spheres are done, the rest
+ * is left to the caller.
+ */
+SRP_TARGET_SSE2
+static int SrpCullSpheresSse2(const PLANE *planes, const MATRIX43F m,
+                              const float *x, const float *y, 
+                              const float *z, const float *r, int n, 
+                              byte *pVisible)
+{
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4)
+    {
+        __m128 px, py, pz, pr, tx, ty, tz, dist, in;
+        int j, mask;
+
+        px = _mm_loadu_ps(x + i);
+        py = _mm_loadu_ps(y + i);
+        pz = _mm_loadu_ps(z + i);
+        pr = _mm_loadu_ps(r + i);
+
+        if (m != NULL)
+        {
+            tx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(m[0])), 
+                                       _mm_mul_ps(py, _mm_set1_ps(m[3]))), 
+                            _mm_add_ps(_mm_mul_ps(pz, _mm_set1_ps(m[6])), 
+                                       _mm_set1_ps(m[9])));
+            ty = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(m[1])), 
+                                       _mm_mul_ps(py, _mm_set1_ps(m[4]))), 
+                            _mm_add_ps(_mm_mul_ps(pz, _mm_set1_ps(m[7])), 
+                                       _mm_set1_ps(m[10])));
+            tz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(m[2])), 
+                                       _mm_mul_ps(py, _mm_set1_ps(m[5]))), 
+                            _mm_add_ps(_mm_mul_ps(pz, _mm_set1_ps(m[8])), 
+                                       _mm_set1_ps(m[11])));
+            px = tx;
+            py = ty;
+            pz = tz;
+        }
+
+        /* Out if on the negative side of any plane by more than r */
+        pr = _mm_sub_ps(_mm_setzero_ps(), pr);
+        in = _mm_setzero_ps();
+        for (j = 0; j < FRUSTUM_NUM_PLANES; j++)
+        {
+            dist = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(planes[j][0])), 
+                           _mm_mul_ps(py, _mm_set1_ps(planes[j][1]))), 
+                _mm_add_ps(_mm_mul_ps(pz, _mm_set1_ps(planes[j][2])), 
+                           _mm_set1_ps(planes[j][3])));
+            dist = _mm_cmpge_ps(dist, pr);
+            in = j == 0 ? dist : _mm_and_ps(in, dist);
+        }
+
+        mask = _mm_movemask_ps(in);
+        for (j = 0; j < 4; j++)
+        {
+            pVisible[i + j] = (byte)((mask >> j) & 1);
+        }
+    }
+
+    return i;
+}
+
+SRP_TARGET_AVX2
+static int SrpCullSpheresAvx2(const PLANE *planes, const MATRIX43F m,
+                              const float *x, const float *y, 
+                              const float *z, const float *r, int n, 
+                              byte *pVisible)
+{
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8)
+    {
+        __m256 px, py, pz, pr, tx, ty, tz, dist, in;
+        int j, mask;
+
+        px = _mm256_loadu_ps(x + i);
+        py = _mm256_loadu_ps(y + i);
+        pz = _mm256_loadu_ps(z + i);
+        pr = _mm256_loadu_ps(r + i);
+
+        if (m != NULL)
+        {
+            tx = _mm256_add_ps(_mm256_add_ps(
+                     _mm256_mul_ps(px, _mm256_set1_ps(m[0])), 
+                     _mm256_mul_ps(py, _mm256_set1_ps(m[3]))), 
+                 _mm256_add_ps(
+                     _mm256_mul_ps(pz, _mm256_set1_ps(m[6])), 
+                     _mm256_set1_ps(m[9])));
+            ty = _mm256_add_ps(_mm256_add_ps(
+                     _mm256_mul_ps(px, _mm256_set1_ps(m[1])), 
+                     _mm256_mul_ps(py, _mm256_set1_ps(m[4]))), 
+                 _mm256_add_ps(
+                     _mm256_mul_ps(pz, _mm256_set1_ps(m[7])), 
+                     _mm256_set1_ps(m[10])));
+            tz = _mm256_add_ps(_mm256_add_ps(
+                     _mm256_mul_ps(px, _mm256_set1_ps(m[2])), 
+                     _mm256_mul_ps(py, _mm256_set1_ps(m[5]))), 
+                 _mm256_add_ps(
+                     _mm256_mul_ps(pz, _mm256_set1_ps(m[8])), 
+                     _mm256_set1_ps(m[11])));
+            px = tx;
+            py = ty;
+            pz = tz;
+        }
+
+        /* Out if on the negative side of any plane by more than r */
+        pr = _mm256_sub_ps(_mm256_setzero_ps(), pr);
+        in = _mm256_setzero_ps();
+        for (j = 0; j < FRUSTUM_NUM_PLANES; j++)
+        {
+            dist = _mm256_add_ps(_mm256_add_ps(
+                       _mm256_mul_ps(px, _mm256_set1_ps(planes[j][0])), 
+                       _mm256_mul_ps(py, _mm256_set1_ps(planes[j][1]))), 
+                   _mm256_add_ps(
+                       _mm256_mul_ps(pz, _mm256_set1_ps(planes[j][2])), 
+                       _mm256_set1_ps(planes[j][3])));
+            dist = _mm256_cmp_ps(dist, pr, _CMP_GE_OQ);
+            in = j == 0 ? dist : _mm256_and_ps(in, dist);
+        }
+
+        mask = _mm256_movemask_ps(in);
+        for (j = 0; j < 8; j++)
+        {
+            pVisible[i + j] = (byte)((mask >> j) & 1);
+        }
+    }
+
+    return i;
+}
+#endif
+
 /*----------------------------------------------------------------------------*/
 /*                              Public Functions                              */
 /*----------------------------------------------------------------------------*/
@@ -99,7 +310,7 @@ void SrpSetFrustum(FRUSTUM *pFrustum, float fovy, float aspect,
               "SrpSetFrustum: invalid arguments.");
 
     /* Calculate the 8 vertices of the frustum */
-    tanTheta = tanf(SrpMathDegToRadf(fovy / 2.0f));
+    tanTheta = SrpMathTanf(SrpMathDegToRadf(fovy / 2.0f));
 
     halfWidthNear  = -near * tanTheta;
     halfHeightNear = halfWidthNear / aspect;
@@ -141,12 +352,58 @@ void SrpSetFrustum(FRUSTUM *pFrustum, float fovy, float aspect,
     /* Get the equation for each face of the frustum,
      * normal points inside of the frustum.
      */
-    SrpPlaneGetEquation(pFrustum->near,  nearUL, nearUR, nearLL);
-    SrpPlaneGetEquation(pFrustum->far,   farLR,  farUR,  farLL);
-    SrpPlaneGetEquation(pFrustum->top,   farUL,  farUR,  nearUL);
-    SrpPlaneGetEquation(pFrustum->down,  nearLR, farLR,  nearLL);
-    SrpPlaneGetEquation(pFrustum->left,  farUL,  nearUL, farLL);
-    SrpPlaneGetEquation(pFrustum->right, nearLR, nearUR, farLR);
+    SrpPlaneGetEquation(pFrustum->planes[FRUSTUM_NEAR],  
+                        nearUL, nearUR, nearLL);
+    SrpPlaneGetEquation(pFrustum->planes[FRUSTUM_FAR],   
+                        farLR,  farUR,  farLL);
+    SrpPlaneGetEquation(pFrustum->planes[FRUSTUM_TOP],   
+                        farUL,  farUR,  nearUL);
+    SrpPlaneGetEquation(pFrustum->planes[FRUSTUM_DOWN],  
+                        nearLR, farLR,  nearLL);
+    SrpPlaneGetEquation(pFrustum->planes[FRUSTUM_LEFT],  
+                        farUL,  nearUL, farLL);
+    SrpPlaneGetEquation(pFrustum->planes[FRUSTUM_RIGHT], 
+                        nearLR, nearUR, farLR);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpTransformFrustum(FRUSTUM *pOut, const FRUSTUM *pFrustum, 
+ *                          const MATRIX43F m)
+ *
+ * Transform a frustum into another space, m being the transformation 
+ * from that space to the frustum's, e.g. the modelview matrix for 
+ * a frustum in camera space to be put in world space. Spheres in that 
+ * space can then be tested without being transformed one by one.
+ *
+ * A point p is transformed as p * m, so the distance n.(p * m) + d to 
+ * a plane (n, d) equals (m * n).p + n.t + d, with t the translation 
+ * of m. Planes are normalized again, in case m scales.
+ */
+void SrpTransformFrustum(FRUSTUM *pOut, const FRUSTUM *pFrustum, 
+                         const MATRIX43F m)
+{
+    const float *n;
+    PLANE plane;
+    float length;
+    int i;
+
+    ASSERTMSG(pOut != NULL && pFrustum != NULL && m != NULL, 
+              "SrpTransformFrustum: invalid arguments.");
+
+    for (i = 0; i < FRUSTUM_NUM_PLANES; i++)
+    {
+        n = pFrustum->planes[i];
+
+        plane[0] = m[0] * n[0] + m[1] * n[1] + m[2] * n[2];
+        plane[1] = m[3] * n[0] + m[4] * n[1] + m[5] * n[2];
+        plane[2] = m[6] * n[0] + m[7] * n[1] + m[8] * n[2];
+        plane[3] = m[9] * n[0] + m[10] * n[1] + m[11] * n[2] + n[3];
+
+        length = SrpVectorLength3f(plane);
+        ASSERTMSG(length > 0.0f, "SrpTransformFrustum: singular matrix.");
+
+        SrpVectorScale4f(pOut->planes[i], plane, 1.0f / length);
+    }
 }
 
 /*------------------------------------------------------------------------------
@@ -163,55 +420,373 @@ void SrpSetFrustum(FRUSTUM *pFrustum, float fovy, float aspect,
 int SrpIsVisibleInFrustum(const FRUSTUM *pFrustum, const VECTOR3F pos, 
                           float radius)
 {
+    int i;
+
     ASSERTMSG(pFrustum != NULL && radius > 0.0f,
               "SrpIsVisibleInFrustum: invalid arguments.");
 
-    if (SrpPlaneGetDistance(pFrustum->near,  pos) < radius || 
-        SrpPlaneGetDistance(pFrustum->far,   pos) < radius || 
-        SrpPlaneGetDistance(pFrustum->top,   pos) < radius || 
-        SrpPlaneGetDistance(pFrustum->down,  pos) < radius || 
-        SrpPlaneGetDistance(pFrustum->left,  pos) < radius || 
-        SrpPlaneGetDistance(pFrustum->right, pos) < radius)
+    /* Normals point inside, so the sphere is out only if it's entirely
+     * on the negative side of a plane.
+     */
+    for (i = 0; i < FRUSTUM_NUM_PLANES; i++)
     {
-        return FALSE;
+        if (SrpPlaneGetDistance(pFrustum->planes[i], pos) < -radius)
+        {
+            return FALSE;
+        }
     }
 
-/*
-    if (SrpPlaneGetDistance(pFrustum->near,  pos) < radius)
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpIsInsideFrustum(const FRUSTUM *pFrustum, const VECTOR3F pos)
+ *
+ * Check if a point is inside a frustum, boundaries included.
+ */
+int SrpIsInsideFrustum(const FRUSTUM *pFrustum, const VECTOR3F pos)
+{
+    int i;
+
+    ASSERTMSG(pFrustum != NULL, "SrpIsInsideFrustum: invalid arguments.");
+
+    for (i = 0; i < FRUSTUM_NUM_PLANES; i++)
     {
-        printf("cull on near.\n");
-        return FALSE;
+        if (SrpPlaneGetDistance(pFrustum->planes[i], pos) < 0.0f)
+        {
+            return FALSE;
+        }
     }
 
-    if (SrpPlaneGetDistance(pFrustum->far,  pos) < radius)
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpGetFrustumOutcodeArray(const FRUSTUM *pFrustum, 
+ *                                const VECTOR3F *pos, int n, 
+ *                                int planeMask, int *pOutcode)
+ *
+ * Get the outcodes of n points with a frustum, a bit set for each plane 
+ * a point is outside of, boundaries being inside as in 
+ * SrpIsInsideFrustum. Planes not set in planeMask are skipped, e.g. 
+ * those the points' bounding sphere is known to be completely inside.
+ */
+void SrpGetFrustumOutcodeArray(const FRUSTUM *pFrustum, 
+                               const VECTOR3F *pos, int n, 
+                               int planeMask, int *pOutcode)
+{
+    int i, j, k, num;
+    float dist[FRUSTUM_POINT_BATCH];
+
+    ASSERTMSG(pFrustum != NULL && pos != NULL && n >= 0 && 
+              pOutcode != NULL, 
+              "SrpGetFrustumOutcodeArray: invalid arguments.");
+
+    for (i = 0; i < n; i += FRUSTUM_POINT_BATCH)
     {
-        printf("cull on far.\n");
-        return FALSE;
+        num = n - i < FRUSTUM_POINT_BATCH ? n - i : FRUSTUM_POINT_BATCH;
+        for (k = 0; k < num; k++)
+        {
+            pOutcode[i + k] = 0;
+        }
+
+        for (j = 0; j < FRUSTUM_NUM_PLANES; j++)
+        {
+            if (!(planeMask & (1 << j)))
+            {
+                continue;
+            }
+
+            SrpPlaneDistanceArray(pFrustum->planes[j], pos + i, num, dist);
+            for (k = 0; k < num; k++)
+            {
+                if (dist[k] < 0.0f)
+                {
+                    pOutcode[i + k] |= 1 << j;
+                }
+            }
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpGetFrustumOutcodeStream(const FRUSTUM *pFrustum, 
+ *                                 const VEC3_STREAM *pStream, 
+ *                                 int planeMask, int *pOutcode)
+ *
+ * Get the outcodes of the points of a stream with a frustum, the same 
+ * way SrpGetFrustumOutcodeArray does.
+ */
+void SrpGetFrustumOutcodeStream(const FRUSTUM *pFrustum, 
+                                const VEC3_STREAM *pStream, 
+                                int planeMask, int *pOutcode)
+{
+    int i, j, k;
+    float dist[FRUSTUM_POINT_BATCH];
+    VEC3_STREAM batch;
+
+    ASSERTMSG(pFrustum != NULL && pStream != NULL && pOutcode != NULL, 
+              "SrpGetFrustumOutcodeStream: invalid arguments.");
+
+    for (i = 0; i < pStream->count; i += FRUSTUM_POINT_BATCH)
+    {
+        SrpVec3StreamView(&batch, pStream, i, 
+                          pStream->count - i < FRUSTUM_POINT_BATCH ? 
+                          pStream->count - i : FRUSTUM_POINT_BATCH);
+        for (k = 0; k < batch.count; k++)
+        {
+            pOutcode[i + k] = 0;
+        }
+
+        for (j = 0; j < FRUSTUM_NUM_PLANES; j++)
+        {
+            if (!(planeMask & (1 << j)))
+            {
+                continue;
+            }
+
+            SrpVec3StreamPlaneDistance(dist, pFrustum->planes[j], &batch);
+            for (k = 0; k < batch.count; k++)
+            {
+                if (dist[k] < 0.0f)
+                {
+                    pOutcode[i + k] |= 1 << j;
+                }
+            }
+        }
     }
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpClipTriangleInFrustum(const FRUSTUM *pFrustum, VECTOR3F *pPoly, 
+ *                              int planeMask)
+ *
+ * Clip the triangle in pPoly[0..2] against the planes of a frustum set 
+ * in planeMask, one plane after another, boundaries being inside. The 
+ * polygon left replaces it in the same winding, each plane adding one 
+ * vertex at most, so pPoly needs room for FRUSTUM_MAX_CLIP_VERTICES.
+ *
+ * Return:
+ *     The number of vertices left, less than 3 if nothing is left.
+ */
+int SrpClipTriangleInFrustum(const FRUSTUM *pFrustum, VECTOR3F *pPoly, 
+                             int planeMask)
+{
+    VECTOR3F in[FRUSTUM_MAX_CLIP_VERTICES];
+    float dist[FRUSTUM_MAX_CLIP_VERTICES];
+    float t;
+    int i, j, k, p, n, num;
+
+    ASSERTMSG(pFrustum != NULL && pPoly != NULL, 
+              "SrpClipTriangleInFrustum: invalid arguments.");
 
-    if (SrpPlaneGetDistance(pFrustum->top,  pos) < radius)
+    n = 3;
+    for (p = 0; p < FRUSTUM_NUM_PLANES && n >= 3; p++)
     {
-        printf("cull on top.\n");
-        return FALSE;
+        if (!(planeMask & (1 << p)))
+        {
+            continue;
+        }
+
+        memcpy(in, pPoly, n * sizeof(VECTOR3F));
+        SrpPlaneDistanceArray(pFrustum->planes[p], in, n, dist);
+
+        num = 0;
+        for (i = 0; i < n; i++)
+        {
+            j = (i + 1) % n;
+
+            if (dist[i] >= 0.0f)
+            {
+                SrpVectorCopy3f(pPoly[num++], in[i]);
+            }
+
+            /* The edge crosses the plane */
+            if ((dist[i] >= 0.0f) != (dist[j] >= 0.0f))
+            {
+                t = dist[i] / (dist[i] - dist[j]);
+                for (k = 0; k < 3; k++)
+                {
+                    pPoly[num][k] = in[i][k] + t * (in[j][k] - in[i][k]);
+                }
+                num++;
+            }
+        }
+        n = num;
     }
 
-    if (SrpPlaneGetDistance(pFrustum->down,  pos) < radius)
+    return n;
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpClassifySphereInFrustum(const FRUSTUM *pFrustum, 
+ *                                const VECTOR3F pos, float radius)
+ *
+ * Check if a sphere is outside, intersecting or completely inside 
+ * a frustum.
+ *
+ * Return:
+ *     FRUSTUM_OUTSIDE if the sphere is completely invisible.
+ *     FRUSTUM_INTERSECT if the sphere crosses a plane at least.
+ *     FRUSTUM_INSIDE if the sphere is completely visible.
+ */
+int SrpClassifySphereInFrustum(const FRUSTUM *pFrustum, 
+                               const VECTOR3F pos, float radius)
+{
+    int planeMask, lastPlane;
+
+    planeMask = FRUSTUM_PLANES_ALL;
+    lastPlane = FRUSTUM_NEAR;
+
+    return SrpCullSphereInFrustum(pFrustum, pos, radius, 
+                                  &planeMask, &lastPlane);
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpCullSphereInFrustum(const FRUSTUM *pFrustum, const VECTOR3F pos, 
+ *                            float radius, int *pPlaneMask, 
+ *                            int *pLastPlane)
+ *
+ * Check a sphere against the planes of a frustum in *pPlaneMask only, 
+ * e.g. those its parent in a hierarchy is not completely inside.
+ *
+ * Planes the sphere is completely inside are cleared from *pPlaneMask, 
+ * to be passed on to its children. The plane culling it is kept in 
+ * *pLastPlane, and is tested first the next time, as it's most likely 
+ * to cull it again while the camera moves smoothly.
+ *
+ * Return:
+ *     FRUSTUM_OUTSIDE if the sphere is completely invisible.
+ *     FRUSTUM_INTERSECT if the sphere crosses a plane in the mask.
+ *     FRUSTUM_INSIDE if no plane is left in the mask.
+ */
+int SrpCullSphereInFrustum(const FRUSTUM *pFrustum, const VECTOR3F pos, 
+                           float radius, int *pPlaneMask, int *pLastPlane)
+{
+    float dist;
+    int i, plane, mask;
+
+    ASSERTMSG(pFrustum != NULL && radius > 0.0f && pPlaneMask != NULL && 
+              pLastPlane != NULL && *pLastPlane >= 0 && 
+              *pLastPlane < FRUSTUM_NUM_PLANES,
+              "SrpCullSphereInFrustum: invalid arguments.");
+
+    mask = *pPlaneMask;
+
+    /* Round the planes, starting from the last culling one */
+    plane = *pLastPlane;
+    for (i = 0; i < FRUSTUM_NUM_PLANES && mask != 0; i++)
     {
-        printf("cull on down.\n");
-        return FALSE;
+        if (mask & (1 << plane))
+        {
+            dist = SrpPlaneGetDistance(pFrustum->planes[plane], pos);
+            if (dist < -radius)
+            {
+                *pLastPlane = plane;
+                return FRUSTUM_OUTSIDE;
+            }
+
+            if (dist >= radius)
+            {
+                RESET_BIT(mask, 1 << plane);
+            }
+        }
+
+        if (++plane == FRUSTUM_NUM_PLANES)
+        {
+            plane = 0;
+        }
     }
 
-    if (SrpPlaneGetDistance(pFrustum->left,  pos) < radius)
+    *pPlaneMask = mask;
+
+    return mask == 0 ? FRUSTUM_INSIDE : FRUSTUM_INTERSECT;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpCullSpheresBatch(const FRUSTUM *pFrustum, const MATRIX43F m,
+ *                          const float *x, const float *y, 
+ *                          const float *z, const float *r, int n, 
+ *                          byte *pVisible)
+ *
+ * Check if n spheres, given as arrays of their centers and radii, are 
+ * visible with a frustum, the same way SrpIsVisibleInFrustum does.
+ * Centers are transformed with m first, e.g. the modelview matrix for 
+ * spheres in world space, unless m is NULL.
+ *
+ * Runs 8 spheres at a time with AVX2, 4 with SSE2, as 
+ * SrpSimdGetLevel() gives.
+ */
+void SrpCullSpheresBatch(const FRUSTUM *pFrustum, const MATRIX43F m,
+                         const float *x, const float *y, 
+                         const float *z, const float *r, int n, 
+                         byte *pVisible)
+{
+    const PLANE *planes;
+    int i;
+
+    ASSERTMSG(pFrustum != NULL && x != NULL && y != NULL && z != NULL && 
+              r != NULL && n >= 0 && pVisible != NULL,
+              "SrpCullSpheresBatch: invalid arguments.");
+
+    planes = pFrustum->planes;
+    i = 0;
+
+#if defined(SRP_SIMD_X86)
+    switch (SrpSimdGetLevel())
     {
-        printf("cull on left.\n");
-        return FALSE;
+    case SRP_SIMD_AVX512:
+    case SRP_SIMD_AVX2:
+        i = SrpCullSpheresAvx2(planes, m, x, y, z, r, n, pVisible);
+        break;
+    case SRP_SIMD_SSE2:
+        i = SrpCullSpheresSse2(planes, m, x, y, z, r, n, pVisible);
+        break;
+    default:
+        break;
     }
+#endif
 
-    if (SrpPlaneGetDistance(pFrustum->right,  pos) < radius)
+    SrpCullSpheresScalar(planes, m, x + i, y + i, z + i, r + i, n - i, 
+                         pVisible + i);
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpGetClipOutcode(const VECTOR4F clip)
+ *
+ * Get the outcode of a point in homogeneous clip space. The planes 
+ * there are -w <= x, y, z <= w, no plane equations needed.
+ */
+int SrpGetClipOutcode(const VECTOR4F clip)
+{
+    int code = 0;
+
+    ASSERTMSG(clip != NULL, "SrpGetClipOutcode: invalid arguments.");
+
+    if (clip[2] < -clip[3])
     {
-        printf("cull on right.\n");
-        return FALSE;
+        code |= 1 << FRUSTUM_NEAR;
     }
-*/
-    return TRUE;
+    if (clip[2] > clip[3])
+    {
+        code |= 1 << FRUSTUM_FAR;
+    }
+    if (clip[1] > clip[3])
+    {
+        code |= 1 << FRUSTUM_TOP;
+    }
+    if (clip[1] < -clip[3])
+    {
+        code |= 1 << FRUSTUM_DOWN;
+    }
+    if (clip[0] < -clip[3])
+    {
+        code |= 1 << FRUSTUM_LEFT;
+    }
+    if (clip[0] > clip[3])
+    {
+        code |= 1 << FRUSTUM_RIGHT;
+    }
+
+    return code;
 }
@@ -0,0 +1,346 @@
+/*******************************************************************************
+ * File   : loader_srp.c
+ * Content: Asynchronous model loading
+ *
+ * Coder  : Ean Jee
+ * Time   : 2026-10-19 11:12
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "datadef_ig.h"
+#include "assert_ig.h"
+#include "malloc_ig.h"
+#include "thread_ig.h"
+#include "model_srp.h"
+#include "loader_srp.h"
+
+/*----------------------------------------------------------------------------*/
+/*                               Data Structure                               */
+/*----------------------------------------------------------------------------*/
+
+#define LOADER_QUEUE_SIZE  64     /* Requests in flight, a power of 2 */
+#define LOADER_MAX_PATH    256
+
+/*
+ * A load request, and later its result
+ */
+struct LOAD_REQUEST_T
+{
+    int ticket;
+    char fileName[LOADER_MAX_PATH];
+
+    SRP_LOAD_CALLBACK pfCallback;
+    void *pUser;
+
+    MODEL *pModel;
+};
+
+typedef struct LOAD_REQUEST_T LOAD_REQUEST;
+
+/*
+ * A lock free ring buffer with a single producer and a single consumer.
+ * Indices run modulo twice the size, to tell full from empty.
+ */
+struct LOAD_QUEUE_T
+{
+    volatile int head;    /* Next slot to read, written by the consumer */
+    volatile int tail;    /* Next slot to write, written by the producer */
+
+    LOAD_REQUEST slots[LOADER_QUEUE_SIZE];
+};
+
+typedef struct LOAD_QUEUE_T LOAD_QUEUE;
+
+/*
+ * The main thread produces requests and consumes results, the loader 
+ * thread does the opposite.
+ */
+struct LOADER_T
+{
+    LOAD_QUEUE requests;
+    LOAD_QUEUE results;
+
+    IG_THREAD *pThread;
+    IG_SEMAPHORE *pWakeup; /* Posted once per request, and once to quit */
+    volatile int quit;
+
+    int nextTicket;
+    int numPending;        /* Requested but not handed back yet */
+};
+
+typedef struct LOADER_T LOADER;
+
+/*----------------------------------------------------------------------------*/
+/*                                Private Data                                */
+/*----------------------------------------------------------------------------*/
+
+static LOADER *sg_pLoader = NULL;
+
+/*----------------------------------------------------------------------------*/
+/*                       Private Function Declarations                        */
+/*----------------------------------------------------------------------------*/
+
+static int SrpQueuePush(LOAD_QUEUE *pQueue, const LOAD_REQUEST *pRequest);
+static int SrpQueuePop(LOAD_QUEUE *pQueue, LOAD_REQUEST *pRequest);
+static void SrpLoaderThread(void *pArg);
+static int SrpStartLoader(void);
+
+/*----------------------------------------------------------------------------*/
+/*                             Private Functions                              */
+/*----------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------
+ * int SrpQueuePush(LOAD_QUEUE *pQueue, const LOAD_REQUEST *pRequest)
+ *
+ * Append a request to a queue, on the producer side.
+ *
+ * Return:
+ *     TRUE if successful; FALSE if the queue is full.
+ */
+static int SrpQueuePush(LOAD_QUEUE *pQueue, const LOAD_REQUEST *pRequest)
+{
+    int head, tail;
+
+    tail = pQueue->tail;
+    head = IgAtomicLoad(&pQueue->head);
+    if (((tail - head) & (LOADER_QUEUE_SIZE * 2 - 1)) == LOADER_QUEUE_SIZE)
+    {
+        return FALSE;
+    }
+
+    pQueue->slots[tail & (LOADER_QUEUE_SIZE - 1)] = *pRequest;
+
+    /* Publish the slot only once it's filled */
+    IgAtomicStore(&pQueue->tail, (tail + 1) & (LOADER_QUEUE_SIZE * 2 - 1));
+
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpQueuePop(LOAD_QUEUE *pQueue, LOAD_REQUEST *pRequest)
+ *
+ * Remove the oldest request from a queue, on the consumer side.
+ *
+ * Return:
+ *     TRUE if successful; FALSE if the queue is empty.
+ */
+static int SrpQueuePop(LOAD_QUEUE *pQueue, LOAD_REQUEST *pRequest)
+{
+    int head, tail;
+
+    head = pQueue->head;
+    tail = IgAtomicLoad(&pQueue->tail);
+    if (head == tail)
+    {
+        return FALSE;
+    }
+
+    *pRequest = pQueue->slots[head & (LOADER_QUEUE_SIZE - 1)];
+
+    /* Give the slot back only once it's been read */
+    IgAtomicStore(&pQueue->head, (head + 1) & (LOADER_QUEUE_SIZE * 2 - 1));
+
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpLoaderThread(void *pArg)
+ *
+ * Entry of the loader thread, load models as requests come in.
+ */
+static void SrpLoaderThread(void *pArg)
+{
+    LOADER *pLoader = (LOADER *)pArg;
+    LOAD_REQUEST request;
+
+    while (TRUE)
+    {
+        IgWaitSemaphore(pLoader->pWakeup);
+        if (IgAtomicLoad(&pLoader->quit))
+        {
+            break;
+        }
+
+        if (!SrpQueuePop(&pLoader->requests, &request))
+        {
+            continue;
+        }
+
+        if (!SrpModelLoadPLG(&request.pModel, request.fileName))
+        {
+            request.pModel = NULL;
+        }
+
+        /* Never full, no more requests are taken than it can hold */
+        SrpQueuePush(&pLoader->results, &request);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpStartLoader(void)
+ *
+ * Create the loader and start its thread.
+ *
+ * Return:
+ *     TRUE if successful; otherwise, FALSE.
+ */
+static int SrpStartLoader(void)
+{
+    LOADER *pLoader;
+
+    if (!IgNewMemory((void **)&pLoader, sizeof(LOADER)))
+    {
+        printf("Error: create loader failed.\n");
+        return FALSE;
+    }
+
+    pLoader->requests.head = 0;
+    pLoader->requests.tail = 0;
+    pLoader->results.head = 0;
+    pLoader->results.tail = 0;
+    pLoader->quit = FALSE;
+    pLoader->nextTicket = 1;
+    pLoader->numPending = 0;
+
+    if (!IgCreateSemaphore(&pLoader->pWakeup, 0))
+    {
+        IgFreeMemory(pLoader);
+        printf("Error: create loader semaphore failed.\n");
+        return FALSE;
+    }
+
+    if (!IgCreateThread(&pLoader->pThread, SrpLoaderThread, pLoader))
+    {
+        IgDeleteSemaphore(pLoader->pWakeup);
+        IgFreeMemory(pLoader);
+        printf("Error: create loader thread failed.\n");
+        return FALSE;
+    }
+
+    sg_pLoader = pLoader;
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                              Public Functions                              */
+/*----------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------
+ * int SrpModelLoadAsync(const char *fileName, 
+ *                       SRP_LOAD_CALLBACK pfCallback, void *pUser)
+ *
+ * Load model from PLG file on the loader thread, which is started on 
+ * first use. pfCallback(ticket, pModel, pUser) is called from 
+ * SrpModelPollAsync once it's done.
+ *
+ * Return:
+ *     A ticket greater than 0 if the request is queued; otherwise, 0.
+ */
+int SrpModelLoadAsync(const char *fileName, 
+                      SRP_LOAD_CALLBACK pfCallback, void *pUser)
+{
+    LOAD_REQUEST request;
+
+    ASSERTMSG(fileName != NULL && pfCallback != NULL, 
+              "SrpModelLoadAsync: invalid arguments.");
+
+    if (strlen(fileName) >= LOADER_MAX_PATH)
+    {
+        printf("Error: file name \"%s\" is too long to load.\n", fileName);
+        return 0;
+    }
+
+    if (sg_pLoader == NULL && !SrpStartLoader())
+    {
+        return 0;
+    }
+
+    if (sg_pLoader->numPending == LOADER_QUEUE_SIZE)
+    {
+        printf("Error: too many models being loaded.\n");
+        return 0;
+    }
+
+    request.ticket = sg_pLoader->nextTicket;
+    strcpy(request.fileName, fileName);
+    request.pfCallback = pfCallback;
+    request.pUser = pUser;
+    request.pModel = NULL;
+
+    /* Can't fail, there's a free slot as long as numPending allows */
+    SrpQueuePush(&sg_pLoader->requests, &request);
+    sg_pLoader->numPending++;
+    IgPostSemaphore(sg_pLoader->pWakeup);
+
+    sg_pLoader->nextTicket++;
+    if (sg_pLoader->nextTicket <= 0)
+    {
+        sg_pLoader->nextTicket = 1;
+    }
+
+    return request.ticket;
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpModelPollAsync(void)
+ *
+ * Call back for every model loaded since last time. Should be called 
+ * once per frame, from the thread that requested the models.
+ *
+ * Return:
+ *     The number of requests handed back.
+ */
+int SrpModelPollAsync(void)
+{
+    int num;
+    LOAD_REQUEST result;
+
+    if (sg_pLoader == NULL)
+    {
+        return 0;
+    }
+
+    num = 0;
+    while (SrpQueuePop(&sg_pLoader->results, &result))
+    {
+        sg_pLoader->numPending--;
+        result.pfCallback(result.ticket, result.pModel, result.pUser);
+        num++;
+    }
+
+    return num;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpModelStopAsync(void)
+ *
+ * Stop the loader thread, after the model it's loading if any. Pending
+ * requests are dropped without calling back, models loaded but not 
+ * handed back are released.
+ */
+void SrpModelStopAsync(void)
+{
+    LOAD_REQUEST result;
+
+    if (sg_pLoader == NULL)
+    {
+        return;
+    }
+
+    IgAtomicStore(&sg_pLoader->quit, TRUE);
+    IgPostSemaphore(sg_pLoader->pWakeup);
+    IgJoinThread(sg_pLoader->pThread);
+
+    while (SrpQueuePop(&sg_pLoader->results, &result))
+    {
+        if (result.pModel != NULL)
+        {
+            SrpModelRelease(result.pModel);
+        }
+    }
+
+    IgDeleteSemaphore(sg_pLoader->pWakeup);
+    IgFreeMemory(sg_pLoader);
+    sg_pLoader = NULL;
+}
@@ -7,13 +7,33 @@
  ******************************************************************************/
 
 #include <stdio.h>
+#if defined(__SSE__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define SRP_MATH_SSE
+#endif
 #include "datadef_ig.h"
 #include "assert_ig.h"
+#include "math_srp.h"
 
 /*----------------------------------------------------------------------------*/
 /*                               Data Structure                               */
 /*----------------------------------------------------------------------------*/
 
+/* PI / 2 split for exact range reduction, and its inverse */
+#define MATH_PI_DIV_2_HI          1.5703125f
+#define MATH_PI_DIV_2_MID         4.837512969970703125E-4f
+#define MATH_PI_DIV_2_LO          7.54978995489188216E-8f
+#define MATH_2_DIV_PI             0.636619772f
+
+/* Minimax polynomials of sin and cos on [-PI / 4, PI / 4] */
+#define MATH_SIN_C3               -1.6666654611E-1f
+#define MATH_SIN_C5               8.3321608736E-3f
+#define MATH_SIN_C7               -1.9515295891E-4f
+#define MATH_COS_C4               4.166664568298827E-2f
+#define MATH_COS_C6               -1.388731625493765E-3f
+#define MATH_COS_C8               2.443315711809948E-5f
+
 /*----------------------------------------------------------------------------*/
 /*                                Private Data                                */
 /*----------------------------------------------------------------------------*/
@@ -22,14 +42,260 @@
 /*                       Private Function Declarations                        */
 /*----------------------------------------------------------------------------*/
 
+static int SrpMathReduceAngle(float x, float *pSin, float *pCos);
+
 /*----------------------------------------------------------------------------*/
 /*                             Private Functions                              */
 /*----------------------------------------------------------------------------*/
 
+/*------------------------------------------------------------------------------
+ * int SrpMathReduceAngle(float x, float *pSin, float *pCos)
+ *
+ * Write x as q * PI / 2 + r, |r| <= PI / 4, get sine and cosine of r,
+ * and return the quadrant q.
+ */
+static int SrpMathReduceAngle(float x, float *pSin, float *pCos)
+{
+    int q;
+    float r, r2;
+
+    q = (int)(x * MATH_2_DIV_PI + (x >= 0.0f ? 0.5f : -0.5f));
+    r = ((x - q * MATH_PI_DIV_2_HI) - q * MATH_PI_DIV_2_MID) - 
+        q * MATH_PI_DIV_2_LO;
+
+    r2 = r * r;
+    *pSin = r + r * r2 * (MATH_SIN_C3 + r2 * (MATH_SIN_C5 + 
+                                              r2 * MATH_SIN_C7));
+    *pCos = 1.0f - 0.5f * r2 + r2 * r2 * (MATH_COS_C4 + 
+                                           r2 * (MATH_COS_C6 + 
+                                                 r2 * MATH_COS_C8));
+
+    return q;
+}
+
 /*----------------------------------------------------------------------------*/
 /*                              Public Functions                              */
 /*----------------------------------------------------------------------------*/
 
+/*------------------------------------------------------------------------------
+ * float SrpMathFastRsqrtf(float x)
+ *
+ * Approximate 1 / sqrt(x) with rsqrtss, or the bit trick without SSE, 
+ * refined by Newton-Raphson.
+ */
+float SrpMathFastRsqrtf(float x)
+{
+    float y;
+
+    ASSERTMSG(x > 0.0f, "SrpMathFastRsqrtf: invalid arguments.");
+
+#if defined(SRP_MATH_SSE)
+    y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+#else
+    {
+        union { float f; unsigned int i; } bits;
+
+        bits.f = x;
+        bits.i = 0x5F375A86 - (bits.i >> 1);
+        y = bits.f;
+        y = y * (1.5f - 0.5f * x * y * y);
+    }
+#endif
+
+    return y * (1.5f - 0.5f * x * y * y);
+}
+
+/*------------------------------------------------------------------------------
+ * float SrpMathFastRcpf(float x)
+ *
+ * Approximate 1 / x with rcpss refined by Newton-Raphson, or a plain 
+ * division without SSE.
+ */
+float SrpMathFastRcpf(float x)
+{
+#if defined(SRP_MATH_SSE)
+    float y;
+
+    ASSERTMSG(x != 0.0f, "SrpMathFastRcpf: invalid arguments.");
+
+    y = _mm_cvtss_f32(_mm_rcp_ss(_mm_set_ss(x)));
+
+    return y * (2.0f - x * y);
+#else
+    ASSERTMSG(x != 0.0f, "SrpMathFastRcpf: invalid arguments.");
+
+    return 1.0f / x;
+#endif
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpMathFastSinCosf(float x, float *pSin, float *pCos)
+ *
+ * Approximate sine and cosine of x together, they share the range 
+ * reduction.
+ */
+void SrpMathFastSinCosf(float x, float *pSin, float *pCos)
+{
+    float s, c;
+
+    ASSERTMSG(pSin != NULL && pCos != NULL, 
+              "SrpMathFastSinCosf: invalid arguments.");
+
+    if (fabsf(x) > SRP_FAST_TRIG_RANGE)
+    {
+        *pSin = sinf(x);
+        *pCos = cosf(x);
+        return;
+    }
+
+    switch (SrpMathReduceAngle(x, &s, &c) & 3)
+    {
+    case 0:
+        *pSin = s;
+        *pCos = c;
+        break;
+    case 1:
+        *pSin = c;
+        *pCos = -s;
+        break;
+    case 2:
+        *pSin = -s;
+        *pCos = -c;
+        break;
+    default:
+        *pSin = -c;
+        *pCos = s;
+        break;
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * float SrpMathFastSinf(float x)
+ * float SrpMathFastCosf(float x)
+ * float SrpMathFastTanf(float x)
+ *
+ * Approximate sine, cosine and tangent of x in radians.
+ */
+float SrpMathFastSinf(float x)
+{
+    float s, c;
+
+    SrpMathFastSinCosf(x, &s, &c);
+
+    return s;
+}
+
+float SrpMathFastCosf(float x)
+{
+    float s, c;
+
+    SrpMathFastSinCosf(x, &s, &c);
+
+    return c;
+}
+
+float SrpMathFastTanf(float x)
+{
+    float s, c;
+
+    SrpMathFastSinCosf(x, &s, &c);
+
+    return s / c;
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpMathCheckFast(int step)
+ *
+ * Sweep the floats with a step in their bits, so every binade gets 
+ * checked alike. Rsqrt and rcp cover the normal floats whose results are 
+ * normal too, sine, cosine and tangent both signs up to 
+ * SRP_FAST_TRIG_RANGE.
+ */
+int SrpMathCheckFast(int step)
+{
+    union { float f; unsigned int i; } bits;
+    unsigned int i, first, last;
+    float x, s, c;
+    double rsqrtError, rcpError, sinCosError, tanError, e, t;
+    double rsqrtBound;
+    int sign, ret;
+
+    ASSERTMSG(step > 0, "SrpMathCheckFast: invalid arguments.");
+
+#if defined(SRP_MATH_SSE)
+    rsqrtBound = SRP_FAST_RSQRT_ERROR;
+#else
+    rsqrtBound = SRP_FAST_RSQRT_ERROR_NO_SSE;
+#endif
+
+    rsqrtError = rcpError = sinCosError = tanError = 0.0;
+
+    bits.f = 1.175494351E-38f; /* 2^-126 */
+    first = bits.i;
+    bits.f = 8.507059173E+37f; /* 2^126 */
+    last = bits.i;
+    for (i = first; i < last; i += step)
+    {
+        bits.i = i;
+        x = bits.f;
+
+        e = fabs(SrpMathFastRsqrtf(x) * sqrt((double)x) - 1.0);
+        rsqrtError = e > rsqrtError ? e : rsqrtError;
+        e = fabs(SrpMathFastRcpf(x) * (double)x - 1.0);
+        rcpError = e > rcpError ? e : rcpError;
+    }
+
+    bits.f = SRP_FAST_TRIG_RANGE;
+    last = bits.i;
+    for (i = 0; i <= last; i += step)
+    {
+        for (sign = -1; sign <= 1; sign += 2)
+        {
+            bits.i = i;
+            x = sign * bits.f;
+
+            SrpMathFastSinCosf(x, &s, &c);
+            e = fabs(s - sin((double)x));
+            sinCosError = e > sinCosError ? e : sinCosError;
+            e = fabs(c - cos((double)x));
+            sinCosError = e > sinCosError ? e : sinCosError;
+
+            if (fabs(x) < 1.4 || 
+                (fabs(sin((double)x)) >= 0.1 && fabs(cos((double)x)) >= 0.1))
+            {
+                t = tan((double)x);
+                e = t == 0.0 ? fabs(SrpMathFastTanf(x)) : 
+                               fabs(SrpMathFastTanf(x) / t - 1.0);
+                tanError = e > tanError ? e : tanError;
+            }
+        }
+    }
+
+    ret = TRUE;
+    if (rsqrtError > rsqrtBound)
+    {
+        printf("Error: SrpMathFastRsqrtf is off by %.3E.\n", rsqrtError);
+        ret = FALSE;
+    }
+    if (rcpError > SRP_FAST_RCP_ERROR)
+    {
+        printf("Error: SrpMathFastRcpf is off by %.3E.\n", rcpError);
+        ret = FALSE;
+    }
+    if (sinCosError > SRP_FAST_SINCOS_ERROR)
+    {
+        printf("Error: SrpMathFastSinCosf is off by %.3E.\n", sinCosError);
+        ret = FALSE;
+    }
+    if (tanError > SRP_FAST_TAN_ERROR)
+    {
+        printf("Error: SrpMathFastTanf is off by %.3E.\n", tanError);
+        ret = FALSE;
+    }
+
+    return ret;
+}
+
 /*------------------------------------------------------------------------------
  * int SrpMathMaxi(int a, int b)
  * float SrpMathMaxf(float a, float b)
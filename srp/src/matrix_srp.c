@@ -6,6 +6,9 @@
  * Time   : 2011-04-20 16:27
  ******************************************************************************/
 
+/* The out-of-line versions are always built here */
+#undef SRP_INLINE_MATH
+
 #include <stdio.h>
 #include <memory.h>
 #include <math.h>
@@ -13,6 +16,8 @@
 #include "assert_ig.h"
 #include "math_srp.h"
 #include "matrix_srp.h"
+#include "matrixinline_srp.h"
+#include "simd_srp.h"
 
 /*----------------------------------------------------------------------------*/
 /*                               Data Structure                               */
@@ -26,113 +31,173 @@
 /*                       Private Function Declarations                        */
 /*----------------------------------------------------------------------------*/
 
-/*----------------------------------------------------------------------------*/
-/*                             Private Functions                              */
-/*----------------------------------------------------------------------------*/
+#if defined(SRP_SIMD_X86)
+static int SrpTransformVectorsSse2(float *out, const float *in, int count, 
+                                   const MATRIX43F m);
+static int SrpTransformVectorsAvx2(float *out, const float *in, int count, 
+                                   const MATRIX43F m);
+static int SrpTransformVectorsAvx512(float *out, const float *in, int count,
+                                     const MATRIX43F m);
+static int SrpTransformVectors44Sse2(float *out, const float *in, int count, 
+                                     const MATRIX44F m);
+#endif
 
 /*----------------------------------------------------------------------------*/
-/*                              Public Functions                              */
+/*                             Private Functions                              */
 /*----------------------------------------------------------------------------*/
 
+#if defined(SRP_SIMD_X86)
 /*------------------------------------------------------------------------------
- * void SrpMatrixLoadIdentity43f(MATRIX43F m)
- * void SrpMatrixLoadIdentity43d(MATRIX43D m)
+ * int SrpTransformVectorsSse2(float *out, const float *in, int count, 
+ *                             const MATRIX43F m)
+ * int SrpTransformVectorsAvx2(float *out, const float *in, int count, 
+ *                             const MATRIX43F m)
+ * int SrpTransformVectorsAvx512(float *out, const float *in, int count,
+ *                               const MATRIX43F m)
  *
- * These functions load identity matrix into the argument. 
+ * Transform 4, 8 or 16 vectors per iteration, see 
+ * SrpMatrixTransformVectors3f. Return how many vectors are done, 
+ * the rest is left to the caller.
  */
-void SrpMatrixLoadIdentity43f(MATRIX43F m)
+SRP_TARGET_SSE2
+static int SrpTransformVectorsSse2(float *out, const float *in, int count, 
+                                   const MATRIX43F m)
 {
-    static MATRIX43F s_identity = {
-        1.0f, 0.0f, 0.0f,
-        0.0f, 1.0f, 0.0f,
-        0.0f, 0.0f, 1.0f,
-        0.0f, 0.0f, 0.0f
-    };
-
-    memcpy(m, s_identity, sizeof(MATRIX43F));
-}
+    int i, j;
+    __m128 r[12], m03, m14, m25, x, y, z, tx, ty, tz;
 
-void SrpMatrixLoadIdentity43d(MATRIX43D m)
-{
-    static MATRIX43D s_identity = {
-        1.0, 0.0, 0.0,
-        0.0, 1.0, 0.0,
-        0.0, 0.0, 1.0,
-        0.0, 0.0, 0.0
-    };
-
-    memcpy(m, s_identity, sizeof(MATRIX43D));
+    for (j = 0; j < 12; j++)
+    {
+        r[j] = _mm_set1_ps(m[j]);
+    }
+
+    for (i = 0; i + 4 <= count; i += 4)
+    {
+        SRP_SIMD_LOAD3_128(in + i * 3, m03, m14, m25);
+        SRP_SIMD_AOS_TO_SOA(_mm_shuffle_ps, __m128, m03, m14, m25, x, y, z);
+
+        tx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, r[0]), 
+                                              _mm_mul_ps(y, r[3])), 
+                                   _mm_mul_ps(z, r[6])), r[9]);
+        ty = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, r[1]), 
+                                              _mm_mul_ps(y, r[4])), 
+                                   _mm_mul_ps(z, r[7])), r[10]);
+        tz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, r[2]), 
+                                              _mm_mul_ps(y, r[5])), 
+                                   _mm_mul_ps(z, r[8])), r[11]);
+
+        SRP_SIMD_SOA_TO_AOS(_mm_shuffle_ps, __m128, tx, ty, tz, m03, m14, m25);
+        SRP_SIMD_STORE3_128(out + i * 3, m03, m14, m25);
+    }
+
+    return i;
 }
 
-/*------------------------------------------------------------------------------
- * void SrpMatrixCopy43f(MATRIX43F dst, const MATRIX43F src)
- * void SrpMatrixCopy43d(MATRIX43D dst, const MATRIX43D src)
- *
- * These functions copy matrix src into dst.
- */
-void SrpMatrixCopy43f(MATRIX43F dst, const MATRIX43F src)
+SRP_TARGET_AVX2
+static int SrpTransformVectorsAvx2(float *out, const float *in, int count, 
+                                   const MATRIX43F m)
 {
-    memcpy(dst, src, sizeof(MATRIX43F));
+    int i, j;
+    __m256 r[12], m03, m14, m25, x, y, z, tx, ty, tz;
+
+    for (j = 0; j < 12; j++)
+    {
+        r[j] = _mm256_set1_ps(m[j]);
+    }
+
+    for (i = 0; i + 8 <= count; i += 8)
+    {
+        SRP_SIMD_LOAD3_256(in + i * 3, m03, m14, m25);
+        SRP_SIMD_AOS_TO_SOA(_mm256_shuffle_ps, __m256, m03, m14, m25, 
+                            x, y, z);
+
+        tx = _mm256_add_ps(_mm256_fmadd_ps(z, r[6], _mm256_fmadd_ps(y, r[3], 
+                               _mm256_mul_ps(x, r[0]))), r[9]);
+        ty = _mm256_add_ps(_mm256_fmadd_ps(z, r[7], _mm256_fmadd_ps(y, r[4], 
+                               _mm256_mul_ps(x, r[1]))), r[10]);
+        tz = _mm256_add_ps(_mm256_fmadd_ps(z, r[8], _mm256_fmadd_ps(y, r[5], 
+                               _mm256_mul_ps(x, r[2]))), r[11]);
+
+        SRP_SIMD_SOA_TO_AOS(_mm256_shuffle_ps, __m256, tx, ty, tz, 
+                            m03, m14, m25);
+        SRP_SIMD_STORE3_256(out + i * 3, m03, m14, m25);
+    }
+
+    return i;
 }
 
-void SrpMatrixCopy43d(MATRIX43D dst, const MATRIX43D src)
+SRP_TARGET_AVX512
+static int SrpTransformVectorsAvx512(float *out, const float *in, int count,
+                                     const MATRIX43F m)
 {
-    memcpy(dst, src, sizeof(MATRIX43D));
+    int i, j;
+    __m512 r[12], m03, m14, m25, x, y, z, tx, ty, tz;
+
+    for (j = 0; j < 12; j++)
+    {
+        r[j] = _mm512_set1_ps(m[j]);
+    }
+
+    for (i = 0; i + 16 <= count; i += 16)
+    {
+        SRP_SIMD_LOAD3_512(in + i * 3, m03, m14, m25);
+        SRP_SIMD_AOS_TO_SOA(_mm512_shuffle_ps, __m512, m03, m14, m25, 
+                            x, y, z);
+
+        tx = _mm512_add_ps(_mm512_fmadd_ps(z, r[6], _mm512_fmadd_ps(y, r[3], 
+                               _mm512_mul_ps(x, r[0]))), r[9]);
+        ty = _mm512_add_ps(_mm512_fmadd_ps(z, r[7], _mm512_fmadd_ps(y, r[4], 
+                               _mm512_mul_ps(x, r[1]))), r[10]);
+        tz = _mm512_add_ps(_mm512_fmadd_ps(z, r[8], _mm512_fmadd_ps(y, r[5], 
+                               _mm512_mul_ps(x, r[2]))), r[11]);
+
+        SRP_SIMD_SOA_TO_AOS(_mm512_shuffle_ps, __m512, tx, ty, tz, 
+                            m03, m14, m25);
+        SRP_SIMD_STORE3_512(out + i * 3, m03, m14, m25);
+    }
+
+    return i;
 }
 
 /*------------------------------------------------------------------------------
- * void SrpMatrixMultiply43f(MATRIX43F out, const MATRIX43F a,const MATRIX43F b)
- * void SrpMatrixMultiply43d(MATRIX43D out, const MATRIX43D a,const MATRIX43D b)
- *
- * These functions do 4X3 matrix multiplication. out = a * b.
- * Each of those 4X3 matrices has a invisible 4th column [0, 0, 0, 1]T.
+ * int SrpTransformVectors44Sse2(float *out, const float *in, int count, 
+ *                               const MATRIX44F m)
  *
- * | 0  1  2 '0' |     | 0  1  2 '0' |
- * | 3  4  5 '0' |  X  | 3  4  5 '0' |
- * | 6  7  8 '0' |     | 6  7  8 '0' |
- * | 9 10 11 '1' |     | 9 10 11 '1' |
+ * Transform one point per iteration, a row of m being a register, 
+ * see SrpMatrixTransformVectors44f. Wider levels gain nothing here 
+ * and use it as well. Return how many points are done.
  */
-void SrpMatrixMultiply43f(MATRIX43F out, const MATRIX43F a, const MATRIX43F b)
+SRP_TARGET_SSE2
+static int SrpTransformVectors44Sse2(float *out, const float *in, int count, 
+                                     const MATRIX44F m)
 {
-    /* The linear transformation portion is the same as 3X3 Matrix. */
-    out[0] = a[0] * b[0] + a[1] * b[3] + a[2] * b[6];
-    out[1] = a[0] * b[1] + a[1] * b[4] + a[2] * b[7];
-    out[2] = a[0] * b[2] + a[1] * b[5] + a[2] * b[8];
-
-    out[3] = a[3] * b[0] + a[4] * b[3] + a[5] * b[6];
-    out[4] = a[3] * b[1] + a[4] * b[4] + a[5] * b[7];
-    out[5] = a[3] * b[2] + a[4] * b[5] + a[5] * b[8];
-
-    out[6] = a[6] * b[0] + a[7] * b[3] + a[8] * b[6];
-    out[7] = a[6] * b[1] + a[7] * b[4] + a[8] * b[7];
-    out[8] = a[6] * b[2] + a[7] * b[5] + a[8] * b[8];
-
-    /* Now the translation portion. */
-    out[9]  = a[9] * b[0] + a[10] * b[3] + a[11] * b[6] + b[9];
-    out[10] = a[9] * b[1] + a[10] * b[4] + a[11] * b[7] + b[10];
-    out[11] = a[9] * b[2] + a[10] * b[5] + a[11] * b[8] + b[11];
-}
+    int i;
+    __m128 r0, r1, r2, r3, x, y, z;
 
-void SrpMatrixMultiply43d(MATRIX43D out, const MATRIX43D a, const MATRIX43D b)
-{
-    /* The linear transformation portion is the same as 3X3 Matrix. */
-    out[0] = a[0] * b[0] + a[1] * b[3] + a[2] * b[6];
-    out[1] = a[0] * b[1] + a[1] * b[4] + a[2] * b[7];
-    out[2] = a[0] * b[2] + a[1] * b[5] + a[2] * b[8];
-
-    out[3] = a[3] * b[0] + a[4] * b[3] + a[5] * b[6];
-    out[4] = a[3] * b[1] + a[4] * b[4] + a[5] * b[7];
-    out[5] = a[3] * b[2] + a[4] * b[5] + a[5] * b[8];
-
-    out[6] = a[6] * b[0] + a[7] * b[3] + a[8] * b[6];
-    out[7] = a[6] * b[1] + a[7] * b[4] + a[8] * b[7];
-    out[8] = a[6] * b[2] + a[7] * b[5] + a[8] * b[8];
-
-    /* Now the translation portion. */
-    out[9]  = a[9] * b[0] + a[10] * b[3] + a[11] * b[6] + b[9];
-    out[10] = a[9] * b[1] + a[10] * b[4] + a[11] * b[7] + b[10];
-    out[11] = a[9] * b[2] + a[10] * b[5] + a[11] * b[8] + b[11];
+    r0 = _mm_loadu_ps(m);
+    r1 = _mm_loadu_ps(m + 4);
+    r2 = _mm_loadu_ps(m + 8);
+    r3 = _mm_loadu_ps(m + 12);
+
+    for (i = 0; i < count; i++)
+    {
+        x = _mm_set1_ps(in[i * 3]);
+        y = _mm_set1_ps(in[i * 3 + 1]);
+        z = _mm_set1_ps(in[i * 3 + 2]);
+
+        _mm_storeu_ps(out + i * 4, 
+                      _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, r0), 
+                                                       _mm_mul_ps(y, r1)), 
+                                            _mm_mul_ps(z, r2)), r3));
+    }
+
+    return i;
 }
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*                              Public Functions                              */
+/*----------------------------------------------------------------------------*/
 
 /*------------------------------------------------------------------------------
  * int SrpMatrixInvert43f(MATRIX43F out, const MATRIX43F m)
@@ -232,6 +297,55 @@ int SrpMatrixInvert43d(MATRIX43D out, const MATRIX43D m)
     return TRUE;
 }
 
+/*------------------------------------------------------------------------------
+ * int SrpMatrixIsRigid43f(const MATRIX43F m)
+ *
+ * Check if a matrix is rotation and translation only, i.e. the rows 
+ * of its linear portion are orthonormal, allowing for the error 
+ * a chain of multiplications builds up.
+ */
+int SrpMatrixIsRigid43f(const MATRIX43F m)
+{
+    int i, j;
+    float dot;
+
+    for (i = 0; i < 3; i++)
+    {
+        for (j = i; j < 3; j++)
+        {
+            dot = m[i * 3]     * m[j * 3] + 
+                  m[i * 3 + 1] * m[j * 3 + 1] + 
+                  m[i * 3 + 2] * m[j * 3 + 2];
+            if (fabsf(dot - (i == j ? 1.0f : 0.0f)) > EPSILON_E4F)
+            {
+                return FALSE;
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpMatrixInvertRigid43f(MATRIX43F out, const MATRIX43F m)
+ *
+ * Invert a rigid matrix, see SrpMatrixIsRigid43f. The inverse of 
+ * the rotation is its transpose, and the translation is -v * R^T. 
+ * out must not be m.
+ */
+void SrpMatrixInvertRigid43f(MATRIX43F out, const MATRIX43F m)
+{
+    ASSERTMSG(out != m, "SrpMatrixInvertRigid43f: invalid arguments.");
+
+    out[0] = m[0]; out[1] = m[3]; out[2] = m[6];
+    out[3] = m[1]; out[4] = m[4]; out[5] = m[7];
+    out[6] = m[2]; out[7] = m[5]; out[8] = m[8];
+
+    out[9]  = -(m[9] * m[0] + m[10] * m[1] + m[11] * m[2]);
+    out[10] = -(m[9] * m[3] + m[10] * m[4] + m[11] * m[5]);
+    out[11] = -(m[9] * m[6] + m[10] * m[7] + m[11] * m[8]);
+}
+
 /*------------------------------------------------------------------------------
  * void SrpMatrixMakeTranslation43f(MATRIX43F out, const VECTOR3F v)
  * void SrpMatrixMakeTranslation43d(MATRIX43D out, const VECTOR3D v)
@@ -308,8 +422,7 @@ void SrpMatrixMakeRotation43f(MATRIX43F out, const VECTOR3F v, float t)
     vNormal[2] = v[2] * oneDivLength;
 
     /* Calculate those intermidiary variables to save time. */
-    s = sinf(t);
-    c = cosf(t);
+    SrpMathSinCosf(t, &s, &c);
     n = 1.0f - c;
 
     xx = vNormal[0] * vNormal[0];
@@ -420,58 +533,239 @@ void SrpMatrixMakeScale43d(MATRIX43D out, const VECTOR3D v)
 }
 
 /*------------------------------------------------------------------------------
- * void SrpMatrixTransformVector3f(VECTOR3F out, const VECTOR3F v, 
-                                   const MATRIX43F m)
- * void SrpMatrixTransformVector3d(VECTOR3D out, const VECTOR3D v, 
-                                   const MATRIX43D m)
- * void SrpMatrixTransformVector4f(VECTOR4F out, const VECTOR4F v, 
-                                   const MATRIX43F m)
- * void SrpMatrixTransformVector4d(VECTOR4D out, const VECTOR4D v, 
-                                   const MATRIX43D m)
+ * void SrpMatrixTransformVectors3f(VECTOR3F *out, const VECTOR3F *in, 
+ *                                  int count, const MATRIX43F m)
+ *
+ * Transform count vectors with 4X3 matrix m, out[i] = in[i] * m. 
+ * out may be in itself but must not overlap it otherwise.
  *
- * These functions transform vector with 4X3 matrix m,
- * and store the result in vector out.
+ * Runs with the widest SIMD level SrpSimdGetLevel() gives.
  */
-void SrpMatrixTransformVector3f(VECTOR3F out, const VECTOR3F v, 
-                                const MATRIX43F m)
+void SrpMatrixTransformVectors3f(VECTOR3F *out, const VECTOR3F *in, 
+                                 int count, const MATRIX43F m)
 {
-    out[0] = v[0] * m[0] + v[1] * m[3] + v[2] * m[6] + m[9];
-    out[1] = v[0] * m[1] + v[1] * m[4] + v[2] * m[7] + m[10];
-    out[2] = v[0] * m[2] + v[1] * m[5] + v[2] * m[8] + m[11];
+    int i;
+    VECTOR3F temp;
+
+    ASSERTMSG(out != NULL && in != NULL && count >= 0 && m != NULL, 
+              "SrpMatrixTransformVectors3f: invalid arguments.");
+
+    i = 0;
+#if defined(SRP_SIMD_X86)
+    switch (SrpSimdGetLevel())
+    {
+    case SRP_SIMD_AVX512:
+        i = SrpTransformVectorsAvx512((float *)out, (const float *)in, 
+                                      count, m);
+        break;
+    case SRP_SIMD_AVX2:
+        i = SrpTransformVectorsAvx2((float *)out, (const float *)in, 
+                                    count, m);
+        break;
+    case SRP_SIMD_SSE2:
+        i = SrpTransformVectorsSse2((float *)out, (const float *)in, 
+                                    count, m);
+        break;
+    default:
+        break;
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        SrpMatrixTransformVector3f(temp, in[i], m);
+        SrpVectorCopy3f(out[i], temp);
+    }
 }
 
-void SrpMatrixTransformVector3d(VECTOR3D out, const VECTOR3D v, 
-                                const MATRIX43D m)
+/*------------------------------------------------------------------------------
+ * void SrpMatrixLoadIdentity44f(MATRIX44F m)
+ *
+ * Load identity.
+ */
+void SrpMatrixLoadIdentity44f(MATRIX44F m)
 {
-    out[0] = v[0] * m[0] + v[1] * m[3] + v[2] * m[6] + m[9];
-    out[1] = v[0] * m[1] + v[1] * m[4] + v[2] * m[7] + m[10];
-    out[2] = v[0] * m[2] + v[1] * m[5] + v[2] * m[8] + m[11];
+    memset(m, 0, sizeof(MATRIX44F));
+    m[0] = m[5] = m[10] = m[15] = 1.0f;
 }
 
-void SrpMatrixTransformVector4f(VECTOR4F out, const VECTOR4F v, 
-                                const MATRIX43F m)
+/*------------------------------------------------------------------------------
+ * void SrpMatrixCopy44f(MATRIX44F dst, const MATRIX44F src)
+ *
+ * Copy Matrix.
+ */
+void SrpMatrixCopy44f(MATRIX44F dst, const MATRIX44F src)
+{
+    memcpy(dst, src, sizeof(MATRIX44F));
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpMatrixMultiply44f(float *SRP_RESTRICT out, 
+ *                           const MATRIX44F a, const MATRIX44F b)
+ *
+ * Multiply matrix, out = a * b. out must not be a or b.
+ */
+void SrpMatrixMultiply44f(float *SRP_RESTRICT out, 
+                          const MATRIX44F a, const MATRIX44F b)
+{
+    int i, j;
+
+    ASSERTMSG(out != a && out != b, 
+              "SrpMatrixMultiply44f: invalid arguments.");
+
+    for (i = 0; i < 4; i++)
+    {
+        for (j = 0; j < 4; j++)
+        {
+            out[i * 4 + j] = a[i * 4]     * b[j]     + 
+                             a[i * 4 + 1] * b[4 + j] + 
+                             a[i * 4 + 2] * b[8 + j] + 
+                             a[i * 4 + 3] * b[12 + j];
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpMatrixExpand43f(MATRIX44F out, const MATRIX43F m)
+ *
+ * Expand a 4X3 matrix into a 4X4 one, the last column being (0 0 0 1).
+ */
+void SrpMatrixExpand43f(MATRIX44F out, const MATRIX43F m)
 {
-    out[0] = v[0] * m[0] + v[1] * m[3] + v[2] * m[6] + v[3] * m[9];
-    out[1] = v[0] * m[1] + v[1] * m[4] + v[2] * m[7] + v[3] * m[10];
-    out[2] = v[0] * m[2] + v[1] * m[5] + v[2] * m[8] + v[3] * m[11];
-    out[3] = v[3];
+    int i;
+
+    for (i = 0; i < 4; i++)
+    {
+        out[i * 4]     = m[i * 3];
+        out[i * 4 + 1] = m[i * 3 + 1];
+        out[i * 4 + 2] = m[i * 3 + 2];
+        out[i * 4 + 3] = 0.0f;
+    }
+    out[15] = 1.0f;
 }
 
-void SrpMatrixTransformVector4d(VECTOR4D out, const VECTOR4D v, 
-                                const MATRIX43D m)
+/*------------------------------------------------------------------------------
+ * void SrpMatrixMultiply43x44f(float *SRP_RESTRICT out, 
+ *                              const MATRIX43F a, const MATRIX44F b)
+ *
+ * Multiply a 4X3 matrix by a 4X4 one, out = a * b. a is taken as 
+ * expanded by SrpMatrixExpand43f, so out is a 4X4 matrix.
+ */
+void SrpMatrixMultiply43x44f(float *SRP_RESTRICT out, 
+                             const MATRIX43F a, const MATRIX44F b)
 {
-    out[0] = v[0] * m[0] + v[1] * m[3] + v[2] * m[6] + v[3] * m[9];
-    out[1] = v[0] * m[1] + v[1] * m[4] + v[2] * m[7] + v[3] * m[10];
-    out[2] = v[0] * m[2] + v[1] * m[5] + v[2] * m[8] + v[3] * m[11];
-    out[3] = v[3];
+    int i, j;
+
+    ASSERTMSG(out != a && out != b, 
+              "SrpMatrixMultiply43x44f: invalid arguments.");
+
+    for (i = 0; i < 3; i++)
+    {
+        for (j = 0; j < 4; j++)
+        {
+            out[i * 4 + j] = a[i * 3]     * b[j]     + 
+                             a[i * 3 + 1] * b[4 + j] + 
+                             a[i * 3 + 2] * b[8 + j];
+        }
+    }
+    for (j = 0; j < 4; j++)
+    {
+        out[12 + j] = a[9]  * b[j]     + 
+                      a[10] * b[4 + j] + 
+                      a[11] * b[8 + j] + b[12 + j];
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpMatrixMakePerspective44f(MATRIX44F out, float fovy, 
+ *                                  float aspect, float near, float far)
+ *
+ * Make a perspective projection matrix into homogeneous clip space.
+ * The matrix is
+ * | 1/tan    0    0  0 |
+ * |   0   ar/tan  0  0 |
+ * |   0      0    A -1 |
+ * |   0      0    B  0 |
+ *
+ * A = (n + f) / (n - f), B = -2nf / (n - f), so that w = -z and z 
+ * goes from -w at the near plane to w at the far one. x and y are 
+ * scaled as SrpTransRenderListCamToProj does, and the frustum built 
+ * by SrpSetFrustum is exactly -w <= x, y, z <= w.
+ */
+void SrpMatrixMakePerspective44f(MATRIX44F out, float fovy, 
+                                 float aspect, float near, float far)
+{
+    float oneOverTanTheta;
+
+    ASSERTMSG(out != NULL && fovy > 0.0f && fovy < 180.0f &&
+              aspect > 0.0f && near < 0.0f && far < near,
+              "SrpMatrixMakePerspective44f: invalid arguments.");
+
+    oneOverTanTheta = 1.0f / SrpMathTanf(SrpMathDegToRadf(fovy / 2.0f));
+
+    memset(out, 0, sizeof(MATRIX44F));
+    out[0]  = oneOverTanTheta;
+    out[5]  = aspect * oneOverTanTheta;
+    out[10] = (near + far) / (near - far);
+    out[11] = -1.0f;
+    out[14] = -2.0f * near * far / (near - far);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpMatrixTransformVector44f(float *SRP_RESTRICT out, 
+ *                                  const VECTOR3F v, const MATRIX44F m)
+ *
+ * Transform point v, w being 1, into homogeneous vector out = v * m.
+ */
+void SrpMatrixTransformVector44f(float *SRP_RESTRICT out, 
+                                 const VECTOR3F v, const MATRIX44F m)
+{
+    out[0] = v[0] * m[0] + v[1] * m[4] + v[2] * m[8]  + m[12];
+    out[1] = v[0] * m[1] + v[1] * m[5] + v[2] * m[9]  + m[13];
+    out[2] = v[0] * m[2] + v[1] * m[6] + v[2] * m[10] + m[14];
+    out[3] = v[0] * m[3] + v[1] * m[7] + v[2] * m[11] + m[15];
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpMatrixTransformVectors44f(VECTOR4F *out, const VECTOR3F *in, 
+ *                                   int count, const MATRIX44F m)
+ *
+ * Transform count points into homogeneous vectors with 4X4 matrix m, 
+ * out[i] = in[i] * m. out and in must not overlap.
+ *
+ * Runs with SSE2 when SrpSimdGetLevel() gives any SIMD level.
+ */
+void SrpMatrixTransformVectors44f(VECTOR4F *out, const VECTOR3F *in, 
+                                  int count, const MATRIX44F m)
+{
+    int i;
+
+    ASSERTMSG(out != NULL && in != NULL && count >= 0 && m != NULL, 
+              "SrpMatrixTransformVectors44f: invalid arguments.");
+
+    i = 0;
+#if defined(SRP_SIMD_X86)
+    if (SrpSimdGetLevel() != SRP_SIMD_NONE)
+    {
+        i = SrpTransformVectors44Sse2((float *)out, (const float *)in, 
+                                      count, m);
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        SrpMatrixTransformVector44f(out[i], in[i], m);
+    }
 }
 
 /*------------------------------------------------------------------------------
  * void SrpMatrixPrint43f(const MATRIX43F m, const char *name)
  * void SrpMatrixPrint43d(const MATRIX43D m, const char *name)
+ * void SrpMatrixPrint44f(const MATRIX44F m, const char *name)
  *
  * These functions print the matrix m.
- * The element at row i and column j is m[i * 3 + j].
+ * The element at row i and column j is m[i * 3 + j], or m[i * 4 + j] 
+ * for 4X4 matrix.
  */
 void SrpMatrixPrint43f(const MATRIX43F m, const char *name)
 {
@@ -506,3 +800,20 @@ void SrpMatrixPrint43d(const MATRIX43D m, const char *name)
         printf("|\n");
     }
 }
+
+void SrpMatrixPrint44f(const MATRIX44F m, const char *name)
+{
+    int i, j;
+
+    printf("Print Matrix:\n\t%s =\n", name);
+
+    for (i = 0; i < 4; i++)
+    {
+        printf("\t| ");
+        for (j = 0; j < 4; j++)
+        {
+            printf("%12f ", m[i * 4 + j]);
+        }
+        printf("|\n");
+    }
+}
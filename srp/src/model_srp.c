@@ -7,6 +7,7 @@
  ******************************************************************************/
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include "datadef_ig.h"
@@ -17,8 +18,12 @@
 #include "model_srp.h"
 #include "vector_srp.h"
 #include "matrix_srp.h"
+#include "stream_srp.h"
+#include "quaternion_srp.h"
+#include "frustum_srp.h"
 #include "rcmanager_srp.h"
 #include "renderee_srp.h"
+#include "octree_srp.h"
 
 /*----------------------------------------------------------------------------*/
 /*                               Data Structure                               */
@@ -27,9 +32,27 @@
 #define TRIANGLE_STATE_ACTIVE     0x00000000
 #define TRIANGLE_STATE_CLIPPED    0x00000001
 #define TRIANGLE_STATE_BACKFACE   0x00000002
+#define TRIANGLE_STATE_CROSSING   0x00000004 /* Clipped when inserted */
 
 #define OBJECT_STATE_ACTIVE       0x00000000
 #define OBJECT_STATE_CULLED       0x00000001
+#define OBJECT_STATE_SMALL        0x00000002 /* Drawn as a point */
+
+#define MESHLET_STATE_ACTIVE      0x00000000
+#define MESHLET_STATE_CULLED      0x00000001
+
+#define MODEL_MAX_LODS            4     /* Levels in a chain, model included */
+#define MODEL_LOD_RATIO           0.5f  /* Triangle ratio of adjacent levels */
+#define MODEL_LOD_MIN_TRIANGLES   8     /* Never simplify below this */
+#define MODEL_LOD_MIN_REDUCTION   0.9f  /* A level must drop 10% at least */
+#define MODEL_LOD_BOUNDARY_WEIGHT 10.0  /* Penalty for moving open borders */
+
+#define OBJECT_LOD_PIXELS         64.0f /* Screen radius to leave level 0 */
+#define OBJECT_LOD_HYSTERESIS     0.15f /* Dead band around each threshold */
+
+#define MESHLET_MAX_VERTICES      64
+#define MESHLET_MAX_TRIANGLES     124
+#define MESHLET_CONE_MIN_DOT      0.1f  /* Wider cones are never culled */
 
 /*
  * A triangle based on an external vertex list
@@ -45,6 +68,27 @@ struct TRIANGLE_T
 
 typedef struct TRIANGLE_T TRIANGLE;
 
+/*
+ * A cluster of neighbouring triangles of a model, culled as a whole. It
+ * owns a contiguous range of the vertex list and of the triangle list.
+ */
+struct MESHLET_T
+{
+    int state;
+
+    int firstVertex;
+    int numVertices;
+    int firstTriangle;
+    int numTriangles;
+
+    VECTOR3F center;      /* Bounding sphere in model space */
+    float radius;
+    VECTOR3F coneAxis;    /* Average facing of the triangles */
+    float coneCutoff;     /* Sine of the cone's half angle, 1 if too wide */
+};
+
+typedef struct MESHLET_T MESHLET;
+
 /*
  * A model(triangle mesh) based on a vertex list and a list of triangles
  */
@@ -57,9 +101,16 @@ struct MODEL_T
     int numVertices;
     VECTOR3F *pOldList;
     VECTOR3F *pNewList;
+    VEC3_STREAM *pStream;    /* pOldList as a stream, for SRP_VERTEX_STREAM */
+    VEC3_STREAM *pCamStream; /* Vertices in camera space as a stream */
 
     int numTriangles;
     TRIANGLE *pTriList;
+
+    int numMeshlets;
+    MESHLET *pMeshletList;
+
+    struct MODEL_T *pLod; /* Next coarser level of detail, NULL if none */
 };
 
 /*
@@ -72,18 +123,76 @@ struct OBJECT_T
     int state;
 
     float radius;
+    int planeMask;        /* Frustum planes it's not completely inside */
+    int cullPlane;        /* Frustum plane which culled it last time */
 
     VECTOR3F pos;         /* Position in world space */
     VECTOR3F dir;         /* Orientation in world space, measured in degree */
     VECTOR3F sca;         /* Scale factor */
 
     VECTOR3F translation; /* Traslation vector */
-    MATRIX43F rotation;   /* Rotation matrix derived from (dir + deltaDir) */
+    QUATERNION orientation; /* Derived from (dir + deltaDir), or turned */
     VECTOR3F scale;       /* scale vector */
 
+    MATRIX43F world;      /* Local to world, rebuilt when worldDirty is set */
+    int worldDirty;
+    MATRIX43F toCam;      /* Local to camera, world times current modelview */
+
     MODEL *pModel;
+    MODEL *pLodModel;     /* Level of detail being drawn, from pModel chain */
+    int lod;              /* Index of pLodModel in the chain */
+
+    OCTREE_ENTRY *pEntry; /* Where it is in an octree, NULL if in none */
+};
+
+/*
+ * Quadric error metric of a vertex, the symmetric 4X4 matrix 
+ * stored as its upper triangle:
+ *
+ * | 0 1 2 3 |
+ * |   4 5 6 |
+ * |     7 8 |
+ * |       9 |
+ */
+typedef double QUADRIC[10];
+
+/*
+ * A candidate edge collapse, v1 is merged into v0 at pos
+ */
+struct COLLAPSE_T
+{
+    double cost;
+    int v0, v1;
+    VECTOR3F pos;
+
+    int triangle;         /* A triangle using the edge */
+};
+
+typedef struct COLLAPSE_T COLLAPSE;
+
+/*
+ * Working data of quadric error simplification
+ */
+struct SIMPLIFIER_T
+{
+    int numVertices;
+    int numTriangles;
+
+    VECTOR3F *pPos;       /* Vertex positions, updated by collapses */
+    QUADRIC *pQuadric;    /* Accumulated error quadric per vertex */
+    int *pRemap;          /* Vertex a vertex was merged into, or itself */
+    int *pMark;           /* Pass in which a vertex was last touched */
+
+    int *pIndex;          /* 3 indices per triangle, -1 once removed */
+    int *pAdjStart;       /* Vertex to triangle adjacency, CSR layout */
+    int *pAdjList;
+
+    int numEdges;
+    COLLAPSE *pEdge;
 };
 
+typedef struct SIMPLIFIER_T SIMPLIFIER;
+
 /*----------------------------------------------------------------------------*/
 /*                                Private Data                                */
 /*----------------------------------------------------------------------------*/
@@ -94,11 +203,39 @@ struct OBJECT_T
 
 static int SrpGetLine(char *buffer, int maxLength, FILE *fp);
 static void SrpCalculateModelRadius(MODEL *pModel);
+static int SrpNewModel(MODEL **ppModel, int numVertices, int numTriangles);
+static void SrpQuadricAddPlane(QUADRIC q, const VECTOR3F n, double d, 
+                               double weight);
+static double SrpQuadricError(const QUADRIC q, const VECTOR3F v);
+static void SrpQuadricPlaceVertex(COLLAPSE *pCollapse, const QUADRIC q, 
+                                  const VECTOR3F p0, const VECTOR3F p1);
+static int SrpCompareEdge(const void *a, const void *b);
+static int SrpCompareCollapse(const void *a, const void *b);
+static int SrpSimplifierFind(const SIMPLIFIER *pSim, int v);
+static void SrpSimplifierInitQuadrics(SIMPLIFIER *pSim);
+static void SrpSimplifierCollectEdges(SIMPLIFIER *pSim);
+static void SrpBuildAdjacency(int numVertices, int numTriangles, 
+                              const int *pIndex, int *pStart, int *pList);
+static int SrpSimplifierCollapse(SIMPLIFIER *pSim, const COLLAPSE *pCollapse, 
+                                 int pass);
+static int SrpSimplifyModel(MODEL **ppLod, const MODEL *pSrc, int target);
+static void SrpBuildModelLods(MODEL *pModel);
+static int SrpBuildModelMeshlets(MODEL *pModel);
+static void SrpCalculateMeshletBounds(const MODEL *pModel, MESHLET *pMeshlet);
+static void SrpResetModelState(MODEL *pModel);
 static void SrpResetObjectState(OBJECT *pObj);
+static void SrpSetObjectLod(OBJECT *pObj, int lod);
+static float SrpGetObjectScreenRadius(const OBJECT *pObj, float depth);
+static void SrpSelectObjectLod(OBJECT *pObj, float depth);
+static void SrpUpdateObjectMatrix(OBJECT *pObj);
 static void SrpCullObject(OBJECT *pObj);
+static void SrpCullSmallObject(OBJECT *pObj);
+static void SrpCullMeshlets(OBJECT *pObj);
 static void SrpTransObjectLocToCam(OBJECT *obj);
+static void SrpClipObject(OBJECT *pObj);
 static void SrpCullBackFace(OBJECT *pObj);
 static void SrpInsertObjectToRenderList(const OBJECT *obj, RENDER_LIST *pRl);
+static void SrpInsertObjectSplat(const OBJECT *pObj, RENDER_LIST *pRl);
 
 /*----------------------------------------------------------------------------*/
 /*                             Private Functions                              */
@@ -178,98 +315,1480 @@ static void SrpCalculateModelRadius(MODEL *pModel)
 }
 
 /*------------------------------------------------------------------------------
- * void SrpResetObject(OBJECT *pObj)
+ * int SrpNewModel(MODEL **ppModel, int numVertices, int numTriangles)
  *
- * Reset object.
+ * Allocate a model with room for numVertices vertices and numTriangles
+ * triangles. Only the counts and the LOD chain are initialized.
+ *
+ * Return:
+ *     TRUE if successful; otherwise, FALSE.
  */
-static void SrpResetObjectState(OBJECT *pObj)
+static int SrpNewModel(MODEL **ppModel, int numVertices, int numTriangles)
 {
-    int i;
+    int sizeVertex, sizeTriangle;
     MODEL *pModel;
 
-    ASSERTMSG(pObj != NULL, "SrpResetObjectState: invalid argument.");
+    ASSERTMSG(ppModel != NULL && numVertices > 0 && numTriangles > 0, 
+              "SrpNewModel: invalid arguments.");
 
-    pModel = pObj->pModel;
-    ASSERTMSG(pModel->pOldList != NULL, 
-              "SrpResetObjectState: invalid old vertex list.");
-    ASSERTMSG(pModel->pNewList != NULL, 
-              "SrpResetObjectState: invalid new vertex list.");
-    ASSERTMSG(pModel->pTriList != NULL, 
-              "SrpResetObjectState: invalid triangle list.");
+    if (!IgNewMemory((void **)ppModel, sizeof(MODEL)))
+    {
+        return FALSE;
+    }
+    pModel = *ppModel;
 
-    CLEAN_BIT(pObj->state);
-    for (i = 0; i < pModel->numTriangles; i++)
+    sizeVertex = numVertices * sizeof(VECTOR3F);
+    if (!IgNewMemory((void **)&pModel->pOldList, sizeVertex))
     {
-        CLEAN_BIT(pModel->pTriList[i].state);
+        IgFreeMemory(pModel);
+        return FALSE;
+    }
+
+    if (!IgNewMemory((void **)&pModel->pNewList, sizeVertex))
+    {
+        IgFreeMemory(pModel->pOldList);
+        IgFreeMemory(pModel);
+        return FALSE;
+    }
+
+    sizeTriangle = numTriangles * sizeof(TRIANGLE);
+    if (!IgNewMemory((void **)&pModel->pTriList, sizeTriangle))
+    {
+        IgFreeMemory(pModel->pOldList);
+        IgFreeMemory(pModel->pNewList);
+        IgFreeMemory(pModel);
+        return FALSE;
     }
+
+    pModel->numVertices = numVertices;
+    pModel->numTriangles = numTriangles;
+    pModel->numMeshlets = 0;
+    pModel->pMeshletList = NULL;
+    pModel->pStream = NULL;
+    pModel->pCamStream = NULL;
+    pModel->pLod = NULL;
+
+    return TRUE;
 }
 
 /*------------------------------------------------------------------------------
- * void SrpCullObject(OBJECT *pObj)
+ * void SrpQuadricAddPlane(QUADRIC q, const VECTOR3F n, double d, 
+ *                         double weight)
  *
- * Object culling.
+ * Accumulate the squared distance to plane (n, d) into quadric q.
+ * n must be normalized.
  */
-static void SrpCullObject(OBJECT *pObj)
+static void SrpQuadricAddPlane(QUADRIC q, const VECTOR3F n, double d, 
+                               double weight)
 {
-    VECTOR3F posT;
-    MATRIX43F *pModelView;
+    double a = n[0], b = n[1], c = n[2];
+
+    q[0] += weight * a * a;
+    q[1] += weight * a * b;
+    q[2] += weight * a * c;
+    q[3] += weight * a * d;
+    q[4] += weight * b * b;
+    q[5] += weight * b * c;
+    q[6] += weight * b * d;
+    q[7] += weight * c * c;
+    q[8] += weight * c * d;
+    q[9] += weight * d * d;
+}
 
-    ASSERTMSG(pObj != NULL, "SrpCullObject: invalid argument.");
+/*------------------------------------------------------------------------------
+ * double SrpQuadricError(const QUADRIC q, const VECTOR3F v)
+ *
+ * Evaluate quadric q at v, that is [v 1] * Q * [v 1]T.
+ */
+static double SrpQuadricError(const QUADRIC q, const VECTOR3F v)
+{
+    double x = v[0], y = v[1], z = v[2];
+
+    return q[0] * x * x + 2.0 * q[1] * x * y + 2.0 * q[2] * x * z + 
+           2.0 * q[3] * x + q[4] * y * y + 2.0 * q[5] * y * z + 
+           2.0 * q[6] * y + q[7] * z * z + 2.0 * q[8] * z + q[9];
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpQuadricPlaceVertex(COLLAPSE *pCollapse, const QUADRIC q, 
+ *                            const VECTOR3F p0, const VECTOR3F p1)
+ *
+ * Find where the vertex merged from edge (p0, p1) goes and what it
+ * costs. The position minimizing q is taken if the system is well
+ * conditioned and the result stays near the edge; otherwise the best
+ * of both ends and the midpoint is taken.
+ */
+static void SrpQuadricPlaceVertex(COLLAPSE *pCollapse, const QUADRIC q, 
+                                  const VECTOR3F p0, const VECTOR3F p1)
+{
+    /* Cofactors of the linear portion of q */
+    double c00, c01, c02, c11, c12, c22;
+    double det, oneDivDet, cost, bestCost;
+    VECTOR3F mid, optimal;
 
-    /* Transform object's postion into camera space */
-    pModelView = SrpRCGetModelView();
-    SrpMatrixTransformVector3f(posT, pObj->pos, *pModelView);
+    SrpVectorAdd3f(mid, p0, p1);
+    SrpVectorScale3f(mid, mid, 0.5f);
 
-    if (!SrpRCIsVisible(posT, pObj->radius))
+    SrpVectorCopy3f(pCollapse->pos, p0);
+    bestCost = SrpQuadricError(q, p0);
+
+    cost = SrpQuadricError(q, p1);
+    if (cost < bestCost)
     {
-        SET_BIT(pObj->state, OBJECT_STATE_CULLED);
+        SrpVectorCopy3f(pCollapse->pos, p1);
+        bestCost = cost;
+    }
+
+    cost = SrpQuadricError(q, mid);
+    if (cost < bestCost)
+    {
+        SrpVectorCopy3f(pCollapse->pos, mid);
+        bestCost = cost;
+    }
+
+    /* Solve
+     * | q0 q1 q2 |   | x |     | q3 |
+     * | q1 q4 q5 | * | y | = - | q6 |
+     * | q2 q5 q7 |   | z |     | q8 |
+     */
+    c00 = q[4] * q[7] - q[5] * q[5];
+    c01 = q[2] * q[5] - q[1] * q[7];
+    c02 = q[1] * q[5] - q[2] * q[4];
+    c11 = q[0] * q[7] - q[2] * q[2];
+    c12 = q[1] * q[2] - q[0] * q[5];
+    c22 = q[0] * q[4] - q[1] * q[1];
+
+    det = q[0] * c00 + q[1] * c01 + q[2] * c02;
+
+    /* For a positive semi-definite matrix, det never exceeds the
+     * product of the diagonal, so this is a relative test.
+     */
+    if (det > EPSILON_E6D * q[0] * q[4] * q[7] && det > 0.0)
+    {
+        oneDivDet = 1.0 / det;
+        optimal[0] = (float)(-(c00 * q[3] + c01 * q[6] + c02 * q[8]) * 
+                             oneDivDet);
+        optimal[1] = (float)(-(c01 * q[3] + c11 * q[6] + c12 * q[8]) * 
+                             oneDivDet);
+        optimal[2] = (float)(-(c02 * q[3] + c12 * q[6] + c22 * q[8]) * 
+                             oneDivDet);
+
+        cost = SrpQuadricError(q, optimal);
+        if (cost < bestCost && SrpVectorDistanceSquared3f(optimal, mid) <= 
+                               SrpVectorDistanceSquared3f(p0, p1))
+        {
+            SrpVectorCopy3f(pCollapse->pos, optimal);
+            bestCost = cost;
+        }
     }
+
+    pCollapse->cost = SrpMathMax(bestCost, 0.0);
 }
 
 /*------------------------------------------------------------------------------
- * void SrpTransObjectLocToCam(OBJECT *pObj)
+ * int SrpCompareEdge(const void *a, const void *b)
+ * int SrpCompareCollapse(const void *a, const void *b)
  *
- * Transfrom object from local space to camera space.
+ * qsort callbacks, order collapses by their vertex pair, or by cost.
  */
-static void SrpTransObjectLocToCam(OBJECT *pObj)
+static int SrpCompareEdge(const void *a, const void *b)
 {
-    int i;
-    MODEL *pModel;
-    MATRIX43F *pModelView;
-    VECTOR3F scaledVec, rotatedVec, translatedVec, transformedVec;
+    const COLLAPSE *pA = (const COLLAPSE *)a;
+    const COLLAPSE *pB = (const COLLAPSE *)b;
 
-    ASSERTMSG(pObj != NULL, 
-              "SrpTransObjectLocToCam: invalid arguments.");
+    if (pA->v0 != pB->v0)
+    {
+        return (pA->v0 < pB->v0) ? -1 : 1;
+    }
 
-    pModel = pObj->pModel;
-    ASSERTMSG(pModel->pOldList != NULL, 
-              "SrpTransObjectLocToCam: invalid old vertex list.");
-    ASSERTMSG(pModel->pNewList != NULL, 
-              "SrpTransObjectLocToCam: invalid new vertex list.");
+    if (pA->v1 != pB->v1)
+    {
+        return (pA->v1 < pB->v1) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+static int SrpCompareCollapse(const void *a, const void *b)
+{
+    const COLLAPSE *pA = (const COLLAPSE *)a;
+    const COLLAPSE *pB = (const COLLAPSE *)b;
+
+    if (pA->cost != pB->cost)
+    {
+        return (pA->cost < pB->cost) ? -1 : 1;
+    }
+
+    return SrpCompareEdge(a, b);
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpSimplifierFind(const SIMPLIFIER *pSim, int v)
+ *
+ * Get the vertex that v has been merged into.
+ */
+static int SrpSimplifierFind(const SIMPLIFIER *pSim, int v)
+{
+    while (pSim->pRemap[v] != v)
+    {
+        v = pSim->pRemap[v];
+    }
+
+    return v;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpSimplifierCollectEdges(SIMPLIFIER *pSim)
+ *
+ * Fill pSim->pEdge with the 3 edges of every remaining triangle,
+ * sorted by vertex pair. An edge shared by two triangles shows up twice.
+ */
+static void SrpSimplifierCollectEdges(SIMPLIFIER *pSim)
+{
+    int t, j, v0, v1;
+    int *pIndex;
+    COLLAPSE *pEdge;
+
+    pSim->numEdges = 0;
+    for (t = 0; t < pSim->numTriangles; t++)
+    {
+        pIndex = &pSim->pIndex[t * 3];
+        if (pIndex[0] < 0)
+        {
+            continue;
+        }
+
+        for (j = 0; j < 3; j++)
+        {
+            v0 = pIndex[j];
+            v1 = pIndex[(j + 1) % 3];
+
+            pEdge = &pSim->pEdge[pSim->numEdges++];
+            pEdge->v0 = SrpMathMin(v0, v1);
+            pEdge->v1 = SrpMathMax(v0, v1);
+
+            pEdge->triangle = t;
+        }
+    }
+
+    qsort(pSim->pEdge, pSim->numEdges, sizeof(COLLAPSE), SrpCompareEdge);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpSimplifierInitQuadrics(SIMPLIFIER *pSim)
+ *
+ * Sum up the area weighted plane quadrics of the triangles around each
+ * vertex. Open borders get an extra plane perpendicular to their face, so
+ * that the silhouette of the mesh doesn't erode first.
+ */
+static void SrpSimplifierInitQuadrics(SIMPLIFIER *pSim)
+{
+    int i, j, t, run;
+    int *pIndex;
+    float length;
+    VECTOR3F *pPos;
+    VECTOR3F normal, edge, border;
+    COLLAPSE *pEdge;
+
+    memset(pSim->pQuadric, 0, pSim->numVertices * sizeof(QUADRIC));
+
+    pPos = pSim->pPos;
+    for (t = 0; t < pSim->numTriangles; t++)
+    {
+        pIndex = &pSim->pIndex[t * 3];
+        if (pIndex[0] < 0)
+        {
+            continue;
+        }
+
+        SrpVectorGetPlaneNormal3f(normal, pPos[pIndex[0]], pPos[pIndex[1]], 
+                                  pPos[pIndex[2]]);
+        length = SrpVectorLength3f(normal);
+        if (length < EPSILON_E6F)
+        {
+            continue;
+        }
+        SrpVectorScale3f(normal, normal, 1.0f / length);
+
+        for (j = 0; j < 3; j++)
+        {
+            SrpQuadricAddPlane(pSim->pQuadric[pIndex[j]], normal, 
+                -SrpVectorDotProduct3f(normal, pPos[pIndex[0]]), 
+                length * 0.5);
+        }
+    }
+
+    SrpSimplifierCollectEdges(pSim);
+    for (i = 0; i < pSim->numEdges; i += run)
+    {
+        pEdge = &pSim->pEdge[i];
+        for (run = 1; i + run < pSim->numEdges; run++)
+        {
+            if (SrpCompareEdge(pEdge, pEdge + run) != 0)
+            {
+                break;
+            }
+        }
+
+        /* Only border edges belong to a single triangle */
+        if (run != 1)
+        {
+            continue;
+        }
+
+        t = pEdge->triangle;
+        pIndex = &pSim->pIndex[t * 3];
+        SrpVectorGetPlaneNormal3f(normal, pPos[pIndex[0]], pPos[pIndex[1]], 
+                                  pPos[pIndex[2]]);
+        SrpVectorSubtract3f(edge, pPos[pEdge->v1], pPos[pEdge->v0]);
+        SrpVectorCrossProduct3f(border, edge, normal);
+
+        length = SrpVectorLength3f(border);
+        if (length < EPSILON_E6F)
+        {
+            continue;
+        }
+        SrpVectorScale3f(border, border, 1.0f / length);
+
+        for (j = 0; j < 2; j++)
+        {
+            SrpQuadricAddPlane(pSim->pQuadric[j == 0 ? pEdge->v0 : pEdge->v1],
+                border, -SrpVectorDotProduct3f(border, pPos[pEdge->v0]), 
+                MODEL_LOD_BOUNDARY_WEIGHT * 
+                SrpVectorLengthSquared3f(edge));
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpBuildAdjacency(int numVertices, int numTriangles, 
+ *                        const int *pIndex, int *pStart, int *pList)
+ *
+ * Build the list of triangles around each vertex, from 3 indices per 
+ * triangle. Triangles whose first index is negative are skipped. The 
+ * triangles around vertex v are pList[pStart[v]] to pList[pStart[v + 1] - 1],
+ * pStart holds numVertices + 1 entries.
+ */
+static void SrpBuildAdjacency(int numVertices, int numTriangles, 
+                              const int *pIndex, int *pStart, int *pList)
+{
+    int t, j, v;
+
+    memset(pStart, 0, (numVertices + 1) * sizeof(int));
+    for (t = 0; t < numTriangles * 3; t++)
+    {
+        if (pIndex[t - t % 3] >= 0)
+        {
+            pStart[pIndex[t] + 1]++;
+        }
+    }
+
+    for (v = 0; v < numVertices; v++)
+    {
+        pStart[v + 1] += pStart[v];
+    }
+
+    /* Fill in, using the start of each vertex as a cursor */
+    for (t = 0; t < numTriangles; t++)
+    {
+        if (pIndex[t * 3] < 0)
+        {
+            continue;
+        }
+
+        for (j = 0; j < 3; j++)
+        {
+            pList[pStart[pIndex[t * 3 + j]]++] = t;
+        }
+    }
+
+    /* Every cursor has reached the next start, shift them back */
+    for (v = numVertices; v > 0; v--)
+    {
+        pStart[v] = pStart[v - 1];
+    }
+    pStart[0] = 0;
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpSimplifierCollapse(SIMPLIFIER *pSim, const COLLAPSE *pCollapse, 
+ *                           int pass)
+ *
+ * Merge pCollapse->v1 into pCollapse->v0. The collapse is refused if a 
+ * vertex of the edge has already moved in this pass, or if it would
+ * turn a remaining triangle upside down.
+ *
+ * Return:
+ *     The number of triangles removed by the collapse, 0 if refused.
+ */
+static int SrpSimplifierCollapse(SIMPLIFIER *pSim, const COLLAPSE *pCollapse, 
+                                 int pass)
+{
+    int i, j, k, t, side, removed, moved;
+    int v0 = pCollapse->v0, v1 = pCollapse->v1;
+    int verts[3];
+    const float *pCorner[3];
+    VECTOR3F oldNormal, newNormal;
+
+    if (pSim->pMark[v0] == pass || pSim->pMark[v1] == pass)
+    {
+        return 0;
+    }
+
+    removed = 0;
+    for (side = 0; side < 2; side++)
+    {
+        k = (side == 0) ? v0 : v1;
+        for (i = pSim->pAdjStart[k]; i < pSim->pAdjStart[k + 1]; i++)
+        {
+            t = pSim->pAdjList[i];
+
+            moved = 0;
+            for (j = 0; j < 3; j++)
+            {
+                verts[j] = SrpSimplifierFind(pSim, pSim->pIndex[t * 3 + j]);
+                if (verts[j] == v0 || verts[j] == v1)
+                {
+                    pCorner[j] = pCollapse->pos;
+                    moved++;
+                }
+                else
+                {
+                    pCorner[j] = pSim->pPos[verts[j]];
+                }
+            }
+
+            /* Already degenerated by another collapse of this pass */
+            if (verts[0] == verts[1] || verts[1] == verts[2] || 
+                verts[2] == verts[0])
+            {
+                continue;
+            }
+
+            /* The triangle is on the edge and vanishes with it */
+            if (moved == 2)
+            {
+                if (side == 0)
+                {
+                    removed++;
+                }
+                continue;
+            }
+
+            SrpVectorGetPlaneNormal3f(oldNormal, pSim->pPos[verts[0]], 
+                                      pSim->pPos[verts[1]], 
+                                      pSim->pPos[verts[2]]);
+            SrpVectorGetPlaneNormal3f(newNormal, pCorner[0], pCorner[1], 
+                                      pCorner[2]);
+            if (SrpVectorDotProduct3f(oldNormal, newNormal) <= 0.0f)
+            {
+                return 0;
+            }
+        }
+    }
+
+    pSim->pRemap[v1] = v0;
+    SrpVectorCopy3f(pSim->pPos[v0], pCollapse->pos);
+    for (k = 0; k < 10; k++)
+    {
+        pSim->pQuadric[v0][k] += pSim->pQuadric[v1][k];
+    }
+
+    pSim->pMark[v0] = pass;
+    pSim->pMark[v1] = pass;
+
+    return removed;
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpSimplifyModel(MODEL **ppLod, const MODEL *pSrc, int target)
+ *
+ * Build a simplified copy of pSrc with about target triangles, using
+ * quadric error edge collapse. Each pass sorts all edges by cost and
+ * collapses the cheapest ones, keeping the collapses of a pass apart
+ * from each other.
+ *
+ * Return:
+ *     TRUE if a model has been created; otherwise, FALSE.
+ */
+static int SrpSimplifyModel(MODEL **ppLod, const MODEL *pSrc, int target)
+{
+    int i, j, t, v, pass, alive, removed, numVertices, numTriangles, size;
+    int *pIndex;
+    int ret = FALSE;
+    byte *pBlock;
+    MODEL *pLod;
+    TRIANGLE *pTri;
+    QUADRIC q;
+    SIMPLIFIER sim;
+
+    ASSERTMSG(ppLod != NULL && pSrc != NULL, 
+              "SrpSimplifyModel: invalid arguments.");
+
+    sim.numVertices = pSrc->numVertices;
+    sim.numTriangles = pSrc->numTriangles;
+
+    /* Carve all working arrays out of one block, widest types first */
+    size = sim.numVertices * sizeof(QUADRIC) + 
+           sim.numTriangles * 3 * sizeof(COLLAPSE) + 
+           sim.numVertices * sizeof(VECTOR3F) + 
+           (sim.numVertices * 3 + 1 + sim.numTriangles * 6) * sizeof(int);
+    if (!IgNewMemory((void **)&pBlock, size))
+    {
+        return FALSE;
+    }
+
+    sim.pQuadric  = (QUADRIC *)pBlock;
+    sim.pEdge     = (COLLAPSE *)(sim.pQuadric + sim.numVertices);
+    sim.pPos      = (VECTOR3F *)(sim.pEdge + sim.numTriangles * 3);
+    sim.pRemap    = (int *)(sim.pPos + sim.numVertices);
+    sim.pMark     = sim.pRemap + sim.numVertices;
+    sim.pAdjStart = sim.pMark + sim.numVertices;
+    sim.pIndex    = sim.pAdjStart + sim.numVertices + 1;
+    sim.pAdjList  = sim.pIndex + sim.numTriangles * 3;
+
+    memcpy(sim.pPos, pSrc->pOldList, sim.numVertices * sizeof(VECTOR3F));
+    for (v = 0; v < sim.numVertices; v++)
+    {
+        sim.pRemap[v] = v;
+        sim.pMark[v] = 0;
+    }
+
+    alive = 0;
+    for (t = 0; t < sim.numTriangles; t++)
+    {
+        pIndex = &sim.pIndex[t * 3];
+        for (j = 0; j < 3; j++)
+        {
+            pIndex[j] = pSrc->pTriList[t].index[j];
+        }
+
+        if (pIndex[0] == pIndex[1] || pIndex[1] == pIndex[2] || 
+            pIndex[2] == pIndex[0])
+        {
+            pIndex[0] = -1;
+            continue;
+        }
+        alive++;
+    }
+
+    SrpSimplifierInitQuadrics(&sim);
+
+    for (pass = 1; alive > target; pass++)
+    {
+        /* Keep one entry per edge and price it */
+        SrpSimplifierCollectEdges(&sim);
+        for (i = 0, j = 0; i < sim.numEdges; i++)
+        {
+            if (j > 0 && SrpCompareEdge(&sim.pEdge[j - 1], &sim.pEdge[i]) == 0)
+            {
+                continue;
+            }
+            sim.pEdge[j++] = sim.pEdge[i];
+        }
+        sim.numEdges = j;
+
+        for (i = 0; i < sim.numEdges; i++)
+        {
+            for (j = 0; j < 10; j++)
+            {
+                q[j] = sim.pQuadric[sim.pEdge[i].v0][j] + 
+                       sim.pQuadric[sim.pEdge[i].v1][j];
+            }
+            SrpQuadricPlaceVertex(&sim.pEdge[i], q, sim.pPos[sim.pEdge[i].v0],
+                                  sim.pPos[sim.pEdge[i].v1]);
+        }
+        qsort(sim.pEdge, sim.numEdges, sizeof(COLLAPSE), SrpCompareCollapse);
+
+        SrpBuildAdjacency(sim.numVertices, sim.numTriangles, sim.pIndex, 
+                          sim.pAdjStart, sim.pAdjList);
+
+        removed = 0;
+        for (i = 0; i < sim.numEdges && alive > target; i++)
+        {
+            j = SrpSimplifierCollapse(&sim, &sim.pEdge[i], pass);
+            alive -= j;
+            removed += j;
+        }
+
+        if (removed == 0)
+        {
+            break;
+        }
+
+        /* Settle the indices and drop the triangles that degenerated */
+        for (t = 0; t < sim.numTriangles; t++)
+        {
+            pIndex = &sim.pIndex[t * 3];
+            if (pIndex[0] < 0)
+            {
+                continue;
+            }
+
+            for (j = 0; j < 3; j++)
+            {
+                pIndex[j] = SrpSimplifierFind(&sim, pIndex[j]);
+            }
+
+            if (pIndex[0] == pIndex[1] || pIndex[1] == pIndex[2] || 
+                pIndex[2] == pIndex[0])
+            {
+                pIndex[0] = -1;
+            }
+        }
+    }
+
+    /* Number the surviving vertices, reusing the pass marks */
+    numVertices = 0;
+    numTriangles = 0;
+    for (v = 0; v < sim.numVertices; v++)
+    {
+        sim.pMark[v] = -1;
+    }
+    for (t = 0; t < sim.numTriangles; t++)
+    {
+        pIndex = &sim.pIndex[t * 3];
+        if (pIndex[0] < 0)
+        {
+            continue;
+        }
+
+        numTriangles++;
+        for (j = 0; j < 3; j++)
+        {
+            if (sim.pMark[pIndex[j]] < 0)
+            {
+                sim.pMark[pIndex[j]] = numVertices++;
+            }
+        }
+    }
+
+    if (numTriangles > 0 && SrpNewModel(ppLod, numVertices, numTriangles))
+    {
+        pLod = *ppLod;
+        strcpy(pLod->name, pSrc->name);
+        pLod->radius = pSrc->radius;
+
+        for (v = 0; v < sim.numVertices; v++)
+        {
+            if (sim.pMark[v] >= 0)
+            {
+                SrpVectorCopy3f(pLod->pOldList[sim.pMark[v]], sim.pPos[v]);
+            }
+        }
+        memcpy(pLod->pNewList, pLod->pOldList, 
+               numVertices * sizeof(VECTOR3F));
+
+        pTri = pLod->pTriList;
+        for (t = 0; t < sim.numTriangles; t++)
+        {
+            pIndex = &sim.pIndex[t * 3];
+            if (pIndex[0] < 0)
+            {
+                continue;
+            }
+
+            pTri->state = TRIANGLE_STATE_ACTIVE;
+            pTri->attr = pSrc->pTriList[t].attr;
+            pTri->pList = pLod->pNewList;
+            for (j = 0; j < 3; j++)
+            {
+                pTri->index[j] = sim.pMark[pIndex[j]];
+            }
+            pTri++;
+        }
+
+        ret = TRUE;
+    }
+
+    IgFreeMemory(pBlock);
+    return ret;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpBuildModelLods(MODEL *pModel)
+ *
+ * Generate the chain of coarser levels of detail of a model, each one
+ * with about half the triangles of the previous one.
+ */
+static void SrpBuildModelLods(MODEL *pModel)
+{
+    int level, target;
+    MODEL *pCur;
+
+    ASSERTMSG(pModel != NULL, "SrpBuildModelLods: invalid argument.");
+
+    pCur = pModel;
+    for (level = 1; level < MODEL_MAX_LODS; level++)
+    {
+        target = (int)(pCur->numTriangles * MODEL_LOD_RATIO);
+        if (target < MODEL_LOD_MIN_TRIANGLES)
+        {
+            break;
+        }
+
+        if (!SrpSimplifyModel(&pCur->pLod, pCur, target))
+        {
+            pCur->pLod = NULL;
+            break;
+        }
+
+        /* Not worth a level if the simplification got stuck early */
+        if (pCur->pLod->numTriangles > 
+            pCur->numTriangles * MODEL_LOD_MIN_REDUCTION)
+        {
+            SrpModelRelease(pCur->pLod);
+            pCur->pLod = NULL;
+            break;
+        }
+
+        pCur = pCur->pLod;
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpBuildModelMeshlets(MODEL *pModel)
+ *
+ * Partition a model into meshlets. Triangles are grown into a meshlet 
+ * from a seed through shared vertices, until the vertex or triangle 
+ * budget is used up. Vertices and triangles are then reordered so that
+ * each meshlet owns a contiguous range of both, vertices on the border 
+ * of two meshlets are duplicated.
+ *
+ * Return:
+ *     TRUE if successful; otherwise, FALSE.
+ */
+static int SrpBuildModelMeshlets(MODEL *pModel)
+{
+    int i, j, k, t, v, seed, head, tail, fresh, size, ret;
+    int numVertices, numTriangles, numMeshlets, newNumVertices;
+    int *pStart, *pList, *pIndex, *pOwner, *pSlot, *pQueued, *pQueue;
+    int *pTriMeshlet, *pTriOrder, *pVertexOrder, *pNewIndex;
+    byte *pBlock;
+    MESHLET *pMeshlet, *pTemp;
+    VECTOR3F *pOldList, *pNewList;
+    TRIANGLE *pTriList, *pTri;
+
+    ASSERTMSG(pModel != NULL, "SrpBuildModelMeshlets: invalid argument.");
+
+    numVertices = pModel->numVertices;
+    numTriangles = pModel->numTriangles;
+
+    size = numTriangles * sizeof(MESHLET) + 
+           (numVertices * 3 + 1 + numTriangles * 16) * sizeof(int);
+    if (!IgNewMemory((void **)&pBlock, size))
+    {
+        return FALSE;
+    }
+
+    pTemp        = (MESHLET *)pBlock;
+    pStart       = (int *)(pTemp + numTriangles);
+    pOwner       = pStart + numVertices + 1;
+    pSlot        = pOwner + numVertices;
+    pList        = pSlot + numVertices;
+    pIndex       = pList + numTriangles * 3;
+    pVertexOrder = pIndex + numTriangles * 3;
+    pNewIndex    = pVertexOrder + numTriangles * 3;
+    pQueued      = pNewIndex + numTriangles * 3;
+    pQueue       = pQueued + numTriangles;
+    pTriMeshlet  = pQueue + numTriangles;
+    pTriOrder    = pTriMeshlet + numTriangles;
+
+    for (t = 0; t < numTriangles; t++)
+    {
+        for (j = 0; j < 3; j++)
+        {
+            pIndex[t * 3 + j] = pModel->pTriList[t].index[j];
+        }
+        pQueued[t] = -1;
+        pTriMeshlet[t] = -1;
+    }
+    for (v = 0; v < numVertices; v++)
+    {
+        pOwner[v] = -1;
+    }
+    SrpBuildAdjacency(numVertices, numTriangles, pIndex, pStart, pList);
+
+    i = 0;
+    numMeshlets = 0;
+    newNumVertices = 0;
+    for (seed = 0; seed < numTriangles; seed++)
+    {
+        if (pTriMeshlet[seed] >= 0)
+        {
+            continue;
+        }
+
+        pMeshlet = &pTemp[numMeshlets];
+        pMeshlet->state = MESHLET_STATE_ACTIVE;
+        pMeshlet->firstVertex = newNumVertices;
+        pMeshlet->numVertices = 0;
+        pMeshlet->firstTriangle = i;
+        pMeshlet->numTriangles = 0;
+
+        head = 0;
+        tail = 0;
+        pQueue[tail++] = seed;
+        pQueued[seed] = numMeshlets;
+        while (head < tail && 
+               pMeshlet->numTriangles < MESHLET_MAX_TRIANGLES)
+        {
+            t = pQueue[head++];
+
+            fresh = 0;
+            for (j = 0; j < 3; j++)
+            {
+                if (pOwner[pIndex[t * 3 + j]] != numMeshlets)
+                {
+                    fresh++;
+                }
+            }
+
+            /* Leave it to a later meshlet if it doesn't fit */
+            if (pMeshlet->numVertices + fresh > MESHLET_MAX_VERTICES)
+            {
+                continue;
+            }
+
+            for (j = 0; j < 3; j++)
+            {
+                v = pIndex[t * 3 + j];
+                if (pOwner[v] != numMeshlets)
+                {
+                    pOwner[v] = numMeshlets;
+                    pSlot[v] = newNumVertices++;
+                    pVertexOrder[pSlot[v]] = v;
+                    pMeshlet->numVertices++;
+                }
+                pNewIndex[t * 3 + j] = pSlot[v];
+            }
+            pTriMeshlet[t] = numMeshlets;
+            pTriOrder[i++] = t;
+            pMeshlet->numTriangles++;
+
+            /* Grow through the vertices of the new triangle */
+            for (j = 0; j < 3; j++)
+            {
+                v = pIndex[t * 3 + j];
+                for (k = pStart[v]; k < pStart[v + 1]; k++)
+                {
+                    if (pTriMeshlet[pList[k]] < 0 && 
+                        pQueued[pList[k]] != numMeshlets)
+                    {
+                        pQueued[pList[k]] = numMeshlets;
+                        pQueue[tail++] = pList[k];
+                    }
+                }
+            }
+        }
+
+        numMeshlets++;
+    }
+
+    /* Rebuild the lists in meshlet order */
+    pMeshlet = NULL;
+    pOldList = NULL;
+    pNewList = NULL;
+    pTriList = NULL;
+    ret = IgNewMemory((void **)&pMeshlet, numMeshlets * sizeof(MESHLET)) && 
+          IgNewMemory((void **)&pOldList, newNumVertices * sizeof(VECTOR3F)) &&
+          IgNewMemory((void **)&pNewList, newNumVertices * sizeof(VECTOR3F)) &&
+          IgNewMemory((void **)&pTriList, numTriangles * sizeof(TRIANGLE));
+    if (!ret)
+    {
+        if (pMeshlet != NULL)
+        {
+            IgFreeMemory(pMeshlet);
+        }
+        if (pOldList != NULL)
+        {
+            IgFreeMemory(pOldList);
+        }
+        if (pNewList != NULL)
+        {
+            IgFreeMemory(pNewList);
+        }
+        IgFreeMemory(pBlock);
+        return FALSE;
+    }
+
+    memcpy(pMeshlet, pTemp, numMeshlets * sizeof(MESHLET));
+    for (v = 0; v < newNumVertices; v++)
+    {
+        SrpVectorCopy3f(pOldList[v], pModel->pOldList[pVertexOrder[v]]);
+    }
+    memcpy(pNewList, pOldList, newNumVertices * sizeof(VECTOR3F));
+
+    for (i = 0; i < numTriangles; i++)
+    {
+        t = pTriOrder[i];
+        pTri = &pTriList[i];
+        *pTri = pModel->pTriList[t];
+        pTri->pList = pNewList;
+        for (j = 0; j < 3; j++)
+        {
+            pTri->index[j] = pNewIndex[t * 3 + j];
+        }
+    }
+
+    IgFreeMemory(pModel->pOldList);
+    IgFreeMemory(pModel->pNewList);
+    IgFreeMemory(pModel->pTriList);
+    if (pModel->pMeshletList != NULL)
+    {
+        IgFreeMemory(pModel->pMeshletList);
+    }
+    if (pModel->pStream != NULL)
+    {
+        SrpDeleteVec3Stream(pModel->pStream);
+        SrpDeleteVec3Stream(pModel->pCamStream);
+        pModel->pStream = NULL;
+        pModel->pCamStream = NULL;
+    }
+
+    pModel->numVertices = newNumVertices;
+    pModel->pOldList = pOldList;
+    pModel->pNewList = pNewList;
+    pModel->pTriList = pTriList;
+    pModel->numMeshlets = numMeshlets;
+    pModel->pMeshletList = pMeshlet;
+
+    for (i = 0; i < numMeshlets; i++)
+    {
+        SrpCalculateMeshletBounds(pModel, &pMeshlet[i]);
+    }
+
+    IgFreeMemory(pBlock);
+
+    /* The vertices are final now, keep a copy of them as streams */
+    if (!SrpCreateVec3Stream(&pModel->pStream, newNumVertices))
+    {
+        return FALSE;
+    }
+    if (!SrpCreateVec3Stream(&pModel->pCamStream, newNumVertices))
+    {
+        SrpDeleteVec3Stream(pModel->pStream);
+        pModel->pStream = NULL;
+        return FALSE;
+    }
+    SrpVec3StreamLoad(pModel->pStream, pOldList);
+
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpCalculateMeshletBounds(const MODEL *pModel, MESHLET *pMeshlet)
+ *
+ * Calculate the bounding sphere and the normal cone of a meshlet. The 
+ * cone cutoff is the sine of the largest angle between the axis and a 
+ * triangle normal, 1 if the triangles face too many ways to be culled
+ * together.
+ */
+static void SrpCalculateMeshletBounds(const MODEL *pModel, MESHLET *pMeshlet)
+{
+    int i, j;
+    float length, minDot, curDot;
+    VECTOR3F minCorner, maxCorner, normal;
+    VECTOR3F *pVerList;
+    TRIANGLE *pTri;
+
+    ASSERTMSG(pModel != NULL && pMeshlet != NULL, 
+              "SrpCalculateMeshletBounds: invalid arguments.");
+
+    /* Sphere around the center of the bounding box */
+    pVerList = &pModel->pOldList[pMeshlet->firstVertex];
+    SrpVectorCopy3f(minCorner, pVerList[0]);
+    SrpVectorCopy3f(maxCorner, pVerList[0]);
+    for (i = 1; i < pMeshlet->numVertices; i++)
+    {
+        for (j = 0; j < 3; j++)
+        {
+            minCorner[j] = SrpMathMin(minCorner[j], pVerList[i][j]);
+            maxCorner[j] = SrpMathMax(maxCorner[j], pVerList[i][j]);
+        }
+    }
+    SrpVectorAdd3f(pMeshlet->center, minCorner, maxCorner);
+    SrpVectorScale3f(pMeshlet->center, pMeshlet->center, 0.5f);
+
+    pMeshlet->radius = 0.0f;
+    for (i = 0; i < pMeshlet->numVertices; i++)
+    {
+        pMeshlet->radius = SrpMathMax(pMeshlet->radius, 
+            SrpVectorDistanceSquared3f(pMeshlet->center, pVerList[i]));
+    }
+    pMeshlet->radius = sqrt(pMeshlet->radius);
+
+    /* Cone around the average of the unit normals */
+    pVerList = pModel->pOldList;
+    SrpVectorCopy3f(pMeshlet->coneAxis, ZERO_VECTOR);
+    for (i = 0; i < pMeshlet->numTriangles; i++)
+    {
+        pTri = &pModel->pTriList[pMeshlet->firstTriangle + i];
+        SrpVectorGetPlaneNormal3f(normal, pVerList[pTri->index[0]], 
+                                  pVerList[pTri->index[1]], 
+                                  pVerList[pTri->index[2]]);
+        length = SrpVectorLength3f(normal);
+        if (length > EPSILON_E6F)
+        {
+            SrpVectorScale3f(normal, normal, 1.0f / length);
+            SrpVectorAdd3f(pMeshlet->coneAxis, pMeshlet->coneAxis, normal);
+        }
+    }
+
+    pMeshlet->coneCutoff = 1.0f;
+    length = SrpVectorLength3f(pMeshlet->coneAxis);
+    if (length < EPSILON_E6F)
+    {
+        return;
+    }
+    SrpVectorScale3f(pMeshlet->coneAxis, pMeshlet->coneAxis, 1.0f / length);
+
+    minDot = 1.0f;
+    for (i = 0; i < pMeshlet->numTriangles; i++)
+    {
+        pTri = &pModel->pTriList[pMeshlet->firstTriangle + i];
+        SrpVectorGetPlaneNormal3f(normal, pVerList[pTri->index[0]], 
+                                  pVerList[pTri->index[1]], 
+                                  pVerList[pTri->index[2]]);
+        length = SrpVectorLength3f(normal);
+        if (length > EPSILON_E6F)
+        {
+            curDot = SrpVectorDotProduct3f(normal, pMeshlet->coneAxis) / 
+                     length;
+            minDot = SrpMathMin(minDot, curDot);
+        }
+    }
+
+    if (minDot > MESHLET_CONE_MIN_DOT)
+    {
+        pMeshlet->coneCutoff = sqrt(1.0f - minDot * minDot);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpResetModelState(MODEL *pModel)
+ *
+ * Reset the state of all triangles and meshlets of a model.
+ */
+static void SrpResetModelState(MODEL *pModel)
+{
+    int i;
+
+    ASSERTMSG(pModel->pTriList != NULL, 
+              "SrpResetModelState: invalid triangle list.");
+
+    for (i = 0; i < pModel->numTriangles; i++)
+    {
+        CLEAN_BIT(pModel->pTriList[i].state);
+    }
+
+    for (i = 0; i < pModel->numMeshlets; i++)
+    {
+        CLEAN_BIT(pModel->pMeshletList[i].state);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpResetObject(OBJECT *pObj)
+ *
+ * Reset object.
+ */
+static void SrpResetObjectState(OBJECT *pObj)
+{
+    MODEL *pModel;
+
+    ASSERTMSG(pObj != NULL, "SrpResetObjectState: invalid argument.");
+
+    pModel = pObj->pLodModel;
+    ASSERTMSG(pModel->pOldList != NULL, 
+              "SrpResetObjectState: invalid old vertex list.");
+    ASSERTMSG(pModel->pNewList != NULL, 
+              "SrpResetObjectState: invalid new vertex list.");
+
+    CLEAN_BIT(pObj->state);
+    pObj->planeMask = SrpRCGetCullPlaneMask();
+    SrpResetModelState(pModel);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpSetObjectLod(OBJECT *pObj, int lod)
+ *
+ * Make an object draw level lod of its model, or the coarsest level 
+ * there is if the chain is shorter.
+ */
+static void SrpSetObjectLod(OBJECT *pObj, int lod)
+{
+    int i;
+    MODEL *pModel;
+
+    ASSERTMSG(pObj != NULL && lod >= 0, "SrpSetObjectLod: invalid arguments.");
+
+    pModel = pObj->pModel;
+    for (i = 0; i < lod && pModel->pLod != NULL; i++)
+    {
+        pModel = pModel->pLod;
+    }
+
+    /* The triangle states of the new level are stale */
+    if (pModel != pObj->pLodModel)
+    {
+        pObj->pLodModel = pModel;
+        SrpResetModelState(pModel);
+    }
+    pObj->lod = i;
+}
+
+/*------------------------------------------------------------------------------
+ * float SrpGetObjectScreenRadius(const OBJECT *pObj, float depth)
+ *
+ * Get the radius in pixels an object is projected to, depth being 
+ * the distance of its center in front of the camera.
+ */
+static float SrpGetObjectScreenRadius(const OBJECT *pObj, float depth)
+{
+    float cotTheta;
+
+    cotTheta = 1.0f / SrpMathTanf(SrpMathDegToRadf(SrpRCGetFovy() / 2.0f));
+
+    return pObj->radius * cotTheta * (SrpRCGetWidth() - 1) * 0.5f / depth;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpSelectObjectLod(OBJECT *pObj, float depth)
+ *
+ * Pick the level of detail of an object from its projected radius in
+ * pixels, depth is the distance of its center along the view direction.
+ */
+static void SrpSelectObjectLod(OBJECT *pObj, float depth)
+{
+    int lod;
+    float screenRadius, threshold;
+    MODEL *pModel;
+
+    ASSERTMSG(pObj != NULL, "SrpSelectObjectLod: invalid arguments.");
+
+    /* Full detail when the camera is about to get into the object */
+    if (depth <= pObj->radius)
+    {
+        SrpSetObjectLod(pObj, 0);
+        return;
+    }
+
+    screenRadius = SrpGetObjectScreenRadius(pObj, depth);
+
+    /* Level lod is left for lod + 1 below OBJECT_LOD_PIXELS / 2^lod pixels.
+     * Each threshold has to be passed by some margin, so that an object 
+     * hovering around one doesn't keep popping.
+     */
+    lod = pObj->lod;
+    threshold = OBJECT_LOD_PIXELS / (float)(1 << lod);
+    pModel = pObj->pLodModel;
+    while (pModel->pLod != NULL && 
+           screenRadius < threshold * (1.0f - OBJECT_LOD_HYSTERESIS))
+    {
+        pModel = pModel->pLod;
+        lod++;
+        threshold *= 0.5f;
+    }
+    while (lod > 0 && 
+           screenRadius > threshold * 2.0f * (1.0f + OBJECT_LOD_HYSTERESIS))
+    {
+        lod--;
+        threshold *= 2.0f;
+    }
+
+    SrpSetObjectLod(pObj, lod);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpUpdateObjectMatrix(OBJECT *pObj)
+ *
+ * Rebuild the local to world matrix if the object has been moved, 
+ * then combine it with current modelview matrix once for all vertices.
+ */
+static void SrpUpdateObjectMatrix(OBJECT *pObj)
+{
+    int i;
+
+    ASSERTMSG(pObj != NULL, "SrpUpdateObjectMatrix: invalid argument.");
+
+    if (pObj->worldDirty)
+    {
+        /* Scale, rotate, then translate. Scaling first only scales 
+         * the rows of the rotation matrix.
+         */
+        SrpQuaternionToMatrix43f(pObj->world, pObj->orientation);
+        for (i = 0; i < 9; i++)
+        {
+            pObj->world[i] *= pObj->scale[i / 3];
+        }
+        SrpVectorCopy3f(&pObj->world[9], pObj->translation);
+
+        pObj->worldDirty = FALSE;
+    }
+
+    SrpMatrixMultiply43f(pObj->toCam, pObj->world, *SrpRCGetModelView());
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpCullObject(OBJECT *pObj)
+ *
+ * Object culling.
+ */
+static void SrpCullObject(OBJECT *pObj)
+{
+    VECTOR3F posT;
+
+    ASSERTMSG(pObj != NULL, "SrpCullObject: invalid argument.");
+
+    /* Object's postion in camera space is where its origin goes */
+    SrpVectorCopy3f(posT, &pObj->toCam[9]);
+
+    if (SrpRCCullSphere(posT, pObj->radius, &pObj->planeMask, 
+                        &pObj->cullPlane) == FRUSTUM_OUTSIDE)
+    {
+        SET_BIT(pObj->state, OBJECT_STATE_CULLED);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpCullSmallObject(OBJECT *pObj)
+ *
+ * Small object culling, for objects under SrpRCGetSmallPixels() in 
+ * diameter on screen. They are dropped, or marked to be drawn as a 
+ * point, before any work is done on their vertices.
+ */
+static void SrpCullSmallObject(OBJECT *pObj)
+{
+    float depth;
+
+    ASSERTMSG(pObj != NULL, "SrpCullSmallObject: invalid argument.");
+
+    if (pObj->state & OBJECT_STATE_CULLED)
+    {
+        return;
+    }
+
+    /* Never small when the camera is about to get into the object */
+    depth = -pObj->toCam[11];
+    if (depth <= pObj->radius || 
+        2.0f * SrpGetObjectScreenRadius(pObj, depth) >= SrpRCGetSmallPixels())
+    {
+        return;
+    }
+
+    if (SrpRCGetSmallMode() == SRP_SMALL_SPLAT)
+    {
+        SET_BIT(pObj->state, OBJECT_STATE_SMALL);
+    }
+    else
+    {
+        SET_BIT(pObj->state, OBJECT_STATE_CULLED);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpCullMeshlets(OBJECT *pObj)
+ *
+ * Meshlet culling, against the view frustum, and against the normal 
+ * cones too if back faces are culled and the object is scaled uniformly.
+ */
+static void SrpCullMeshlets(OBJECT *pObj)
+{
+    int i, coneTest, planeMask, lastPlane;
+    float maxScale, radius;
+    MODEL *pModel;
+    MESHLET *pMeshlet;
+    VECTOR3F center, tip, axis;
+
+    ASSERTMSG(pObj != NULL, "SrpCullMeshlets: invalid argument.");
+
+    /* Discard this object if it's been culled */
+    if (pObj->state & OBJECT_STATE_CULLED)
+    {
+        return;
+    }
+
+    pModel = pObj->pLodModel;
+
+    maxScale = SrpMathMax(fabsf(pObj->scale[0]), fabsf(pObj->scale[1]));
+    maxScale = SrpMathMax(maxScale, fabsf(pObj->scale[2]));
+
+    /* Normals only keep their directions under uniform scaling */
+    coneTest = SrpRCIsEnabled(SRP_CULL_FACE) && pObj->scale[0] > 0.0f && 
+               SrpMathFloatIsZero(pObj->scale[0] - pObj->scale[1]) && 
+               SrpMathFloatIsZero(pObj->scale[0] - pObj->scale[2]);
+
+    /* Neighbouring meshlets tend to be culled by the same plane */
+    lastPlane = pObj->cullPlane;
+
+    for (i = 0; i < pModel->numMeshlets; i++)
+    {
+        pMeshlet = &pModel->pMeshletList[i];
+
+        SrpMatrixTransformVector3f(center, pMeshlet->center, pObj->toCam);
+        radius = pMeshlet->radius * maxScale;
+
+        /* Only the planes the object crosses can cull a meshlet */
+        planeMask = pObj->planeMask;
+        if (SrpRCCullSphere(center, radius, &planeMask, &lastPlane) == 
+            FRUSTUM_OUTSIDE)
+        {
+            SET_BIT(pMeshlet->state, MESHLET_STATE_CULLED);
+            continue;
+        }
+
+        if (!coneTest || pMeshlet->coneCutoff >= 1.0f)
+        {
+            continue;
+        }
+
+        SrpVectorAdd3f(tip, pMeshlet->center, pMeshlet->coneAxis);
+        SrpMatrixTransformVector3f(axis, tip, pObj->toCam);
+        SrpVectorSubtract3f(axis, axis, center);
+        SrpVectorNormalize3f(axis, axis);
+
+        /* Every triangle faces away from the camera, which sits at 
+         * the origin of camera space.
+         */
+        if (SrpVectorDotProduct3f(center, axis) >= 
+            pMeshlet->coneCutoff * SrpVectorLength3f(center) + radius)
+        {
+            SET_BIT(pMeshlet->state, MESHLET_STATE_CULLED);
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpTransObjectLocToCam(OBJECT *pObj)
+ *
+ * Transfrom object from local space to camera space.
+ */
+static void SrpTransObjectLocToCam(OBJECT *pObj)
+{
+    int i, first, stream;
+    MODEL *pModel;
+    MESHLET *pMeshlet;
+    VEC3_STREAM loc, cam;
+
+    ASSERTMSG(pObj != NULL, 
+              "SrpTransObjectLocToCam: invalid arguments.");
+
+    pModel = pObj->pLodModel;
+    ASSERTMSG(pModel->pOldList != NULL, 
+              "SrpTransObjectLocToCam: invalid old vertex list.");
+    ASSERTMSG(pModel->pNewList != NULL, 
+              "SrpTransObjectLocToCam: invalid new vertex list.");
+
+    /* Discard this object if it's been culled */
+    if (pObj->state & OBJECT_STATE_CULLED)
+    {
+        return;
+    }
+
+    /* Only the vertices of the meshlets left are needed. With streams 
+     * the camera space ones are kept for clipping, and stored back into 
+     * pNewList for the triangles.
+     */
+    stream = SrpRCIsEnabled(SRP_VERTEX_STREAM);
+    for (i = 0; i < pModel->numMeshlets; i++)
+    {
+        pMeshlet = &pModel->pMeshletList[i];
+        if (pMeshlet->state & MESHLET_STATE_CULLED)
+        {
+            continue;
+        }
+
+        first = pMeshlet->firstVertex;
+        if (stream)
+        {
+            SrpVec3StreamView(&loc, pModel->pStream, 
+                              first, pMeshlet->numVertices);
+            SrpVec3StreamView(&cam, pModel->pCamStream, 
+                              first, pMeshlet->numVertices);
+            SrpVec3StreamTransform(&cam, &loc, pObj->toCam);
+            SrpVec3StreamStore(&pModel->pNewList[first], &cam);
+        }
+        else
+        {
+            SrpMatrixTransformVectors3f(&pModel->pNewList[first], 
+                                        &pModel->pOldList[first], 
+                                        pMeshlet->numVertices, pObj->toCam);
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpClipObject(OBJECT *pObj)
+ *
+ * Triangle clipping, the rasterizer expects every vertex on screen. 
+ * Triangles with all three vertices outside of the same plane are 
+ * dropped, and those crossing the frustum are marked to be clipped 
+ * against it when they're inserted into render list.
+ */
+static void SrpClipObject(OBJECT *pObj)
+{
+    int i, j, first, stream, code0, code1, code2;
+    int outcode[MESHLET_MAX_VERTICES];
+    MODEL *pModel;
+    MESHLET *pMeshlet;
+    TRIANGLE *pTri;
+    VEC3_STREAM cam;
+
+    ASSERTMSG(pObj != NULL, "SrpClipObject: invalid argument.");
 
-    /* Discard this object if it's been culled */
-    if (pObj->state & OBJECT_STATE_CULLED)
+    /* Discard this object if it's been culled, or there's nothing to clip
+     * if it's completely inside the frustum.
+     */
+    if (pObj->state & OBJECT_STATE_CULLED || pObj->planeMask == 0)
     {
         return;
     }
 
-    pModelView = SrpRCGetModelView();
-    for (i = 0; i < pModel->numVertices; i++)
+    pModel = pObj->pLodModel;
+    stream = SrpRCIsEnabled(SRP_VERTEX_STREAM);
+    for (i = 0; i < pModel->numMeshlets; i++)
     {
-        /* Scale it */
-        SrpVectorScaleIndie3f(scaledVec, pModel->pOldList[i], pObj->scale);
-
-        /* Rotate it */
-        SrpMatrixTransformVector3f(rotatedVec, scaledVec, pObj->rotation);
+        pMeshlet = &pModel->pMeshletList[i];
+        if (pMeshlet->state & MESHLET_STATE_CULLED)
+        {
+            continue;
+        }
 
-        /* Translate it */
-        SrpVectorAdd3f(translatedVec, rotatedVec, pObj->translation);
+        /* Meshlets own their vertices, test each of them only once, 
+         * against the planes the object isn't known to be inside.
+         */
+        first = pMeshlet->firstVertex;
+        if (stream)
+        {
+            SrpVec3StreamView(&cam, pModel->pCamStream, 
+                              first, pMeshlet->numVertices);
+            SrpRCGetOutcodeStream(&cam, pObj->planeMask, outcode);
+        }
+        else
+        {
+            SrpRCGetOutcodeArray(&pModel->pNewList[first], 
+                                 pMeshlet->numVertices, pObj->planeMask, 
+                                 outcode);
+        }
 
-        /* Transform it with current modelview matrix */
-        SrpMatrixTransformVector3f(transformedVec, translatedVec, *pModelView);
+        for (j = pMeshlet->firstTriangle; 
+             j < pMeshlet->firstTriangle + pMeshlet->numTriangles; j++)
+        {
+            pTri = &pModel->pTriList[j];
+            code0 = outcode[pTri->index[0] - first];
+            code1 = outcode[pTri->index[1] - first];
+            code2 = outcode[pTri->index[2] - first];
 
-        /* Store it */
-        SrpVectorCopy3f(pModel->pNewList[i], transformedVec);
+            if (code0 & code1 & code2)
+            {
+                SET_BIT(pTri->state, TRIANGLE_STATE_CLIPPED);
+            }
+            else if (code0 | code1 | code2)
+            {
+                SET_BIT(pTri->state, TRIANGLE_STATE_CROSSING);
+            }
+        }
     }
 }
 
@@ -280,15 +1799,16 @@ static void SrpTransObjectLocToCam(OBJECT *pObj)
  */
 static void SrpCullBackFace(OBJECT *pObj)
 {
-    int i, verIndex0, verIndex1, verIndex2;
+    int i, j, verIndex0, verIndex1, verIndex2;
     MODEL *pModel;
+    MESHLET *pMeshlet;
     TRIANGLE *pTri;
     VECTOR3F normal, view;
     VECTOR3F *pVerList;
 
     ASSERTMSG(pObj != NULL, "SrpCullBackFace: invalid argument.");
 
-    pModel = pObj->pModel;
+    pModel = pObj->pLodModel;
     ASSERTMSG(pModel->pOldList != NULL, 
               "SrpCullBackFace: invalid old vertex list.");
     ASSERTMSG(pModel->pNewList != NULL, 
@@ -303,31 +1823,42 @@ static void SrpCullBackFace(OBJECT *pObj)
     }
 
     pVerList = pModel->pNewList;
-    for (i = 0; i < pModel->numTriangles; i++)
+    for (i = 0; i < pModel->numMeshlets; i++)
     {
-        pTri = &pModel->pTriList[i];
-
-        /* Don't repeat yourself. */
-        if (pTri->state & TRIANGLE_STATE_CLIPPED || 
-            pTri->state & TRIANGLE_STATE_BACKFACE)
+        pMeshlet = &pModel->pMeshletList[i];
+        if (pMeshlet->state & MESHLET_STATE_CULLED)
         {
             continue;
         }
 
-        verIndex0 = pTri->index[0];
-        verIndex1 = pTri->index[1];
-        verIndex2 = pTri->index[2];
+        for (j = pMeshlet->firstTriangle; 
+             j < pMeshlet->firstTriangle + pMeshlet->numTriangles; j++)
+        {
+            pTri = &pModel->pTriList[j];
+
+            /* Don't repeat yourself. */
+            if (pTri->state & TRIANGLE_STATE_CLIPPED || 
+                pTri->state & TRIANGLE_STATE_BACKFACE)
+            {
+                continue;
+            }
 
-        SrpVectorGetPlaneNormal3f(normal, pVerList[verIndex0], 
-                                  pVerList[verIndex1], pVerList[verIndex2]);
+            verIndex0 = pTri->index[0];
+            verIndex1 = pTri->index[1];
+            verIndex2 = pTri->index[2];
 
-        /* Set the triangle's state backface if the dot product of
-         * its normal and view vector is negative.
-         */
-        SrpVectorSubtract3f(view, ZERO_VECTOR, pVerList[verIndex0]);
-        if (SrpVectorDotProduct3f(normal, view) <= 0.0f)
-        {
-            SET_BIT(pTri->state, TRIANGLE_STATE_BACKFACE);
+            SrpVectorGetPlaneNormal3f(normal, pVerList[verIndex0], 
+                                      pVerList[verIndex1], 
+                                      pVerList[verIndex2]);
+
+            /* Set the triangle's state backface if the dot product of
+             * its normal and view vector is negative.
+             */
+            SrpVectorSubtract3f(view, ZERO_VECTOR, pVerList[verIndex0]);
+            if (SrpVectorDotProduct3f(normal, view) <= 0.0f)
+            {
+                SET_BIT(pTri->state, TRIANGLE_STATE_BACKFACE);
+            }
         }
     }
 }
@@ -340,16 +1871,18 @@ static void SrpCullBackFace(OBJECT *pObj)
  */
 static void SrpInsertObjectToRenderList(const OBJECT *pObj, RENDER_LIST *pRl)
 {
-    int i, verIndex0, verIndex1, verIndex2;
+    int i, j, k, numVerts, verIndex0, verIndex1, verIndex2;
     MODEL *pModel;
+    MESHLET *pMeshlet;
     TRIANGLE *pTri;
     TRIANGLE_INDIE *pTriIndie;
     VECTOR3F *pVerList;
+    VECTOR3F poly[FRUSTUM_MAX_CLIP_VERTICES];
 
     ASSERTMSG(pObj != NULL && pRl != NULL, 
               "SrpInsertObjectToRenderList: invalid argument.");
 
-    pModel = pObj->pModel;
+    pModel = pObj->pLodModel;
     ASSERTMSG(pModel->pOldList != NULL, 
               "SrpInsertObjectToRenderList: invalid old vertex list.");
     ASSERTMSG(pModel->pNewList != NULL, 
@@ -371,35 +1904,95 @@ failed.\n");
     }
 
     pVerList = pModel->pNewList;
-    for (i = 0; i < pModel->numTriangles; i++)
+    for (i = 0; i < pModel->numMeshlets; i++)
     {
-        pTri = &pModel->pTriList[i];
-        /* Discard this triangle if it's clipped or backfaced */
-        if (pTri->state & TRIANGLE_STATE_CLIPPED || 
-            pTri->state & TRIANGLE_STATE_BACKFACE)
+        pMeshlet = &pModel->pMeshletList[i];
+        if (pMeshlet->state & MESHLET_STATE_CULLED)
         {
             continue;
         }
 
-        /* Initialize a self-contained triangle from
-         * the object's building triangle.
-         */
-        SrpSetTriIndieAttr(pTriIndie, pTri->attr);
+        for (j = pMeshlet->firstTriangle; 
+             j < pMeshlet->firstTriangle + pMeshlet->numTriangles; j++)
+        {
+            pTri = &pModel->pTriList[j];
+            /* Discard this triangle if it's clipped or backfaced */
+            if (pTri->state & TRIANGLE_STATE_CLIPPED || 
+                pTri->state & TRIANGLE_STATE_BACKFACE)
+            {
+                continue;
+            }
 
-        /* pTri->pList and pModel->pNewList should point to
-         * the same address even if pTri->pList has not
-         * been initialized.
-         */
-        verIndex0 = pTri->index[0];
-        verIndex1 = pTri->index[1];
-        verIndex2 = pTri->index[2];
-        SrpSetTriIndieVertex(pTriIndie, pVerList[verIndex0], 
-                            pVerList[verIndex1], pVerList[verIndex2]);
+            /* Initialize a self-contained triangle from
+             * the object's building triangle.
+             */
+            SrpSetTriIndieAttr(pTriIndie, pTri->attr);
+
+            /* pTri->pList and pModel->pNewList should point to
+             * the same address even if pTri->pList has not
+             * been initialized.
+             */
+            verIndex0 = pTri->index[0];
+            verIndex1 = pTri->index[1];
+            verIndex2 = pTri->index[2];
+
+            if (!(pTri->state & TRIANGLE_STATE_CROSSING))
+            {
+                SrpSetTriIndieVertex(pTriIndie, pVerList[verIndex0], 
+                                     pVerList[verIndex1], 
+                                     pVerList[verIndex2]);
+
+                /* Insert the self-contained triangle into render list */
+                SrpInsertTriangleToRenderList(pTriIndie, pRl);
+                continue;
+            }
+
+            /* Clip it and insert what's left as a fan of triangles */
+            SrpVectorCopy3f(poly[0], pVerList[verIndex0]);
+            SrpVectorCopy3f(poly[1], pVerList[verIndex1]);
+            SrpVectorCopy3f(poly[2], pVerList[verIndex2]);
+            numVerts = SrpRCClipTriangle(poly, pObj->planeMask);
+            for (k = 1; k < numVerts - 1; k++)
+            {
+                SrpSetTriIndieVertex(pTriIndie, poly[0], poly[k], poly[k + 1]);
+                SrpInsertTriangleToRenderList(pTriIndie, pRl);
+            }
+        }
+    }
+
+    SrpDeleteTriIndie(pTriIndie);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpInsertObjectSplat(const OBJECT *pObj, RENDER_LIST *pRl)
+ *
+ * Insert a small object into render list as a single point, a triangle 
+ * with its three vertices at the object's center, in camera space.
+ */
+static void SrpInsertObjectSplat(const OBJECT *pObj, RENDER_LIST *pRl)
+{
+    TRIANGLE_INDIE *pTriIndie;
+    const float *center;
+
+    ASSERTMSG(pObj != NULL && pRl != NULL, 
+              "SrpInsertObjectSplat: invalid argument.");
+
+    /* It's less than a pixel off the frustum if not in it, just drop it */
+    center = &pObj->toCam[9];
+    if (!SrpRCIsInside(center))
+    {
+        return;
+    }
 
-        /* Insert the self-contained triangle into render list */
-        SrpInsertTriangleToRenderList(pTriIndie, pRl);
+    if (!SrpCreateTriIndie(&pTriIndie, center, center, center))
+    {
+        printf("Error: SrpInsertObjectSplat create TRIANGLE_INDIE failed.\n");
+        return;
     }
 
+    SrpSetTriIndieAttr(pTriIndie, pObj->pLodModel->pTriList[0].attr);
+    SrpInsertTriangleToRenderList(pTriIndie, pRl);
+
     SrpDeleteTriIndie(pTriIndie);
 }
 
@@ -420,10 +2013,6 @@ int SrpCreateObject(OBJECT **ppObj, MODEL *pModel,
                     float directionX, float directionY, float directionZ, 
                     float scaleX, float scaleY, float scaleZ)
 {
-    OBJECT *pObj;
-    float maxScale;
-    MATRIX43F rotMat, tempMat;
-
     ASSERTMSG(ppObj != NULL && pModel != NULL, 
               "SrpCreateObject: invalid arguments.");
 
@@ -433,10 +2022,39 @@ int SrpCreateObject(OBJECT **ppObj, MODEL *pModel,
         return FALSE;
     }
 
-    pObj = *ppObj;
+    SrpInitObject(*ppObj, pModel, positionX, positionY, positionZ, 
+                  directionX, directionY, directionZ, scaleX, scaleY, scaleZ);
+
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpInitObject(OBJECT *pObj, MODEL *pModel, 
+ *                    float positionX, float positionY, float positionZ, 
+ *                    float directionX, float directionY, float directionZ, 
+ *                    float scaleX, float scaleY, float scaleZ)
+ *
+ * Initialize object in memory of SrpGetObjectSize() bytes provided by 
+ * the caller, e.g. an object pool.
+ */
+void SrpInitObject(OBJECT *pObj, MODEL *pModel, 
+                   float positionX, float positionY, float positionZ, 
+                   float directionX, float directionY, float directionZ, 
+                   float scaleX, float scaleY, float scaleZ)
+{
+    float maxScale;
+
+    ASSERTMSG(pObj != NULL && pModel != NULL, 
+              "SrpInitObject: invalid arguments.");
+
     pObj->pModel = pModel;
+    pObj->pLodModel = pModel;
+    pObj->lod = 0;
     strcpy(pObj->name, pModel->name);
     pObj->state = OBJECT_STATE_ACTIVE;
+    pObj->planeMask = FRUSTUM_PLANES_ALL;
+    pObj->cullPlane = 0;
+    pObj->pEntry = NULL;
 
     /* Take the largest scale factor and use it to scale the radius */
     maxScale = SrpMathMax(scaleX, scaleY);
@@ -449,32 +2067,74 @@ int SrpCreateObject(OBJECT **ppObj, MODEL *pModel,
 
     SrpVectorCopy3f(pObj->translation, pObj->pos);
     SrpVectorCopy3f(pObj->scale, pObj->sca);
+    pObj->worldDirty = TRUE;
 
-    /* Make the rotation matrix, with YXZ sequence */
-    SrpMatrixLoadIdentity43f(pObj->rotation);
-    if (!SrpMathFloatIsZero(directionY))
-    {
-        SrpMatrixMakeRotation43f(rotMat, CARDINAL_Y, 
-                                 SrpMathDegToRadf(directionY));
-        SrpMatrixMultiply43f(tempMat, rotMat, pObj->rotation);
-        SrpMatrixCopy43f(pObj->rotation, tempMat);
-    }
-    if (!SrpMathFloatIsZero(directionX))
-    {
-        SrpMatrixMakeRotation43f(rotMat, CARDINAL_X, 
-                                 SrpMathDegToRadf(directionX));
-        SrpMatrixMultiply43f(tempMat, rotMat, pObj->rotation);
-        SrpMatrixCopy43f(pObj->rotation, tempMat);
-    }
-    if (!SrpMathFloatIsZero(directionZ))
+    /* Orientation with YXZ sequence */
+    SrpQuaternionMakeEuler(pObj->orientation, SrpMathDegToRadf(directionX),
+                           SrpMathDegToRadf(directionY), 
+                           SrpMathDegToRadf(directionZ));
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpGetObjectSize(void)
+ *
+ * Get the size of an object in bytes.
+ */
+int SrpGetObjectSize(void)
+{
+    return sizeof(OBJECT);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpSetObjectModel(OBJECT *pObj, MODEL *pModel)
+ *
+ * Make an object use another model, e.g. the real one once it's been 
+ * loaded in place of a stand-in.
+ */
+void SrpSetObjectModel(OBJECT *pObj, MODEL *pModel)
+{
+    float maxScale;
+
+    ASSERTMSG(pObj != NULL && pModel != NULL, 
+              "SrpSetObjectModel: invalid arguments.");
+
+    pObj->pModel = pModel;
+    pObj->pLodModel = pModel;
+    pObj->lod = 0;
+    strcpy(pObj->name, pModel->name);
+
+    maxScale = SrpMathMax(pObj->sca[0], pObj->sca[1]);
+    maxScale = SrpMathMax(maxScale, pObj->sca[2]);
+    pObj->radius = pModel->radius * maxScale;
+
+    if (pObj->pEntry != NULL)
     {
-        SrpMatrixMakeRotation43f(rotMat, CARDINAL_Z, 
-                                 SrpMathDegToRadf(directionZ));
-        SrpMatrixMultiply43f(tempMat, rotMat, pObj->rotation);
-        SrpMatrixCopy43f(pObj->rotation, tempMat);
+        SrpOctreeUpdateObject(pObj);
     }
+}
 
-    return TRUE;
+/*------------------------------------------------------------------------------
+ * void SrpSetObjectEntry(OBJECT *pObj, OCTREE_ENTRY *pEntry)
+ *
+ * Set where an object is in an octree, for the octree only.
+ */
+void SrpSetObjectEntry(OBJECT *pObj, OCTREE_ENTRY *pEntry)
+{
+    ASSERTMSG(pObj != NULL, "SrpSetObjectEntry: invalid arguments.");
+
+    pObj->pEntry = pEntry;
+}
+
+/*------------------------------------------------------------------------------
+ * OCTREE_ENTRY *SrpGetObjectEntry(const OBJECT *pObj)
+ *
+ * Get where an object is in an octree, NULL if in none.
+ */
+OCTREE_ENTRY *SrpGetObjectEntry(const OBJECT *pObj)
+{
+    ASSERTMSG(pObj != NULL, "SrpGetObjectEntry: invalid arguments.");
+
+    return pObj->pEntry;
 }
 
 /*------------------------------------------------------------------------------
@@ -486,6 +2146,11 @@ void SrpDeleteObject(OBJECT *pObj)
 {
     ASSERTMSG(pObj != NULL, "SrpDeleteObject: invalid arguments.");
 
+    if (pObj->pEntry != NULL)
+    {
+        SrpOctreeRemoveObject(pObj);
+    }
+
     IgFreeMemory(pObj);
 }
 
@@ -503,6 +2168,12 @@ void SrpTranslateObject(OBJECT *pObj, float x, float y, float z)
 
     SrpVectorLoad3f(translation, x, y, z);
     SrpVectorAdd3f(pObj->translation, pObj->pos, translation);
+    pObj->worldDirty = TRUE;
+
+    if (pObj->pEntry != NULL)
+    {
+        SrpOctreeUpdateObject(pObj);
+    }
 }
 
 /*------------------------------------------------------------------------------
@@ -513,7 +2184,6 @@ void SrpTranslateObject(OBJECT *pObj, float x, float y, float z)
  */
 void SrpRotateObject(OBJECT *pObj, float x, float y, float z)
 {
-    MATRIX43F rotMat, tempMat;
     VECTOR3F deltaDir;    /* vector(x, y, z) */
     VECTOR3F rotation;    /* pObj->dir + deltaDir */
 
@@ -521,36 +2191,40 @@ void SrpRotateObject(OBJECT *pObj, float x, float y, float z)
 
     SrpVectorLoad3f(deltaDir, x, y, z);
 
-    /* Make the rotation matrix, with YXZ sequence */
+    /* Make the orientation, with YXZ sequence */
     if (!SrpVectorIsZero3f(deltaDir))
     {
         SrpVectorAdd3f(rotation, pObj->dir, deltaDir);
+        SrpQuaternionMakeEuler(pObj->orientation, 
+                               SrpMathDegToRadf(rotation[0]),
+                               SrpMathDegToRadf(rotation[1]), 
+                               SrpMathDegToRadf(rotation[2]));
 
-        SrpMatrixLoadIdentity43f(pObj->rotation);
-        if (!SrpMathFloatIsZero(deltaDir[1]))
-        {
-            SrpMatrixMakeRotation43f(rotMat, CARDINAL_Y, 
-                                     SrpMathDegToRadf(rotation[1]));
-            SrpMatrixMultiply43f(tempMat, rotMat, pObj->rotation);
-            SrpMatrixCopy43f(pObj->rotation, tempMat);
-        }
-        if (!SrpMathFloatIsZero(deltaDir[0]))
-        {
-            SrpMatrixMakeRotation43f(rotMat, CARDINAL_X, 
-                                     SrpMathDegToRadf(rotation[0]));
-            SrpMatrixMultiply43f(tempMat, rotMat, pObj->rotation);
-            SrpMatrixCopy43f(pObj->rotation, tempMat);
-        }
-        if (!SrpMathFloatIsZero(deltaDir[2]))
-        {
-            SrpMatrixMakeRotation43f(rotMat, CARDINAL_Z, 
-                                     SrpMathDegToRadf(rotation[2]));
-            SrpMatrixMultiply43f(tempMat, rotMat, pObj->rotation);
-            SrpMatrixCopy43f(pObj->rotation, tempMat);
-        }
+        pObj->worldDirty = TRUE;
     }
 }
 
+/*------------------------------------------------------------------------------
+ * void SrpTurnObject(OBJECT *pObj, const VECTOR3F axis, float angle)
+ *
+ * Turn Object incrementally, by angle degrees about axis in its 
+ * local space, on top of the current orientation.
+ */
+void SrpTurnObject(OBJECT *pObj, const VECTOR3F axis, float angle)
+{
+    QUATERNION turn;
+
+    ASSERTMSG(pObj != NULL, "SrpTurnObject: invalid arguments.");
+
+    SrpQuaternionMakeRotation(turn, axis, SrpMathDegToRadf(angle));
+    SrpQuaternionMultiply(pObj->orientation, pObj->orientation, turn);
+
+    /* Keep rounding errors from building up over many turns */
+    SrpQuaternionNormalize(pObj->orientation, pObj->orientation);
+
+    pObj->worldDirty = TRUE;
+}
+
 /*------------------------------------------------------------------------------
  * void SrpScaleObject(OBJECT *pObj, float x, float y, float z)
  *
@@ -565,6 +2239,33 @@ void SrpScaleObject(OBJECT *pObj, float x, float y, float z)
 
     SrpVectorLoad3f(scale, x, y, z);
     SrpVectorScaleIndie3f(pObj->scale, pObj->sca, scale);
+    pObj->worldDirty = TRUE;
+
+    if (pObj->pEntry != NULL)
+    {
+        SrpOctreeUpdateObject(pObj);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpGetObjectBounds(const OBJECT *pObj, VECTOR3F center, 
+ *                         float *pRadius)
+ *
+ * Get the bounding sphere of an object in its parent space, i.e. where
+ * it's been translated to, with its current scale.
+ */
+void SrpGetObjectBounds(const OBJECT *pObj, VECTOR3F center, float *pRadius)
+{
+    float maxScale;
+
+    ASSERTMSG(pObj != NULL && pRadius != NULL, 
+              "SrpGetObjectBounds: invalid arguments.");
+
+    maxScale = SrpMathMax(fabsf(pObj->scale[0]), fabsf(pObj->scale[1]));
+    maxScale = SrpMathMax(maxScale, fabsf(pObj->scale[2]));
+
+    SrpVectorCopy3f(center, pObj->translation);
+    *pRadius = pObj->pModel->radius * maxScale;
 }
 
 /*------------------------------------------------------------------------------
@@ -576,15 +2277,47 @@ void SrpDrawObject(OBJECT *pObj, RENDER_LIST *pRl)
 {
     ASSERTMSG(pObj != NULL && pRl != NULL, "SrpDrawObject: invalid arguments.");
 
+    if (!SrpRCIsEnabled(SRP_LOD_OBJECT))
+    {
+        SrpSetObjectLod(pObj, 0);
+    }
+
     SrpResetObjectState(pObj);
 
+    SrpUpdateObjectMatrix(pObj);
+
     if (SrpRCIsEnabled(SRP_CULL_OBJECT))
     {
         SrpCullObject(pObj);
     }
 
+    /* Level of detail from the depth of the object's origin */
+    if (SrpRCIsEnabled(SRP_LOD_OBJECT) && 
+        !(pObj->state & OBJECT_STATE_CULLED))
+    {
+        SrpSelectObjectLod(pObj, -pObj->toCam[11]);
+    }
+
+    /* Small objects skip the vertices altogether */
+    if (SrpRCIsEnabled(SRP_CULL_SMALL))
+    {
+        SrpCullSmallObject(pObj);
+        if (pObj->state & OBJECT_STATE_SMALL)
+        {
+            SrpInsertObjectSplat(pObj, pRl);
+            return;
+        }
+    }
+
+    if (SrpRCIsEnabled(SRP_CULL_MESHLET))
+    {
+        SrpCullMeshlets(pObj);
+    }
+
     SrpTransObjectLocToCam(pObj);
 
+    SrpClipObject(pObj);
+
     if (SrpRCIsEnabled(SRP_CULL_FACE))
     {
         SrpCullBackFace(pObj);
@@ -606,7 +2339,7 @@ void SrpPrintObject(const OBJECT *pObj)
 
     ASSERTMSG(pObj != NULL, "SrpPrintObject: invalid argument.");
 
-    pModel = pObj->pModel;
+    pModel = pObj->pLodModel;
     ASSERTMSG(pModel->pTriList != NULL, 
               "SrpPrintObject: invalid triangle list.");
 
@@ -615,8 +2348,9 @@ void SrpPrintObject(const OBJECT *pObj)
     SrpVectorPrint3f(pObj->pos, "Position");
     SrpVectorPrint3f(pObj->dir, "Direction");
     SrpVectorPrint3f(pObj->sca, "Scale");
-    SrpMatrixPrint43f(pObj->rotation, "Rotation");
+    SrpQuaternionPrint(pObj->orientation, "Orientation");
 
+    printf("\n\tLevel of detail: %d\n", pObj->lod);
     printf("\n\tNumber of Triangles: %d\n", pModel->numTriangles);
     for (i = 0; i < pModel->numTriangles; i++)
     {
@@ -643,7 +2377,7 @@ int SrpModelLoadPLG(MODEL **ppModel, const char *fileName)
     int polyNumVerts; /* Discarded, should be always 3 */
     int i, sizeVertex, sizeTriangle;
     TRIANGLE *pTri;
-    MODEL *pModel;
+    MODEL *pModel, *pLevel;
 
     ASSERTMSG(ppModel != NULL && fileName != NULL, 
               "SrpModelLoadPLG: invalid arguments.");
@@ -661,6 +2395,12 @@ int SrpModelLoadPLG(MODEL **ppModel, const char *fileName)
     }
     pModel = *ppModel;
 
+    pModel->numMeshlets = 0;
+    pModel->pMeshletList = NULL;
+    pModel->pStream = NULL;
+    pModel->pCamStream = NULL;
+    pModel->pLod = NULL;
+
     /* Read in the model info */
     if (!SrpGetLine(buffer, 255, fp))
     {
@@ -727,24 +2467,136 @@ int SrpModelLoadPLG(MODEL **ppModel, const char *fileName)
         }
 
         pTri = &pModel->pTriList[i];
-        sscanf(buffer, "%s %d %d %d %d", triDesp, &polyNumVerts, 
-               &pTri->index[0], &pTri->index[1], &pTri->index[2]);
+        if (sscanf(buffer, "%s %d %d %d %d", triDesp, &polyNumVerts, 
+                   &pTri->index[0], &pTri->index[1], &pTri->index[2]) != 5)
+        {
+            printf("Error: invalid triangle list in file \"%s\".\n", fileName);
+            return FALSE;
+        }
+
+        /* Vertices are indexed with them from here on */
+        if (pTri->index[0] < 0 || pTri->index[0] >= pModel->numVertices || 
+            pTri->index[1] < 0 || pTri->index[1] >= pModel->numVertices || 
+            pTri->index[2] < 0 || pTri->index[2] >= pModel->numVertices)
+        {
+            printf("Error: invalid vertex index in file \"%s\".\n", fileName);
+            return FALSE;
+        }
         pTri->state = TRIANGLE_STATE_ACTIVE;
     }
 
     fclose(fp);
+
+    /* Generate the coarser levels of detail */
+    SrpBuildModelLods(pModel);
+
+    /* Partition every level into meshlets */
+    for (pLevel = pModel; pLevel != NULL; pLevel = pLevel->pLod)
+    {
+        if (!SrpBuildModelMeshlets(pLevel))
+        {
+            SrpModelRelease(pModel);
+            printf("Error: meshlet partition failed in loading file.\n");
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpModelCreateBox(MODEL **ppModel, const VECTOR3F minCorner, 
+ *                       const VECTOR3F maxCorner)
+ *
+ * Create an axis aligned box model, e.g. as a stand-in while the real 
+ * model is being loaded.
+ */
+int SrpModelCreateBox(MODEL **ppModel, const VECTOR3F minCorner, 
+                      const VECTOR3F maxCorner)
+{
+    /* Bit 0, 1 and 2 of a corner's number pick the max x, y and z.
+     * Triangles wind counter-clockwise seen from outside.
+     */
+    static const int s_boxIndex[12][3] = 
+    {
+        {0, 2, 1}, {1, 2, 3}, {4, 5, 6}, {5, 7, 6}, 
+        {0, 4, 2}, {2, 4, 6}, {1, 3, 5}, {3, 7, 5}, 
+        {0, 1, 4}, {1, 5, 4}, {2, 6, 3}, {3, 6, 7}
+    };
+
+    int i, j;
+    MODEL *pModel;
+    TRIANGLE *pTri;
+
+    ASSERTMSG(ppModel != NULL && minCorner != NULL && maxCorner != NULL, 
+              "SrpModelCreateBox: invalid arguments.");
+
+    if (!SrpNewModel(ppModel, 8, 12))
+    {
+        printf("Error: create model failed.\n");
+        return FALSE;
+    }
+    pModel = *ppModel;
+    strcpy(pModel->name, "box");
+
+    for (i = 0; i < 8; i++)
+    {
+        for (j = 0; j < 3; j++)
+        {
+            pModel->pOldList[i][j] = (i & (1 << j)) ? maxCorner[j] : 
+                                                      minCorner[j];
+        }
+    }
+    memcpy(pModel->pNewList, pModel->pOldList, 8 * sizeof(VECTOR3F));
+    SrpCalculateModelRadius(pModel);
+
+    for (i = 0; i < 12; i++)
+    {
+        pTri = &pModel->pTriList[i];
+        pTri->state = TRIANGLE_STATE_ACTIVE;
+        pTri->attr = 0;
+        pTri->pList = pModel->pNewList;
+        for (j = 0; j < 3; j++)
+        {
+            pTri->index[j] = s_boxIndex[i][j];
+        }
+    }
+
+    if (!SrpBuildModelMeshlets(pModel))
+    {
+        SrpModelRelease(pModel);
+        printf("Error: meshlet partition failed in creating model.\n");
+        return FALSE;
+    }
+
     return TRUE;
 }
 
 /*------------------------------------------------------------------------------
  * void SrpModelRelease(MODEL *pModel)
  *
- * Release model.
+ * Release model, along with its chain of levels of detail.
  */
 void SrpModelRelease(MODEL *pModel)
 {
     ASSERTMSG(pModel != NULL, "SrpModelRelease: invalid arguments.");
 
+    if (pModel->pLod != NULL)
+    {
+        SrpModelRelease(pModel->pLod);
+    }
+
+    if (pModel->pMeshletList != NULL)
+    {
+        IgFreeMemory(pModel->pMeshletList);
+    }
+
+    if (pModel->pStream != NULL)
+    {
+        SrpDeleteVec3Stream(pModel->pStream);
+        SrpDeleteVec3Stream(pModel->pCamStream);
+    }
+
     IgFreeMemory(pModel->pOldList);
     IgFreeMemory(pModel->pNewList);
     IgFreeMemory(pModel->pTriList);
@@ -760,3 +2612,42 @@ float SrpModelGetRadius(const MODEL *pModel)
 {
     return (pModel->radius);
 }
+
+/*------------------------------------------------------------------------------
+ * void SrpModelAttachLod(MODEL *pModel, MODEL *pLod)
+ *
+ * Replace the generated levels of detail of a model with a hand made 
+ * chain, pLod and its own coarser levels. The model takes ownership of 
+ * pLod. Should be called before any object is created from the model.
+ */
+void SrpModelAttachLod(MODEL *pModel, MODEL *pLod)
+{
+    ASSERTMSG(pModel != NULL && pLod != NULL && pModel != pLod, 
+              "SrpModelAttachLod: invalid arguments.");
+
+    if (pModel->pLod != NULL)
+    {
+        SrpModelRelease(pModel->pLod);
+    }
+
+    pModel->pLod = pLod;
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpModelGetNumLods(const MODEL *pModel)
+ *
+ * Get the number of levels of detail of a model, itself included.
+ */
+int SrpModelGetNumLods(const MODEL *pModel)
+{
+    int num;
+
+    ASSERTMSG(pModel != NULL, "SrpModelGetNumLods: invalid argument.");
+
+    for (num = 1; pModel->pLod != NULL; num++)
+    {
+        pModel = pModel->pLod;
+    }
+
+    return num;
+}
@@ -0,0 +1,523 @@
+/*******************************************************************************
+ * File   : octree_srp.c
+ * Content: Loose octree of objects
+ *
+ * Coder  : Ean Jee
+ * Time   : 2026-10-19 15:16
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <math.h>
+#include "datadef_ig.h"
+#include "assert_ig.h"
+#include "malloc_ig.h"
+#include "datadef_srp.h"
+#include "vector_srp.h"
+#include "frustum_srp.h"
+#include "rcmanager_srp.h"
+#include "octree_srp.h"
+
+/*----------------------------------------------------------------------------*/
+/*                               Data Structure                               */
+/*----------------------------------------------------------------------------*/
+
+#define OCTREE_MAX_DEPTH          10
+#define OCTREE_LOOSENESS          2.0f  /* Node bounds over its cell size */
+#define OCTREE_SQRT3              1.7320508f
+
+/*
+ * A node owns a cubic cell, and holds the objects whose centers are in
+ * the cell and which are too large for a child. With the bounds of a
+ * node loosened to twice its cell, such an object never sticks out.
+ */
+struct OCTREE_NODE_T
+{
+    struct OCTREE_NODE_T *pParent;
+    struct OCTREE_NODE_T *pChildren[8]; /* NULL until an object goes there */
+
+    VECTOR3F center;          /* Center of the cell */
+    float halfSize;           /* Half the edge of the cell */
+    int depth;
+
+    int numObjects;           /* Objects in the subtree */
+    OCTREE_ENTRY *pFirstEntry;
+
+    int cullPlane;            /* Frustum plane which culled it last time */
+};
+
+typedef struct OCTREE_NODE_T OCTREE_NODE;
+
+struct OCTREE_ENTRY_T
+{
+    OBJECT *pObj;
+    OCTREE *pTree;
+    OCTREE_NODE *pNode;
+
+    OCTREE_ENTRY *pPrev;
+    OCTREE_ENTRY *pNext;
+
+    VECTOR3F center;          /* Bounding sphere in world space */
+    float radius;
+
+    int cullPlane;            /* Frustum plane which culled it last time */
+};
+
+struct OCTREE_T
+{
+    OCTREE_NODE *pRoot;
+    int maxDepth;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                Private Data                                */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                       Private Function Declarations                        */
+/*----------------------------------------------------------------------------*/
+
+static int SrpOctreeNewNode(OCTREE_NODE **ppNode, OCTREE_NODE *pParent,
+                            int octant);
+static void SrpOctreeDeleteNode(OCTREE_NODE *pNode);
+static int SrpOctreeIsInCell(const OCTREE_NODE *pNode, const VECTOR3F center);
+static int SrpOctreeGetOctant(const OCTREE_NODE *pNode,
+                              const VECTOR3F center);
+static OCTREE_NODE *SrpOctreeDescend(const OCTREE *pTree, OCTREE_NODE *pNode,
+                                     const VECTOR3F center, float radius);
+static void SrpOctreeLink(OCTREE_NODE *pNode, OCTREE_ENTRY *pEntry);
+static void SrpOctreeUnlink(OCTREE_ENTRY *pEntry);
+static void SrpOctreeNodeDraw(OCTREE_NODE *pNode, RENDER_LIST *pRl,
+                              const FRUSTUM *pFrustum, int planeMask);
+
+/*----------------------------------------------------------------------------*/
+/*                             Private Functions                              */
+/*----------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------
+ * int SrpOctreeNewNode(OCTREE_NODE **ppNode, OCTREE_NODE *pParent,
+ *                      int octant)
+ *
+ * Create node for an octant of the parent's cell, or the root if
+ * pParent is NULL, whose cell is to be set by the caller.
+ */
+static int SrpOctreeNewNode(OCTREE_NODE **ppNode, OCTREE_NODE *pParent,
+                            int octant)
+{
+    OCTREE_NODE *pNode;
+    float quarter;
+    int i;
+
+    if (!IgNewMemory((void **)ppNode, sizeof(OCTREE_NODE)))
+    {
+        printf("Error: create octree node failed.\n");
+        return FALSE;
+    }
+
+    pNode = *ppNode;
+    pNode->pParent = pParent;
+    for (i = 0; i < 8; i++)
+    {
+        pNode->pChildren[i] = NULL;
+    }
+    pNode->numObjects = 0;
+    pNode->pFirstEntry = NULL;
+    pNode->cullPlane = 0;
+
+    if (pParent != NULL)
+    {
+        quarter = pParent->halfSize * 0.5f;
+        pNode->center[0] = pParent->center[0] +
+                           ((octant & 1) ? quarter : -quarter);
+        pNode->center[1] = pParent->center[1] +
+                           ((octant & 2) ? quarter : -quarter);
+        pNode->center[2] = pParent->center[2] +
+                           ((octant & 4) ? quarter : -quarter);
+        pNode->halfSize = quarter;
+        pNode->depth = pParent->depth + 1;
+
+        pParent->pChildren[octant] = pNode;
+    }
+
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpOctreeDeleteNode(OCTREE_NODE *pNode)
+ *
+ * Delete node and its subtree, removing the objects from the octree.
+ */
+static void SrpOctreeDeleteNode(OCTREE_NODE *pNode)
+{
+    OCTREE_ENTRY *pEntry, *pNext;
+    int i;
+
+    for (pEntry = pNode->pFirstEntry; pEntry != NULL; pEntry = pNext)
+    {
+        pNext = pEntry->pNext;
+        SrpSetObjectEntry(pEntry->pObj, NULL);
+        IgFreeMemory(pEntry);
+    }
+
+    for (i = 0; i < 8; i++)
+    {
+        if (pNode->pChildren[i] != NULL)
+        {
+            SrpOctreeDeleteNode(pNode->pChildren[i]);
+        }
+    }
+
+    IgFreeMemory(pNode);
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpOctreeIsInCell(const OCTREE_NODE *pNode, const VECTOR3F center)
+ *
+ * Check if a point is in the cell of a node.
+ */
+static int SrpOctreeIsInCell(const OCTREE_NODE *pNode, const VECTOR3F center)
+{
+    return fabsf(center[0] - pNode->center[0]) <= pNode->halfSize &&
+           fabsf(center[1] - pNode->center[1]) <= pNode->halfSize &&
+           fabsf(center[2] - pNode->center[2]) <= pNode->halfSize;
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpOctreeGetOctant(const OCTREE_NODE *pNode, const VECTOR3F center)
+ *
+ * Get the octant of the node's cell a point is in, one bit per axis.
+ */
+static int SrpOctreeGetOctant(const OCTREE_NODE *pNode,
+                              const VECTOR3F center)
+{
+    return (center[0] >= pNode->center[0] ? 1 : 0) |
+           (center[1] >= pNode->center[1] ? 2 : 0) |
+           (center[2] >= pNode->center[2] ? 4 : 0);
+}
+
+/*------------------------------------------------------------------------------
+ * OCTREE_NODE *SrpOctreeDescend(const OCTREE *pTree, OCTREE_NODE *pNode,
+ *                               const VECTOR3F center, float radius)
+ *
+ * Find the deepest node below pNode a sphere fits in, creating nodes
+ * on the way as needed. pNode itself is returned if the sphere's center
+ * is out of its cell, which happens to the root only.
+ */
+static OCTREE_NODE *SrpOctreeDescend(const OCTREE *pTree, OCTREE_NODE *pNode,
+                                     const VECTOR3F center, float radius)
+{
+    OCTREE_NODE *pChild;
+    int octant;
+
+    if (!SrpOctreeIsInCell(pNode, center))
+    {
+        return pNode;
+    }
+
+    while (pNode->depth < pTree->maxDepth &&
+           radius <= pNode->halfSize * 0.5f * (OCTREE_LOOSENESS - 1.0f))
+    {
+        octant = SrpOctreeGetOctant(pNode, center);
+        pChild = pNode->pChildren[octant];
+
+        /* Staying in the parent is still correct, only less tight */
+        if (pChild == NULL && !SrpOctreeNewNode(&pChild, pNode, octant))
+        {
+            break;
+        }
+
+        pNode = pChild;
+    }
+
+    return pNode;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpOctreeLink(OCTREE_NODE *pNode, OCTREE_ENTRY *pEntry)
+ *
+ * Put an entry in a node, counting it in the node and its ancestors.
+ */
+static void SrpOctreeLink(OCTREE_NODE *pNode, OCTREE_ENTRY *pEntry)
+{
+    pEntry->pNode = pNode;
+    pEntry->pPrev = NULL;
+    pEntry->pNext = pNode->pFirstEntry;
+    if (pNode->pFirstEntry != NULL)
+    {
+        pNode->pFirstEntry->pPrev = pEntry;
+    }
+    pNode->pFirstEntry = pEntry;
+
+    for (; pNode != NULL; pNode = pNode->pParent)
+    {
+        pNode->numObjects++;
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpOctreeUnlink(OCTREE_ENTRY *pEntry)
+ *
+ * Take an entry out of its node. Nodes left empty are kept, for objects
+ * moving back and forth across a cell.
+ */
+static void SrpOctreeUnlink(OCTREE_ENTRY *pEntry)
+{
+    OCTREE_NODE *pNode;
+
+    pNode = pEntry->pNode;
+
+    if (pEntry->pPrev != NULL)
+    {
+        pEntry->pPrev->pNext = pEntry->pNext;
+    }
+    else
+    {
+        pNode->pFirstEntry = pEntry->pNext;
+    }
+    if (pEntry->pNext != NULL)
+    {
+        pEntry->pNext->pPrev = pEntry->pPrev;
+    }
+
+    for (; pNode != NULL; pNode = pNode->pParent)
+    {
+        pNode->numObjects--;
+    }
+
+    pEntry->pNode = NULL;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpOctreeNodeDraw(OCTREE_NODE *pNode, RENDER_LIST *pRl, 
+ *                        const FRUSTUM *pFrustum, int planeMask)
+ *
+ * Draw the visible objects of a subtree, whose node is completely 
+ * inside the planes of pFrustum not in planeMask. These planes are 
+ * never tested again below, by nodes, entries or the objects themselves.
+ * pFrustum is in world space, as the octree is. With no pFrustum, when 
+ * objects aren't culled, nothing is tested and every object is drawn 
+ * and clipped against all the planes, the same as by SrpDrawObject.
+ */
+static void SrpOctreeNodeDraw(OCTREE_NODE *pNode, RENDER_LIST *pRl, 
+                              const FRUSTUM *pFrustum, int planeMask)
+{
+    OCTREE_ENTRY *pEntry;
+    OCTREE_NODE *pChild;
+    int i, mask;
+
+    for (pEntry = pNode->pFirstEntry; pEntry != NULL; pEntry = pEntry->pNext)
+    {
+        mask = planeMask;
+        if (mask != 0 && 
+            SrpCullSphereInFrustum(pFrustum, pEntry->center, pEntry->radius, 
+                                   &mask, &pEntry->cullPlane) == 
+            FRUSTUM_OUTSIDE)
+        {
+            continue;
+        }
+
+        SrpRCSetCullPlaneMask(pFrustum != NULL ? mask : FRUSTUM_PLANES_ALL);
+        SrpDrawObject(pEntry->pObj, pRl);
+    }
+
+    for (i = 0; i < 8; i++)
+    {
+        pChild = pNode->pChildren[i];
+        if (pChild == NULL || pChild->numObjects == 0)
+        {
+            continue;
+        }
+
+        /* The sphere around the loose cube */
+        mask = planeMask;
+        if (mask == 0 || 
+            SrpCullSphereInFrustum(pFrustum, pChild->center, 
+                                   pChild->halfSize * OCTREE_LOOSENESS * 
+                                   OCTREE_SQRT3, 
+                                   &mask, &pChild->cullPlane) != 
+            FRUSTUM_OUTSIDE)
+        {
+            SrpOctreeNodeDraw(pChild, pRl, pFrustum, mask);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/*                              Public Functions                              */
+/*----------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------
+ * int SrpCreateOctree(OCTREE **ppTree, const VECTOR3F center,
+ *                     float halfSize, int maxDepth)
+ *
+ * Create octree over the cube of halfSize around center, subdivided
+ * maxDepth levels at most. Objects outside the cube are kept in the
+ * root, and are tested one by one.
+ */
+int SrpCreateOctree(OCTREE **ppTree, const VECTOR3F center,
+                    float halfSize, int maxDepth)
+{
+    OCTREE *pTree;
+
+    ASSERTMSG(ppTree != NULL && halfSize > 0.0f && maxDepth >= 0 &&
+              maxDepth <= OCTREE_MAX_DEPTH,
+              "SrpCreateOctree: invalid arguments.");
+
+    if (!IgNewMemory((void **)ppTree, sizeof(OCTREE)))
+    {
+        printf("Error: create octree failed.\n");
+        return FALSE;
+    }
+
+    pTree = *ppTree;
+    pTree->maxDepth = maxDepth;
+
+    if (!SrpOctreeNewNode(&pTree->pRoot, NULL, 0))
+    {
+        printf("Error: create octree failed.\n");
+        IgFreeMemory(pTree);
+        return FALSE;
+    }
+
+    SrpVectorCopy3f(pTree->pRoot->center, center);
+    pTree->pRoot->halfSize = halfSize;
+    pTree->pRoot->depth = 0;
+
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpDeleteOctree(OCTREE *pTree)
+ *
+ * Delete octree. Objects are removed from it, not deleted.
+ */
+void SrpDeleteOctree(OCTREE *pTree)
+{
+    ASSERTMSG(pTree != NULL, "SrpDeleteOctree: invalid arguments.");
+
+    SrpOctreeDeleteNode(pTree->pRoot);
+    IgFreeMemory(pTree);
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpOctreeInsertObject(OCTREE *pTree, OBJECT *pObj)
+ *
+ * Insert object into octree, in the deepest node its bounds fit in.
+ */
+int SrpOctreeInsertObject(OCTREE *pTree, OBJECT *pObj)
+{
+    OCTREE_ENTRY *pEntry;
+
+    ASSERTMSG(pTree != NULL && pObj != NULL &&
+              SrpGetObjectEntry(pObj) == NULL,
+              "SrpOctreeInsertObject: invalid arguments.");
+
+    if (!IgNewMemory((void **)&pEntry, sizeof(OCTREE_ENTRY)))
+    {
+        printf("Error: insert object into octree failed.\n");
+        return FALSE;
+    }
+
+    pEntry->pObj = pObj;
+    pEntry->pTree = pTree;
+    pEntry->cullPlane = 0;
+    SrpGetObjectBounds(pObj, pEntry->center, &pEntry->radius);
+
+    SrpOctreeLink(SrpOctreeDescend(pTree, pTree->pRoot, pEntry->center,
+                                   pEntry->radius), pEntry);
+    SrpSetObjectEntry(pObj, pEntry);
+
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpOctreeRemoveObject(OBJECT *pObj)
+ *
+ * Remove object from the octree it's in.
+ */
+void SrpOctreeRemoveObject(OBJECT *pObj)
+{
+    OCTREE_ENTRY *pEntry;
+
+    ASSERTMSG(pObj != NULL && SrpGetObjectEntry(pObj) != NULL,
+              "SrpOctreeRemoveObject: invalid arguments.");
+
+    pEntry = SrpGetObjectEntry(pObj);
+    SrpOctreeUnlink(pEntry);
+    SrpSetObjectEntry(pObj, NULL);
+    IgFreeMemory(pEntry);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpOctreeUpdateObject(OBJECT *pObj)
+ *
+ * Move object to where its bounds are now in the octree it's in. Only
+ * the path up to the first node it still fits in and down from there
+ * is visited, so moving a little costs little.
+ */
+void SrpOctreeUpdateObject(OBJECT *pObj)
+{
+    OCTREE_ENTRY *pEntry;
+    OCTREE_NODE *pNode;
+
+    ASSERTMSG(pObj != NULL && SrpGetObjectEntry(pObj) != NULL,
+              "SrpOctreeUpdateObject: invalid arguments.");
+
+    pEntry = SrpGetObjectEntry(pObj);
+    SrpGetObjectBounds(pObj, pEntry->center, &pEntry->radius);
+
+    /* Climb to a node the sphere fits in, the root takes anything */
+    pNode = pEntry->pNode;
+    while (pNode->pParent != NULL &&
+           (!SrpOctreeIsInCell(pNode, pEntry->center) ||
+            pEntry->radius > pNode->halfSize * (OCTREE_LOOSENESS - 1.0f)))
+    {
+        pNode = pNode->pParent;
+    }
+
+    pNode = SrpOctreeDescend(pEntry->pTree, pNode, pEntry->center,
+                             pEntry->radius);
+    if (pNode != pEntry->pNode)
+    {
+        SrpOctreeUnlink(pEntry);
+        SrpOctreeLink(pNode, pEntry);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpOctreeGetNumObjects(const OCTREE *pTree)
+ *
+ * Get the number of objects in octree.
+ */
+int SrpOctreeGetNumObjects(const OCTREE *pTree)
+{
+    ASSERTMSG(pTree != NULL, "SrpOctreeGetNumObjects: invalid arguments.");
+
+    return pTree->pRoot->numObjects;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpOctreeDrawObjects(OCTREE *pTree, RENDER_LIST *pRl)
+ *
+ * Draw objects of octree which are visible with current frustum into
+ * render list, with current modelview matrix as the world to camera
+ * transformation. A node out of the frustum skips its subtree, one
+ * inside accepts its subtree without testing any further. Everything 
+ * is tested in world space, no center is transformed.
+ */
+void SrpOctreeDrawObjects(OCTREE *pTree, RENDER_LIST *pRl)
+{
+    ASSERTMSG(pTree != NULL && pRl != NULL,
+              "SrpOctreeDrawObjects: invalid arguments.");
+
+    if (!SrpRCIsEnabled(SRP_CULL_OBJECT))
+    {
+        SrpOctreeNodeDraw(pTree->pRoot, pRl, NULL, 0);
+        SrpRCSetCullPlaneMask(FRUSTUM_PLANES_ALL);
+        return;
+    }
+
+    /* The root holds objects out of its cell, so it's never culled */
+    SrpOctreeNodeDraw(pTree->pRoot, pRl, SrpRCGetWorldFrustum(), 
+                      FRUSTUM_PLANES_ALL);
+    SrpRCSetCullPlaneMask(FRUSTUM_PLANES_ALL);
+}
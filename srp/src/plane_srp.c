@@ -6,8 +6,11 @@
  * Time   : 2011-10-28 11:13
  ******************************************************************************/
 
+#include "datadef_ig.h"
+#include "assert_ig.h"
 #include "plane_srp.h"
 #include "vector_srp.h"
+#include "simd_srp.h"
 
 /*----------------------------------------------------------------------------*/
 /*                               Data Structure                               */
@@ -21,10 +24,111 @@
 /*                       Private Function Declarations                        */
 /*----------------------------------------------------------------------------*/
 
+#if defined(SRP_SIMD_X86)
+static int SrpPlaneDistanceSse2(const PLANE plane, const float *p, int count, 
+                                float *pDist);
+static int SrpPlaneDistanceAvx2(const PLANE plane, const float *p, int count, 
+                                float *pDist);
+static int SrpPlaneDistanceAvx512(const PLANE plane, const float *p, 
+                                  int count, float *pDist);
+#endif
+
 /*----------------------------------------------------------------------------*/
 /*                             Private Functions                              */
 /*----------------------------------------------------------------------------*/
 
+#if defined(SRP_SIMD_X86)
+/*------------------------------------------------------------------------------
+ * int SrpPlaneDistanceSse2(const PLANE plane, const float *p, int count, 
+ *                          float *pDist)
+ * int SrpPlaneDistanceAvx2(const PLANE plane, const float *p, int count, 
+ *                          float *pDist)
+ * int SrpPlaneDistanceAvx512(const PLANE plane, const float *p, 
+ *                            int count, float *pDist)
+ *
+ * Get the distances of 4, 8 or 16 points per iteration, see 
+ * SrpPlaneDistanceArray. Return how many points are done, the rest 
+ * is left to the caller.
+ */
+SRP_TARGET_SSE2
+static int SrpPlaneDistanceSse2(const PLANE plane, const float *p, int count, 
+                                float *pDist)
+{
+    int i;
+    __m128 a, b, c, d, m03, m14, m25, x, y, z;
+
+    a = _mm_set1_ps(plane[0]);
+    b = _mm_set1_ps(plane[1]);
+    c = _mm_set1_ps(plane[2]);
+    d = _mm_set1_ps(plane[3]);
+
+    for (i = 0; i + 4 <= count; i += 4)
+    {
+        SRP_SIMD_LOAD3_128(p + i * 3, m03, m14, m25);
+        SRP_SIMD_AOS_TO_SOA(_mm_shuffle_ps, __m128, m03, m14, m25, x, y, z);
+
+        _mm_storeu_ps(pDist + i, 
+                      _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(a, x), 
+                                                       _mm_mul_ps(b, y)), 
+                                            _mm_mul_ps(c, z)), d));
+    }
+
+    return i;
+}
+
+SRP_TARGET_AVX2
+static int SrpPlaneDistanceAvx2(const PLANE plane, const float *p, int count, 
+                                float *pDist)
+{
+    int i;
+    __m256 a, b, c, d, m03, m14, m25, x, y, z;
+
+    a = _mm256_set1_ps(plane[0]);
+    b = _mm256_set1_ps(plane[1]);
+    c = _mm256_set1_ps(plane[2]);
+    d = _mm256_set1_ps(plane[3]);
+
+    for (i = 0; i + 8 <= count; i += 8)
+    {
+        SRP_SIMD_LOAD3_256(p + i * 3, m03, m14, m25);
+        SRP_SIMD_AOS_TO_SOA(_mm256_shuffle_ps, __m256, m03, m14, m25, 
+                            x, y, z);
+
+        _mm256_storeu_ps(pDist + i, 
+                         _mm256_add_ps(_mm256_fmadd_ps(c, z, 
+                             _mm256_fmadd_ps(b, y, _mm256_mul_ps(a, x))), d));
+    }
+
+    return i;
+}
+
+SRP_TARGET_AVX512
+static int SrpPlaneDistanceAvx512(const PLANE plane, const float *p, 
+                                  int count, float *pDist)
+{
+    int i;
+    __m512 a, b, c, d, m03, m14, m25, x, y, z;
+
+    a = _mm512_set1_ps(plane[0]);
+    b = _mm512_set1_ps(plane[1]);
+    c = _mm512_set1_ps(plane[2]);
+    d = _mm512_set1_ps(plane[3]);
+
+    for (i = 0; i + 16 <= count; i += 16)
+    {
+        SRP_SIMD_LOAD3_512(p + i * 3, m03, m14, m25);
+        SRP_SIMD_AOS_TO_SOA(_mm512_shuffle_ps, __m512, m03, m14, m25, 
+                            x, y, z);
+
+        _mm512_storeu_ps(pDist + i, 
+                         _mm512_add_ps(_mm512_fmadd_ps(c, z, 
+                             _mm512_fmadd_ps(b, y, _mm512_mul_ps(a, x))), d));
+    }
+
+    return i;
+}
+#endif
+
 /*----------------------------------------------------------------------------*/
 /*                              Public Functions                              */
 /*----------------------------------------------------------------------------*/
@@ -72,3 +176,44 @@ float SrpPlaneGetDistance(const PLANE plane, const VECTOR3F p)
 {
     return (plane[0] * p[0] + plane[1] * p[1] + plane[2] * p[2] + plane[3]);
 }
+
+/*------------------------------------------------------------------------------
+ * void SrpPlaneDistanceArray(const PLANE plane, const VECTOR3F *p, 
+ *                            int count, float *pDist)
+ *
+ * Get the distances from count points to the plane, 
+ * pDist[i] = SrpPlaneGetDistance(plane, p[i]).
+ *
+ * Runs with the widest SIMD level SrpSimdGetLevel() gives.
+ */
+void SrpPlaneDistanceArray(const PLANE plane, const VECTOR3F *p, int count, 
+                           float *pDist)
+{
+    int i;
+
+    ASSERTMSG(plane != NULL && p != NULL && count >= 0 && pDist != NULL, 
+              "SrpPlaneDistanceArray: invalid arguments.");
+
+    i = 0;
+#if defined(SRP_SIMD_X86)
+    switch (SrpSimdGetLevel())
+    {
+    case SRP_SIMD_AVX512:
+        i = SrpPlaneDistanceAvx512(plane, (const float *)p, count, pDist);
+        break;
+    case SRP_SIMD_AVX2:
+        i = SrpPlaneDistanceAvx2(plane, (const float *)p, count, pDist);
+        break;
+    case SRP_SIMD_SSE2:
+        i = SrpPlaneDistanceSse2(plane, (const float *)p, count, pDist);
+        break;
+    default:
+        break;
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        pDist[i] = SrpPlaneGetDistance(plane, p[i]);
+    }
+}
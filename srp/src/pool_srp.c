@@ -0,0 +1,431 @@
+/*******************************************************************************
+ * File   : pool_srp.c
+ * Content: Object pool
+ *
+ * Coder  : Ean Jee
+ * Time   : 2026-10-19 15:20
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "datadef_ig.h"
+#include "assert_ig.h"
+#include "malloc_ig.h"
+#include "datadef_srp.h"
+#include "matrix_srp.h"
+#include "rcmanager_srp.h"
+#include "octree_srp.h"
+#include "pool_srp.h"
+
+/*----------------------------------------------------------------------------*/
+/*                               Data Structure                               */
+/*----------------------------------------------------------------------------*/
+
+#define POOL_INDEX_BITS       20
+#define POOL_INDEX_MASK       ((1 << POOL_INDEX_BITS) - 1)
+#define POOL_MAX_CAPACITY     POOL_INDEX_MASK
+#define POOL_MAX_GENERATION   ((1 << (31 - POOL_INDEX_BITS)) - 1)
+
+/*
+ * A slot owns an object's memory for good. Handles point to slots,
+ * slots point into the dense arrays.
+ */
+struct POOL_SLOT_T
+{
+    int generation;  /* Bumped each time the slot is freed */
+    int dense;       /* Index into the dense arrays, or the next free slot */
+};
+
+typedef struct POOL_SLOT_T POOL_SLOT;
+
+/*
+ * Live objects are packed at the front of the dense arrays, so culling 
+ * runs over contiguous x, y, z, radius and visible without touching the 
+ * objects themselves.
+ */
+struct OBJECT_POOL_T
+{
+    int capacity;
+    int numObjects;
+
+    int objectSize;
+    unsigned char *pObjects;  /* capacity objects, indexed by slot */
+
+    POOL_SLOT *pSlots;
+    int firstFree;            /* Head of the free slot list, -1 if full */
+
+    /* Dense arrays */
+    float *x, *y, *z;         /* Position in world space */
+    float *radius;
+    int *slot;                /* Owner slot of each dense entry */
+    byte *visible;            /* Result of the last culling */
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                Private Data                                */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                       Private Function Declarations                        */
+/*----------------------------------------------------------------------------*/
+
+static OBJECT* SrpPoolSlotObject(const OBJECT_POOL *pPool, int slot);
+static int SrpPoolFindSlot(const OBJECT_POOL *pPool, OBJECT_HANDLE handle);
+static void SrpPoolRefreshDense(OBJECT_POOL *pPool, int dense);
+
+/*----------------------------------------------------------------------------*/
+/*                             Private Functions                              */
+/*----------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------
+ * OBJECT* SrpPoolSlotObject(const OBJECT_POOL *pPool, int slot)
+ *
+ * Get the object stored in a slot.
+ */
+static OBJECT* SrpPoolSlotObject(const OBJECT_POOL *pPool, int slot)
+{
+    return (OBJECT *)(pPool->pObjects + (size_t)slot * pPool->objectSize);
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpPoolFindSlot(const OBJECT_POOL *pPool, OBJECT_HANDLE handle)
+ *
+ * Get the slot of a handle, -1 if the handle is stale.
+ */
+static int SrpPoolFindSlot(const OBJECT_POOL *pPool, OBJECT_HANDLE handle)
+{
+    int slot, generation;
+
+    slot = (handle & POOL_INDEX_MASK) - 1;
+    generation = handle >> POOL_INDEX_BITS;
+
+    if (slot < 0 || slot >= pPool->capacity || 
+        pPool->pSlots[slot].generation != generation)
+    {
+        return -1;
+    }
+
+    return slot;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpPoolRefreshDense(OBJECT_POOL *pPool, int dense)
+ *
+ * Copy the bounding sphere of an object into the dense arrays.
+ */
+static void SrpPoolRefreshDense(OBJECT_POOL *pPool, int dense)
+{
+    VECTOR3F center;
+
+    SrpGetObjectBounds(SrpPoolSlotObject(pPool, pPool->slot[dense]), 
+                       center, &pPool->radius[dense]);
+
+    pPool->x[dense] = center[0];
+    pPool->y[dense] = center[1];
+    pPool->z[dense] = center[2];
+}
+
+/*----------------------------------------------------------------------------*/
+/*                              Public Functions                              */
+/*----------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------
+ * int SrpCreateObjectPool(OBJECT_POOL **ppPool, int capacity)
+ *
+ * Create object pool holding up to capacity objects. All the memory 
+ * is allocated here, creating objects later never allocates.
+ */
+int SrpCreateObjectPool(OBJECT_POOL **ppPool, int capacity)
+{
+    OBJECT_POOL *pPool;
+    int i;
+
+    ASSERTMSG(ppPool != NULL && capacity > 0 && 
+              capacity <= POOL_MAX_CAPACITY, 
+              "SrpCreateObjectPool: invalid arguments.");
+
+    if (!IgNewMemory((void **)ppPool, sizeof(OBJECT_POOL)))
+    {
+        printf("Error: create object pool failed.\n");
+        return FALSE;
+    }
+
+    pPool = *ppPool;
+    pPool->capacity = capacity;
+    pPool->numObjects = 0;
+    pPool->objectSize = SrpGetObjectSize();
+
+    if (!IgNewMemory((void **)&pPool->pObjects, 
+                     (size_t)capacity * pPool->objectSize))
+    {
+        printf("Error: create object pool failed.\n");
+        IgFreeMemory(pPool);
+        return FALSE;
+    }
+
+    if (!IgNewMemory((void **)&pPool->pSlots, capacity * sizeof(POOL_SLOT)))
+    {
+        printf("Error: create object pool failed.\n");
+        IgFreeMemory(pPool->pObjects);
+        IgFreeMemory(pPool);
+        return FALSE;
+    }
+
+    /* The dense arrays share one block */
+    if (!IgNewMemory((void **)&pPool->x, 
+                     capacity * (4 * sizeof(float) + sizeof(int) + 
+                                 sizeof(byte))))
+    {
+        printf("Error: create object pool failed.\n");
+        IgFreeMemory(pPool->pSlots);
+        IgFreeMemory(pPool->pObjects);
+        IgFreeMemory(pPool);
+        return FALSE;
+    }
+
+    pPool->y = pPool->x + capacity;
+    pPool->z = pPool->y + capacity;
+    pPool->radius = pPool->z + capacity;
+    pPool->slot = (int *)(pPool->radius + capacity);
+    pPool->visible = (byte *)(pPool->slot + capacity);
+
+    for (i = 0; i < capacity; i++)
+    {
+        pPool->pSlots[i].generation = 1;
+        pPool->pSlots[i].dense = i + 1;
+    }
+    pPool->pSlots[capacity - 1].dense = -1;
+    pPool->firstFree = 0;
+
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpDeleteObjectPool(OBJECT_POOL *pPool)
+ *
+ * Delete object pool, with all the objects in it.
+ */
+void SrpDeleteObjectPool(OBJECT_POOL *pPool)
+{
+    OBJECT *pObj;
+    int i;
+
+    ASSERTMSG(pPool != NULL, "SrpDeleteObjectPool: invalid arguments.");
+
+    for (i = 0; i < pPool->numObjects; i++)
+    {
+        pObj = SrpPoolSlotObject(pPool, pPool->slot[i]);
+        if (SrpGetObjectEntry(pObj) != NULL)
+        {
+            SrpOctreeRemoveObject(pObj);
+        }
+    }
+
+    IgFreeMemory(pPool->x);
+    IgFreeMemory(pPool->pSlots);
+    IgFreeMemory(pPool->pObjects);
+    IgFreeMemory(pPool);
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpPoolCreateObject(OBJECT_POOL *pPool, OBJECT_HANDLE *pHandle, 
+ *                         MODEL *pModel, 
+ *                         float positionX, float positionY, 
+ *                         float positionZ, 
+ *                         float directionX, float directionY, 
+ *                         float directionZ,
+ *                         float scaleX, float scaleY, float scaleZ)
+ *
+ * Create object in a pool, see SrpCreateObject. Fails if the pool 
+ * is full.
+ */
+int SrpPoolCreateObject(OBJECT_POOL *pPool, OBJECT_HANDLE *pHandle, 
+                        MODEL *pModel, 
+                        float positionX, float positionY, float positionZ, 
+                        float directionX, float directionY, float directionZ,
+                        float scaleX, float scaleY, float scaleZ)
+{
+    int slot, dense;
+
+    ASSERTMSG(pPool != NULL && pHandle != NULL && pModel != NULL, 
+              "SrpPoolCreateObject: invalid arguments.");
+
+    if (pPool->firstFree < 0)
+    {
+        printf("Error: object pool is full.\n");
+        return FALSE;
+    }
+
+    slot = pPool->firstFree;
+    pPool->firstFree = pPool->pSlots[slot].dense;
+
+    dense = pPool->numObjects++;
+    pPool->pSlots[slot].dense = dense;
+    pPool->slot[dense] = slot;
+    pPool->visible[dense] = TRUE;
+
+    SrpInitObject(SrpPoolSlotObject(pPool, slot), pModel, 
+                  positionX, positionY, positionZ, 
+                  directionX, directionY, directionZ, scaleX, scaleY, scaleZ);
+    SrpPoolRefreshDense(pPool, dense);
+
+    *pHandle = (pPool->pSlots[slot].generation << POOL_INDEX_BITS) | 
+               (slot + 1);
+
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpPoolDeleteObject(OBJECT_POOL *pPool, OBJECT_HANDLE handle)
+ *
+ * Delete object from a pool. The last dense entry moves into the hole, 
+ * so the dense arrays stay packed.
+ */
+void SrpPoolDeleteObject(OBJECT_POOL *pPool, OBJECT_HANDLE handle)
+{
+    int slot, dense, last;
+
+    ASSERTMSG(pPool != NULL, "SrpPoolDeleteObject: invalid arguments.");
+
+    slot = SrpPoolFindSlot(pPool, handle);
+    if (slot < 0)
+    {
+        ASSERTMSG(FALSE, "SrpPoolDeleteObject: stale handle.");
+        return;
+    }
+
+    if (SrpGetObjectEntry(SrpPoolSlotObject(pPool, slot)) != NULL)
+    {
+        SrpOctreeRemoveObject(SrpPoolSlotObject(pPool, slot));
+    }
+
+    dense = pPool->pSlots[slot].dense;
+    last = --pPool->numObjects;
+    if (dense != last)
+    {
+        pPool->x[dense] = pPool->x[last];
+        pPool->y[dense] = pPool->y[last];
+        pPool->z[dense] = pPool->z[last];
+        pPool->radius[dense] = pPool->radius[last];
+        pPool->slot[dense] = pPool->slot[last];
+        pPool->visible[dense] = pPool->visible[last];
+        pPool->pSlots[pPool->slot[dense]].dense = dense;
+    }
+
+    /* Wrap around, skipping 0 so that a handle is never 0 */
+    pPool->pSlots[slot].generation++;
+    if (pPool->pSlots[slot].generation > POOL_MAX_GENERATION)
+    {
+        pPool->pSlots[slot].generation = 1;
+    }
+
+    pPool->pSlots[slot].dense = pPool->firstFree;
+    pPool->firstFree = slot;
+}
+
+/*------------------------------------------------------------------------------
+ * OBJECT* SrpPoolGetObject(const OBJECT_POOL *pPool, OBJECT_HANDLE handle)
+ *
+ * Get object by handle, NULL if the handle is stale.
+ * The address stays the same until the object is deleted.
+ */
+OBJECT* SrpPoolGetObject(const OBJECT_POOL *pPool, OBJECT_HANDLE handle)
+{
+    int slot;
+
+    ASSERTMSG(pPool != NULL, "SrpPoolGetObject: invalid arguments.");
+
+    slot = SrpPoolFindSlot(pPool, handle);
+
+    return slot < 0 ? NULL : SrpPoolSlotObject(pPool, slot);
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpPoolGetNumObjects(const OBJECT_POOL *pPool)
+ *
+ * Get the number of objects in a pool.
+ */
+int SrpPoolGetNumObjects(const OBJECT_POOL *pPool)
+{
+    ASSERTMSG(pPool != NULL, "SrpPoolGetNumObjects: invalid arguments.");
+
+    return pPool->numObjects;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpPoolTranslateObject(OBJECT_POOL *pPool, OBJECT_HANDLE handle,
+ *                             float x, float y, float z)
+ *
+ * Translate object in a pool, see SrpTranslateObject.
+ */
+void SrpPoolTranslateObject(OBJECT_POOL *pPool, OBJECT_HANDLE handle,
+                            float x, float y, float z)
+{
+    int slot;
+
+    ASSERTMSG(pPool != NULL, "SrpPoolTranslateObject: invalid arguments.");
+
+    slot = SrpPoolFindSlot(pPool, handle);
+    if (slot < 0)
+    {
+        ASSERTMSG(FALSE, "SrpPoolTranslateObject: stale handle.");
+        return;
+    }
+
+    SrpTranslateObject(SrpPoolSlotObject(pPool, slot), x, y, z);
+    SrpPoolRefreshDense(pPool, pPool->pSlots[slot].dense);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpPoolUpdateObject(OBJECT_POOL *pPool, OBJECT_HANDLE handle)
+ *
+ * Tell the pool an object has been changed otherwise, e.g. scaled, 
+ * so its bounding sphere is copied again.
+ */
+void SrpPoolUpdateObject(OBJECT_POOL *pPool, OBJECT_HANDLE handle)
+{
+    int slot;
+
+    ASSERTMSG(pPool != NULL, "SrpPoolUpdateObject: invalid arguments.");
+
+    slot = SrpPoolFindSlot(pPool, handle);
+    if (slot < 0)
+    {
+        ASSERTMSG(FALSE, "SrpPoolUpdateObject: stale handle.");
+        return;
+    }
+
+    SrpPoolRefreshDense(pPool, pPool->pSlots[slot].dense);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpPoolDrawObjects(OBJECT_POOL *pPool, RENDER_LIST *pRl)
+ *
+ * Cull every object of a pool over the dense arrays, then draw the 
+ * visible ones with current modelview matrix.
+ */
+void SrpPoolDrawObjects(OBJECT_POOL *pPool, RENDER_LIST *pRl)
+{
+    int i;
+
+    ASSERTMSG(pPool != NULL && pRl != NULL, 
+              "SrpPoolDrawObjects: invalid arguments.");
+
+    if (SrpRCIsEnabled(SRP_CULL_OBJECT))
+    {
+        SrpRCCullSpheresBatch(pPool->x, pPool->y, pPool->z, pPool->radius, 
+                              pPool->numObjects, pPool->visible);
+    }
+    else
+    {
+        memset(pPool->visible, TRUE, pPool->numObjects);
+    }
+
+    for (i = 0; i < pPool->numObjects; i++)
+    {
+        if (pPool->visible[i])
+        {
+            SrpDrawObject(SrpPoolSlotObject(pPool, pPool->slot[i]), pRl);
+        }
+    }
+}
@@ -0,0 +1,262 @@
+/*******************************************************************************
+ * File   : quaternion_srp.c
+ * Content: Quaternion functions.
+ *
+ * Coder  : Ean Jee
+ * Time   : 2026-10-19 10:20
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <math.h>
+#include "datadef_ig.h"
+#include "assert_ig.h"
+#include "quaternion_srp.h"
+#include "math_srp.h"
+
+/*----------------------------------------------------------------------------*/
+/*                               Data Structure                               */
+/*----------------------------------------------------------------------------*/
+
+/* Above this cosine the arc is too short for slerp to be stable */
+#define QUATERNION_SLERP_MAX_DOT 0.9995f
+
+/*----------------------------------------------------------------------------*/
+/*                                Private Data                                */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                       Private Function Declarations                        */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                             Private Functions                              */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                              Public Functions                              */
+/*----------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------
+ * void SrpQuaternionLoadIdentity(QUATERNION q)
+ *
+ * Load identity quaternion, which doesn't rotate.
+ */
+void SrpQuaternionLoadIdentity(QUATERNION q)
+{
+    q[0] = 0.0f;
+    q[1] = 0.0f;
+    q[2] = 0.0f;
+    q[3] = 1.0f;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpQuaternionCopy(QUATERNION dst, const QUATERNION src)
+ *
+ * Copy quaternion.
+ */
+void SrpQuaternionCopy(QUATERNION dst, const QUATERNION src)
+{
+    dst[0] = src[0];
+    dst[1] = src[1];
+    dst[2] = src[2];
+    dst[3] = src[3];
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpQuaternionMakeRotation(QUATERNION out, const VECTOR3F v, float t)
+ *
+ * Make a quaternion rotating angle t about the axis v, which is defined 
+ * by origin and vector v. t is the amount of rotation in radians.
+ */
+void SrpQuaternionMakeRotation(QUATERNION out, const VECTOR3F v, float t)
+{
+    float length, s, c;
+
+    length = SrpVectorLength3f(v);
+    if (length < EPSILON_E6F)
+    {
+        ASSERTMSG(FALSE, 
+                  "SrpQuaternionMakeRotation: rotation axis is zero vector.");
+        SrpQuaternionLoadIdentity(out);
+        return;
+    }
+
+    SrpMathSinCosf(t * 0.5f, &s, &c);
+    s /= length;
+    out[0] = v[0] * s;
+    out[1] = v[1] * s;
+    out[2] = v[2] * s;
+    out[3] = c;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpQuaternionMakeEuler(QUATERNION out, float x, float y, float z)
+ *
+ * Make a quaternion from Euler angles in radians, with YXZ sequence
+ * as objects do, i.e. rotate about z first, then x, then y.
+ */
+void SrpQuaternionMakeEuler(QUATERNION out, float x, float y, float z)
+{
+    float sx, cx, sy, cy, sz, cz;
+
+    SrpMathSinCosf(x * 0.5f, &sx, &cx);
+    SrpMathSinCosf(y * 0.5f, &sy, &cy);
+    SrpMathSinCosf(z * 0.5f, &sz, &cz);
+
+    /* Expanded form of qy * qx * qz */
+    out[0] = cy * sx * cz + sy * cx * sz;
+    out[1] = sy * cx * cz - cy * sx * sz;
+    out[2] = cy * cx * sz - sy * sx * cz;
+    out[3] = cy * cx * cz + sy * sx * sz;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpQuaternionMultiply(QUATERNION out, const QUATERNION a, 
+ *                            const QUATERNION b)
+ *
+ * Quaternion multiplication. out = a * b.
+ * Rotating by out is rotating by b first, then by a.
+ */
+void SrpQuaternionMultiply(QUATERNION out, const QUATERNION a, 
+                           const QUATERNION b)
+{
+    QUATERNION temp;
+
+    /* w = wa * wb - va . vb, v = wa * vb + wb * va + va X vb */
+    temp[0] = a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1];
+    temp[1] = a[3] * b[1] + a[1] * b[3] + a[2] * b[0] - a[0] * b[2];
+    temp[2] = a[3] * b[2] + a[2] * b[3] + a[0] * b[1] - a[1] * b[0];
+    temp[3] = a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2];
+
+    SrpQuaternionCopy(out, temp);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpQuaternionNormalize(QUATERNION out, const QUATERNION q)
+ *
+ * Normalize quaternion q, store it in quaternion out.
+ */
+void SrpQuaternionNormalize(QUATERNION out, const QUATERNION q)
+{
+    float length, oneDivLength;
+
+    length = sqrtf(SrpQuaternionDotProduct(q, q));
+    if (length < EPSILON_E6F)
+    {
+        ASSERTMSG(FALSE, 
+                  "SrpQuaternionNormalize: input quaternion is zero.");
+        SrpQuaternionLoadIdentity(out);
+        return;
+    }
+
+    oneDivLength = 1.0f / length;
+    out[0] = q[0] * oneDivLength;
+    out[1] = q[1] * oneDivLength;
+    out[2] = q[2] * oneDivLength;
+    out[3] = q[3] * oneDivLength;
+}
+
+/*------------------------------------------------------------------------------
+ * float SrpQuaternionDotProduct(const QUATERNION a, const QUATERNION b)
+ *
+ * Dot product.
+ */
+float SrpQuaternionDotProduct(const QUATERNION a, const QUATERNION b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpQuaternionNlerp(QUATERNION out, const QUATERNION a, 
+ *                         const QUATERNION b, float t)
+ * void SrpQuaternionSlerp(QUATERNION out, const QUATERNION a, 
+ *                         const QUATERNION b, float t)
+ *
+ * Interpolate between unit quaternions a and b, t in [0, 1].
+ * q and -q are the same rotation, b is negated if that makes 
+ * the arc shorter.
+ */
+void SrpQuaternionNlerp(QUATERNION out, const QUATERNION a, 
+                        const QUATERNION b, float t)
+{
+    float ta, tb;
+
+    ta = 1.0f - t;
+    tb = SrpQuaternionDotProduct(a, b) < 0.0f ? -t : t;
+
+    out[0] = a[0] * ta + b[0] * tb;
+    out[1] = a[1] * ta + b[1] * tb;
+    out[2] = a[2] * ta + b[2] * tb;
+    out[3] = a[3] * ta + b[3] * tb;
+
+    SrpQuaternionNormalize(out, out);
+}
+
+void SrpQuaternionSlerp(QUATERNION out, const QUATERNION a, 
+                        const QUATERNION b, float t)
+{
+    float cosTheta, theta, oneDivSin, ta, tb;
+
+    cosTheta = SrpQuaternionDotProduct(a, b);
+    if (fabsf(cosTheta) > QUATERNION_SLERP_MAX_DOT)
+    {
+        SrpQuaternionNlerp(out, a, b, t);
+        return;
+    }
+
+    theta = acosf(fabsf(cosTheta));
+    oneDivSin = 1.0f / sinf(theta);
+    ta = sinf((1.0f - t) * theta) * oneDivSin;
+    tb = sinf(t * theta) * oneDivSin;
+    if (cosTheta < 0.0f)
+    {
+        tb = -tb;
+    }
+
+    out[0] = a[0] * ta + b[0] * tb;
+    out[1] = a[1] * ta + b[1] * tb;
+    out[2] = a[2] * ta + b[2] * tb;
+    out[3] = a[3] * ta + b[3] * tb;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpQuaternionToMatrix43f(MATRIX43F out, const QUATERNION q)
+ *
+ * Make a 'pure' rotation matrix from a unit quaternion, the same matrix
+ * SrpMatrixMakeRotation43f makes for the same axis and angle.
+ */
+void SrpQuaternionToMatrix43f(MATRIX43F out, const QUATERNION q)
+{
+    float xx, yy, zz, xy, xz, yz, wx, wy, wz;
+
+    xx = 2.0f * q[0] * q[0];
+    yy = 2.0f * q[1] * q[1];
+    zz = 2.0f * q[2] * q[2];
+
+    xy = 2.0f * q[0] * q[1];
+    xz = 2.0f * q[0] * q[2];
+    yz = 2.0f * q[1] * q[2];
+
+    wx = 2.0f * q[3] * q[0];
+    wy = 2.0f * q[3] * q[1];
+    wz = 2.0f * q[3] * q[2];
+
+    /* Fill in the linear transformation portion. */
+    out[0] = 1.0f - yy - zz;  out[1] = xy + wz;  out[2] = xz - wy;
+    out[3] = xy - wz;  out[4] = 1.0f - xx - zz;  out[5] = yz + wx;
+    out[6] = xz + wy;  out[7] = yz - wx;  out[8] = 1.0f - xx - yy;
+
+    /* Set the translation portion to zero. */
+    out[9] = 0.0f; out[10] = 0.0f; out[11] = 0.0f;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpQuaternionPrint(const QUATERNION q, const char *name)
+ *
+ * Print quaternion q.
+ */
+void SrpQuaternionPrint(const QUATERNION q, const char *name)
+{
+    printf("Print Quaternion:\n\t%s = (%f, %f, %f, %f)\n", 
+           name, q[0], q[1], q[2], q[3]);
+}
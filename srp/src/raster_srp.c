@@ -7,8 +7,13 @@
  ******************************************************************************/
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <memory.h>
+#include <time.h>
 #include "datadef_srp.h"
 #include "assert_ig.h"
+#include "malloc_ig.h"
+#include "math_srp.h"
 #include "raster_srp.h"
 #include "rcmanager_srp.h"
 
@@ -16,29 +21,166 @@
 /*                               Data Structure                               */
 /*----------------------------------------------------------------------------*/
 
+/*
+ * An edge being walked down, one scanline at a time. Built with 
+ * SRP_FIXED_POINT, x is 16.16 fixed point with the rounding to pixels 
+ * folded in, and what 16 bits of fraction lose of dx / dy is carried 
+ * as a remainder, Bresenham style. x is then exactly the edge's, 
+ * rounded down to 1/65536, on every scanline, and no float is touched.
+ */
+#if defined(SRP_FIXED_POINT)
+struct EDGE_T
+{
+    FIXED16 x;
+    FIXED16 step;         /* dx / dy, rounded down */
+    int rem;              /* What step lacks, in 1/dy of 1/65536 */
+    int err;
+    int dy;
+};
+#else
+struct EDGE_T
+{
+    float x;
+    float step;           /* Not realy slope, is actually dx / dy */
+};
+#endif
+
+typedef struct EDGE_T EDGE;
+
 /*----------------------------------------------------------------------------*/
 /*                                Private Data                                */
 /*----------------------------------------------------------------------------*/
 
+/* Seed of the generator SrpRasterCheck draws its shapes with */
+static unsigned int sg_rasterSeed = 1;
+
 /*----------------------------------------------------------------------------*/
 /*                       Private Function Declarations                        */
 /*----------------------------------------------------------------------------*/
 
+static void SrpEdgeInit(EDGE *pEdge, int x, int dx, int dy);
+static void SrpEdgeStep(EDGE *pEdge);
+static void SrpEdgeAdvance(EDGE *pEdge, int n);
+static int SrpEdgeGetX(const EDGE *pEdge);
 static int SrpCheckPointBuffer(const POINT2I *pBuffer, int count);
 static int SrpPolygonIsHorizontalLine(const POINT2I *pBuffer, int count);
 static int SrpPolygonIsVerticalLine(const POINT2I *pBuffer, int count);
 static void SrpDrawHorizontalLine(int xStart, int xEnd, int y);
+static void SrpMarkLineDirty(int x0, int y0, int x1, int y1);
 static void SrpDrawTriangleBottomFlat(int xTop, int yTop, 
                                       int xLeft, int yLeft, 
                                       int xRight, int yRight);
 static void SrpDrawTriangleTopFlat(int xLeft, int yLeft, 
                                    int xRight, int yRight,
                                    int xBottom, int yBottom);
+static int SrpRasterRandom(int range);
+static int SrpRasterExactX(int xa, int ya, int xb, int yb, int y);
+static void SrpRasterReferenceSpan(unsigned char *pMask, int width, 
+                                   int xStart, int xEnd, int y);
+static void SrpRasterReferencePolygon(unsigned char *pMask, int width, 
+                                      const POINT2I *pBuffer, int count);
+static void SrpRasterReferenceLine(unsigned char *pMask, int width, 
+                                   int x0, int y0, int x1, int y1);
+static int SrpRasterCountOff(const unsigned char *pMask, 
+                             const POINT2I *pBuffer, int count);
 
 /*----------------------------------------------------------------------------*/
 /*                             Private Functions                              */
 /*----------------------------------------------------------------------------*/
 
+/*------------------------------------------------------------------------------
+ * static void SrpEdgeInit(EDGE *pEdge, int x, int dx, int dy)
+ *
+ * Start an edge at x, going dx for every dy scanlines.
+ */
+static void SrpEdgeInit(EDGE *pEdge, int x, int dx, int dy)
+{
+#if defined(SRP_FIXED_POINT)
+    FIXED16 n;
+
+    ASSERTMSG(dy != 0, "SrpEdgeInit: invalid arguments.");
+
+    if (dy < 0)
+    {
+        dx = -dx;
+        dy = -dy;
+    }
+
+    /* Round step down, so that the remainder is never negative */
+    n = SrpFixedFromInt(dx);
+    pEdge->step = n / dy;
+    pEdge->rem = n % dy;
+    if (pEdge->rem < 0)
+    {
+        pEdge->step--;
+        pEdge->rem += dy;
+    }
+
+    pEdge->x = SrpFixedFromInt(x) + FIXED16_HALF;
+    pEdge->err = 0;
+    pEdge->dy = dy;
+#else
+    pEdge->x = (float)x;
+    pEdge->step = (float)dx / (float)dy;
+#endif
+}
+
+/*------------------------------------------------------------------------------
+ * static void SrpEdgeStep(EDGE *pEdge)
+ *
+ * Move an edge down a scanline.
+ */
+static void SrpEdgeStep(EDGE *pEdge)
+{
+    pEdge->x = pEdge->x + pEdge->step;
+
+#if defined(SRP_FIXED_POINT)
+    {
+        int carry;
+
+        /* Carry a unit when the remainder overflows, without a branch 
+         * to mispredict on every other scanline.
+         */
+        pEdge->err += pEdge->rem - pEdge->dy;
+        carry = -(pEdge->err >= 0);
+        pEdge->x -= carry;
+        pEdge->err += pEdge->dy & ~carry;
+    }
+#endif
+}
+
+/*------------------------------------------------------------------------------
+ * static void SrpEdgeAdvance(EDGE *pEdge, int n)
+ *
+ * Move an edge down n scanlines at once.
+ */
+static void SrpEdgeAdvance(EDGE *pEdge, int n)
+{
+#if defined(SRP_FIXED_POINT)
+    int err;
+
+    err = pEdge->err + pEdge->rem * n;
+    pEdge->x = pEdge->x + pEdge->step * n + err / pEdge->dy;
+    pEdge->err = err % pEdge->dy;
+#else
+    pEdge->x = pEdge->step * (float)n + pEdge->x;
+#endif
+}
+
+/*------------------------------------------------------------------------------
+ * static int SrpEdgeGetX(const EDGE *pEdge)
+ *
+ * Get the pixel an edge is on.
+ */
+static int SrpEdgeGetX(const EDGE *pEdge)
+{
+#if defined(SRP_FIXED_POINT)
+    return SrpFixedToInt(pEdge->x);
+#else
+    return ROUND2INT(pEdge->x);
+#endif
+}
+
 /*------------------------------------------------------------------------------
  * static int SrpCheckPointBuffer(const POINT2I *pBuffer, int count)
  *
@@ -122,7 +264,6 @@ static int SrpPolygonIsVerticalLine(const POINT2I *pBuffer, int count)
 static void SrpDrawHorizontalLine(int xStart, int xEnd, int y)
 {
     int xLeft, xRight;
-    int i;
 
 #ifndef NDEBUG
     POINT2I pointList[2] = {{xStart, y}, {xEnd, y}};
@@ -143,10 +284,46 @@ static void SrpDrawHorizontalLine(int xStart, int xEnd, int y)
         xRight = xEnd;
     }
 
-    for (i = xLeft; i <= xRight; i++)
+    SrpRCSetSpan(y * SrpRCGetPitch() + xLeft * SrpRCGetBit() / 8, 
+                 xRight - xLeft + 1);
+}
+
+/*------------------------------------------------------------------------------
+ * static void SrpMarkLineDirty(int x0, int y0, int x1, int y1)
+ *
+ * This function marks the tiles a line is drawn on as dirty, a piece of 
+ * a tile's length at a time, so a long slanted line doesn't mark all 
+ * of its bounding box. Pieces are marked a pixel wider for rounding.
+ */
+static void SrpMarkLineDirty(int x0, int y0, int x1, int y1)
+{
+    int i, steps;
+    int xa, ya, xb, yb;
+
+    steps = abs(x1 - x0) > abs(y1 - y0) ? abs(x1 - x0) : abs(y1 - y0);
+
+    xa = x0;
+    ya = y0;
+    i = 0;
+    do
     {
-        SrpDrawPixel(i, y);
-    }
+        i += SRP_DIRTY_TILE_SIZE;
+        if (i >= steps)
+        {
+            xb = x1;
+            yb = y1;
+        }
+        else
+        {
+            xb = x0 + (x1 - x0) * i / steps;
+            yb = y0 + (y1 - y0) * i / steps;
+        }
+
+        SrpRCMarkDirty(xa < xb ? xa - 1 : xb - 1, ya < yb ? ya - 1 : yb - 1, 
+                       xa > xb ? xa + 1 : xb + 1, ya > yb ? ya + 1 : yb + 1);
+        xa = xb;
+        ya = yb;
+    } while (i < steps);
 }
 
 /*------------------------------------------------------------------------------
@@ -164,15 +341,12 @@ static void SrpDrawTriangleBottomFlat(int xTop, int yTop,
                                       int xLeft, int yLeft, 
                                       int xRight, int yRight)
 {
-    /* The start and end of a horizontal line. */
-    float xStart, xEnd;
+    /* The edges a horizontal line starts and ends on. */
+    EDGE left, right;
 
     /* Current y position of a horizontal line. */
     int yPos;
 
-    /* Not realy slope, is actually dx / dy, used to increase x. */
-    float slopeLeft, slopeRight;
-
     POINT2I pointList[3] = {{xTop, yTop}, {xLeft, yLeft}, {xRight, yRight}};
 
 #ifndef NDEBUG
@@ -198,18 +372,15 @@ SrpDrawTriangleBottomFlat().\n");
         return;
     }
 
-    slopeLeft = (float)(xLeft - xTop) / (float)(yLeft - yTop);
-    slopeRight = (float)(xRight - xTop) / (float)(yRight - yTop);
-
-    xStart = xTop;
-    xEnd = xTop;
+    SrpEdgeInit(&left, xTop, xLeft - xTop, yLeft - yTop);
+    SrpEdgeInit(&right, xTop, xRight - xTop, yRight - yTop);
 
     for (yPos = yTop; yPos <= yLeft; yPos++)
     {
-        SrpDrawHorizontalLine(ROUND2INT(xStart), ROUND2INT(xEnd), yPos);
+        SrpDrawHorizontalLine(SrpEdgeGetX(&left), SrpEdgeGetX(&right), yPos);
 
-        xStart = xStart + slopeLeft;
-        xEnd = xEnd + slopeRight;
+        SrpEdgeStep(&left);
+        SrpEdgeStep(&right);
     }
 }
 
@@ -228,15 +399,12 @@ static void SrpDrawTriangleTopFlat(int xLeft, int yLeft,
                                    int xRight, int yRight,
                                    int xBottom, int yBottom)
 {
-    /* The start and end of a horizontal line. */
-    float xStart, xEnd;
+    /* The edges a horizontal line starts and ends on. */
+    EDGE left, right;
 
     /* Current y position of a horizontal line. */
     int yPos;
 
-    /* Not realy slope, is actually dx / dy, used to increase x. */
-    float slopeLeft, slopeRight;
-
     POINT2I pointList[3] = {{xLeft, yLeft}, {xRight, yRight}, 
                             {xBottom, yBottom}};
 
@@ -263,19 +431,250 @@ SrpDrawTriangleTopFlat().\n");
         return;
     }
 
-    slopeLeft = (float)(xBottom - xLeft) / (float)(yBottom - yLeft);
-    slopeRight = (float)(xBottom - xRight) / (float)(yBottom - yRight);
-
-    xStart = xLeft;
-    xEnd = xRight;
+    SrpEdgeInit(&left, xLeft, xBottom - xLeft, yBottom - yLeft);
+    SrpEdgeInit(&right, xRight, xBottom - xRight, yBottom - yRight);
 
     for (yPos = yLeft; yPos <= yBottom; yPos++)
     {
-        SrpDrawHorizontalLine(ROUND2INT(xStart), ROUND2INT(xEnd), yPos);
+        SrpDrawHorizontalLine(SrpEdgeGetX(&left), SrpEdgeGetX(&right), yPos);
+
+        SrpEdgeStep(&left);
+        SrpEdgeStep(&right);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * static int SrpRasterRandom(int range)
+ *
+ * A number in [0, range) from a generator of its own, so SrpRasterCheck 
+ * draws the same shapes everywhere.
+ */
+static int SrpRasterRandom(int range)
+{
+    sg_rasterSeed = sg_rasterSeed * 1103515245u + 12345u;
+    return (int)((sg_rasterSeed >> 16) % (unsigned int)range);
+}
+
+/*------------------------------------------------------------------------------
+ * static int SrpRasterExactX(int xa, int ya, int xb, int yb, int y)
+ *
+ * Get the x of the edge from (xa, ya) to (xb, yb) on scanline y, rounded 
+ * half up, in integers with no error.
+ */
+static int SrpRasterExactX(int xa, int ya, int xb, int yb, int y)
+{
+    int dx, dy, n, x;
+
+    dx = xb - xa;
+    dy = yb - ya;
+    if (dy < 0)
+    {
+        dx = -dx;
+        dy = -dy;
+    }
+
+    /* floor(xa + (y - ya) * dx / dy + 1 / 2) */
+    n = 2 * xa * dy + 2 * (y - ya) * dx + dy;
+    x = n / (2 * dy);
+    if (n % (2 * dy) < 0)
+    {
+        x--;
+    }
+
+    return x;
+}
+
+/*------------------------------------------------------------------------------
+ * static void SrpRasterReferenceSpan(unsigned char *pMask, int width, 
+ *                                    int xStart, int xEnd, int y)
+ *
+ * Mark the pixels from xStart to xEnd on scanline y, either way round.
+ */
+static void SrpRasterReferenceSpan(unsigned char *pMask, int width, 
+                                   int xStart, int xEnd, int y)
+{
+    int x, temp;
+
+    if (xStart > xEnd)
+    {
+        temp = xStart;
+        xStart = xEnd;
+        xEnd = temp;
+    }
+
+    for (x = xStart; x <= xEnd; x++)
+    {
+        pMask[y * width + x] = 1;
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * static void SrpRasterReferencePolygon(unsigned char *pMask, int width, 
+ *                                       const POINT2I *pBuffer, int count)
+ *
+ * Mark the pixels SrpDrawPolygonFill should fill, walking the same 
+ * edges down from the top point, but with SrpRasterExactX for x.
+ */
+static void SrpRasterReferencePolygon(unsigned char *pMask, int width, 
+                                      const POINT2I *pBuffer, int count)
+{
+    int leftStart, leftEnd, rightStart, rightEnd;
+    int top, bottom;
+    int i, y;
+
+    top = bottom = 0;
+    for (i = 1; i < count; i++)
+    {
+        top = pBuffer[i].y < pBuffer[top].y ? i : top;
+        bottom = pBuffer[i].y > pBuffer[bottom].y ? i : bottom;
+    }
+
+    leftStart = leftEnd = rightStart = rightEnd = top;
+    for (y = pBuffer[top].y; y <= pBuffer[bottom].y; y++)
+    {
+        if (y >= pBuffer[leftEnd].y)
+        {
+            while (TRUE)
+            {
+                leftStart = leftEnd;
+                leftEnd = (leftStart - 1 + count) % count;
+
+                if (pBuffer[leftStart].y != pBuffer[leftEnd].y)
+                {
+                    break;
+                }
+            }
+        }
+
+        if (y >= pBuffer[rightEnd].y)
+        {
+            while (TRUE)
+            {
+                rightStart = rightEnd;
+                rightEnd = (rightStart + 1) % count;
+
+                if (pBuffer[rightStart].y != pBuffer[rightEnd].y)
+                {
+                    break;
+                }
+            }
+        }
+
+        SrpRasterReferenceSpan(pMask, width, 
+            SrpRasterExactX(pBuffer[leftStart].x, pBuffer[leftStart].y, 
+                            pBuffer[leftEnd].x, pBuffer[leftEnd].y, y), 
+            SrpRasterExactX(pBuffer[rightStart].x, pBuffer[rightStart].y, 
+                            pBuffer[rightEnd].x, pBuffer[rightEnd].y, y), 
+            y);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * static void SrpRasterReferenceLine(unsigned char *pMask, int width, 
+ *                                    int x0, int y0, int x1, int y1)
+ *
+ * Mark the pixels SrpDrawLine should draw. Along the major axis, the 
+ * minor coordinate steps once the true line is more than half a pixel 
+ * past it.
+ */
+static void SrpRasterReferenceLine(unsigned char *pMask, int width, 
+                                   int x0, int y0, int x1, int y1)
+{
+    int dx, dy, xInc, yInc;
+    int i, x, y;
+
+    dx = abs(x1 - x0);
+    dy = abs(y1 - y0);
+    xInc = x1 < x0 ? -1 : 1;
+    yInc = y1 < y0 ? -1 : 1;
+
+    x = y = 0;
+    if (dx > dy)
+    {
+        for (i = 0; i <= dx; i++)
+        {
+            pMask[(y0 + y * yInc) * width + x0 + x * xInc] = 1;
+            if (2 * x * dy - 2 * y * dx > dx)
+            {
+                y++;
+            }
+            x++;
+        }
+    }
+    else if (dy > dx)
+    {
+        for (i = 0; i <= dy; i++)
+        {
+            pMask[(y0 + y * yInc) * width + x0 + x * xInc] = 1;
+            if (2 * y * dx - 2 * x * dy > dy)
+            {
+                x++;
+            }
+            y++;
+        }
+    }
+    else
+    {
+        for (i = 0; i <= dx; i++)
+        {
+            pMask[(y0 + i * yInc) * width + x0 + i * xInc] = 1;
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * static int SrpRasterCountOff(const unsigned char *pMask, 
+ *                              const POINT2I *pBuffer, int count)
+ *
+ * Count the pixels of the buffer that are drawn, any byte not zero, where 
+ * the mask is not set, or the other way round. Only the bounding box of 
+ * the first 'count' points in 'pBuffer', a pixel wider all round, is 
+ * looked at.
+ */
+static int SrpRasterCountOff(const unsigned char *pMask, 
+                             const POINT2I *pBuffer, int count)
+{
+    const unsigned char *pTarget, *pPixel;
+    int width, pitch, bytes;
+    int xMin, yMin, xMax, yMax;
+    int x, y, i, drawn, off;
+
+    width = SrpRCGetWidth();
+    pitch = SrpRCGetPitch();
+    bytes = SrpRCGetBit() / 8;
+    pTarget = SrpRCGetBuffer();
+
+    xMin = xMax = pBuffer[0].x;
+    yMin = yMax = pBuffer[0].y;
+    for (i = 1; i < count; i++)
+    {
+        xMin = pBuffer[i].x < xMin ? pBuffer[i].x : xMin;
+        xMax = pBuffer[i].x > xMax ? pBuffer[i].x : xMax;
+        yMin = pBuffer[i].y < yMin ? pBuffer[i].y : yMin;
+        yMax = pBuffer[i].y > yMax ? pBuffer[i].y : yMax;
+    }
+    xMin = xMin > 0 ? xMin - 1 : 0;
+    yMin = yMin > 0 ? yMin - 1 : 0;
+    xMax = xMax < width - 1 ? xMax + 1 : width - 1;
+    yMax = yMax < SrpRCGetHeight() - 1 ? yMax + 1 : SrpRCGetHeight() - 1;
+
+    off = 0;
+    for (y = yMin; y <= yMax; y++)
+    {
+        for (x = xMin; x <= xMax; x++)
+        {
+            pPixel = pTarget + y * pitch + x * bytes;
+            drawn = FALSE;
+            for (i = 0; i < bytes; i++)
+            {
+                drawn = drawn || pPixel[i] != 0;
+            }
 
-        xStart = xStart + slopeLeft;
-        xEnd = xEnd + slopeRight;
+            off += drawn != (pMask[y * width + x] != 0);
+        }
     }
+
+    return off;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -302,6 +701,7 @@ void SrpDrawPixel(int x, int y)
     offset = y * SrpRCGetPitch() + x * SrpRCGetBit() / 8;
 
     SrpRCSetPixel(offset);
+    SrpRCMarkDirty(x, y, x, y);
 }
 
 /*------------------------------------------------------------------------------
@@ -317,7 +717,11 @@ void SrpDrawLine(int x0, int y0, /* starting position */
     int xOffset, yOffset;
     size_t totalOffset;
     int xInc, yInc;
+#if defined(SRP_FIXED_POINT)
+    int error; /* (offset * slope - offset' - 0.5) * 2 * max(|dx|, |dy|) */
+#else
     float slope; /* not really slope, min(|dx|, |dy|) / max(|dx|, |dy|) */
+#endif
     
 #ifndef NDEBUG
     POINT2I pointList[2] = {{x0, y0}, {x1, y1}};
@@ -356,6 +760,25 @@ void SrpDrawLine(int x0, int y0, /* starting position */
     
     if (dx > dy)
     {
+#if defined(SRP_FIXED_POINT)
+        error = -dx;
+        for (i = 0; i <= dx; i++)
+        {
+            SrpRCSetPixel(totalOffset);
+
+            /* The float test, xOffset * slope - yOffset > 0.5 */
+            if (error > 0)
+            {
+                totalOffset += yInc;
+                yOffset++;
+                error -= 2 * dx;
+            }
+
+            totalOffset += xInc;
+            xOffset++;
+            error += 2 * dy;
+        }
+#else
         slope = (float)dy / (float)dx;
         for (i = 0; i <= dx; i++)
         {
@@ -375,10 +798,29 @@ void SrpDrawLine(int x0, int y0, /* starting position */
             totalOffset += xInc;
             xOffset++;
         }
+#endif
     }
     else
     if (dy > dx)
     {
+#if defined(SRP_FIXED_POINT)
+        error = -dy;
+        for (i = 0; i <= dy; i++)
+        {
+            SrpRCSetPixel(totalOffset);
+
+            if (error > 0)
+            {
+                totalOffset += xInc;
+                xOffset++;
+                error -= 2 * dy;
+            }
+
+            totalOffset += yInc;
+            yOffset++;
+            error += 2 * dx;
+        }
+#else
         slope = (float)dx / (float)dy;
         for (i = 0; i <= dy; i++)
         {
@@ -398,6 +840,7 @@ void SrpDrawLine(int x0, int y0, /* starting position */
             totalOffset += yInc;
             yOffset++;
         }
+#endif
     }
     else
     {
@@ -415,6 +858,8 @@ void SrpDrawLine(int x0, int y0, /* starting position */
             yOffset++;
         }
     }
+
+    SrpMarkLineDirty(x0, y0, x1, y1);
 }
 
 /*------------------------------------------------------------------------------
@@ -445,8 +890,9 @@ void SrpDrawTriangleWire(int x0, int y0, int x1, int y1, int x2, int y2)
 void SrpDrawTriangleFill(int x0, int y0, int x1, int y1, int x2, int y2)
 {
     int temp;
-    float xNewf;
-    int xNewi;
+    int xNew;
+    int xMin, xMax;
+    EDGE edge;
     POINT2I pointList[3] = {{x0, y0}, {x1, y1}, {x2, y2}};
 
 #ifndef NDEBUG
@@ -503,6 +949,13 @@ SrpDrawTriangleFill().\n");
         y2 = temp;
     }
 
+    /* Its bounding box, y0 to y2 once sorted */
+    xMin = x0 < x1 ? x0 : x1;
+    xMin = x2 < xMin ? x2 : xMin;
+    xMax = x0 > x1 ? x0 : x1;
+    xMax = x2 > xMax ? x2 : xMax;
+    SrpRCMarkDirty(xMin, y0, xMax, y2);
+
     if (y0 == y1)
     {
         SrpDrawTriangleTopFlat(x0, y0, x1, y1, x2, y2);
@@ -513,12 +966,13 @@ SrpDrawTriangleFill().\n");
     }
     else
     {
-        xNewf = (float)(x2 - x0) / (float)(y2 - y0) * (float)(y1 - y0) +
-            (float)x0;
-        xNewi = ROUND2INT(xNewf);
+        /* Where the long edge crosses y1 */
+        SrpEdgeInit(&edge, x0, x2 - x0, y2 - y0);
+        SrpEdgeAdvance(&edge, y1 - y0);
+        xNew = SrpEdgeGetX(&edge);
 
-        SrpDrawTriangleBottomFlat(x0, y0, x1, y1, xNewi, y1);
-        SrpDrawTriangleTopFlat(xNewi, y1, x1, y1, x2, y2);
+        SrpDrawTriangleBottomFlat(x0, y0, x1, y1, xNew, y1);
+        SrpDrawTriangleTopFlat(xNew, y1, x1, y1, x2, y2);
     }
 }
 
@@ -567,8 +1021,8 @@ void SrpDrawPolygonFill(const POINT2I *pBuffer, int count)
      */
     int indexLeftStart, indexLeftEnd, indexRightStart, indexRightEnd;
 
-    /* The start and end of a horizontal line. */
-    float xStart, xEnd;
+    /* The edges a horizontal line starts and ends on. */
+    EDGE left, right;
 
     /* Current y distance to the top point. */
     int yOffset;
@@ -576,11 +1030,9 @@ void SrpDrawPolygonFill(const POINT2I *pBuffer, int count)
     /* The index of the top point and bottom point. */
     int indexTop, indexBottom;
 
-    /* Not realy slope, is actually dx / dy, used to increase x. */
-    float slopeLeft, slopeRight;
-
     int dx, dy;
     int i;
+    int xMin, xMax;
 
     ASSERTMSG(pBuffer != NULL && count > 0, 
         "SrpDrawPolygonFill: invalid arguments.");
@@ -609,6 +1061,7 @@ SrpDrawPolygonFill().\n");
      * and the bottom point, whose y is the biggest.
      */
     indexTop = indexBottom = 0;
+    xMin = xMax = pBuffer[0].x;
     for (i = 1; i < count; i++)
     {
         if (pBuffer[i].y < pBuffer[indexTop].y)
@@ -620,8 +1073,13 @@ SrpDrawPolygonFill().\n");
         {
             indexBottom = i;
         }
+
+        xMin = pBuffer[i].x < xMin ? pBuffer[i].x : xMin;
+        xMax = pBuffer[i].x > xMax ? pBuffer[i].x : xMax;
     }
 
+    SrpRCMarkDirty(xMin, pBuffer[indexTop].y, xMax, pBuffer[indexBottom].y);
+
     /* Initialize left and right edges with the top point's index */
     indexLeftStart = indexLeftEnd = indexTop;
     indexRightStart = indexRightEnd = indexTop;
@@ -633,8 +1091,8 @@ SrpDrawPolygonFill().\n");
     {
         if (yOffset >= pBuffer[indexLeftEnd].y)
         {
-            /* Left side edge is finished. Update indice, xStart,
-             * and calculate the new slope.
+            /* Left side edge is finished. Update indice, and 
+             * start the new edge.
              */
 
             /* Ignore those points whose y is equal with their
@@ -654,14 +1112,13 @@ SrpDrawPolygonFill().\n");
 
             dx = pBuffer[indexLeftEnd].x - pBuffer[indexLeftStart].x;
             dy = pBuffer[indexLeftEnd].y - pBuffer[indexLeftStart].y;
-            slopeLeft = (float)dx / (float)dy;
-            xStart = pBuffer[indexLeftStart].x;
+            SrpEdgeInit(&left, pBuffer[indexLeftStart].x, dx, dy);
         }
 
         if (yOffset >= pBuffer[indexRightEnd].y)
         {
-            /* Right side edge is finished. Update indice, xEnd,
-             * and calculate the new slope.
+            /* Right side edge is finished. Update indice, and 
+             * start the new edge.
              */
 
             /* Ignore those points for the same reason. */
@@ -678,18 +1135,128 @@ SrpDrawPolygonFill().\n");
 
             dx = pBuffer[indexRightEnd].x - pBuffer[indexRightStart].x;
             dy = pBuffer[indexRightEnd].y - pBuffer[indexRightStart].y;
-            slopeRight = (float)dx / (float)dy;
-            xEnd = pBuffer[indexRightStart].x;
+            SrpEdgeInit(&right, pBuffer[indexRightStart].x, dx, dy);
         }
 /*
         printf("%d, ", yOffset);
         printf("ls=%d, le=%d, rs=%d, re=%d, ", indexLeftStart, indexLeftEnd,
                indexRightStart, indexRightEnd);
-        printf("xStart=%f, xEnd=%f\n", xStart, xEnd);
+        printf("xStart=%d, xEnd=%d\n", 
+               SrpEdgeGetX(&left), SrpEdgeGetX(&right));
 */
-        SrpDrawHorizontalLine(ROUND2INT(xStart), ROUND2INT(xEnd), yOffset);
+        SrpDrawHorizontalLine(SrpEdgeGetX(&left), SrpEdgeGetX(&right), 
+                              yOffset);
+
+        SrpEdgeStep(&left);
+        SrpEdgeStep(&right);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpRasterCheck(int count)
+ *
+ * Draw count random triangles and lines on the current rendering context, 
+ * each on a cleared buffer, and compare them pixel by pixel with a 
+ * reference in exact integers. Then draw them again without clearing, 
+ * and print how long a triangle and a line take on average.
+ */
+int SrpRasterCheck(int count)
+{
+    unsigned char *pMask;
+    POINT2I tri[3];
+    int width, height, size;
+    int i, k, polygonsOff, linesOff, drawn;
+    clock_t start;
+    double polygonTime, lineTime;
+
+    ASSERTMSG(count > 0, "SrpRasterCheck: invalid arguments.");
+
+    width = SrpRCGetWidth();
+    height = SrpRCGetHeight();
+    size = width * height;
+    if (!IgNewMemory((void**)&pMask, size))
+    {
+        printf("Error: out of memory in SrpRasterCheck().\n");
+        return FALSE;
+    }
+
+    SrpRCSetClearColor(0, 0, 0, 0);
+    SrpRCSetDrawColor(255, 255, 255, 255);
+
+    /* Compare with the reference */
+    sg_rasterSeed = 1;
+    polygonsOff = linesOff = drawn = 0;
+    for (i = 0; i < count; i++)
+    {
+        for (k = 0; k < 3; k++)
+        {
+            tri[k].x = SrpRasterRandom(width);
+            tri[k].y = SrpRasterRandom(height);
+        }
+
+        /* Those with no area are lines SrpDrawPolygonFill may skip */
+        if ((tri[1].x - tri[0].x) * (tri[2].y - tri[0].y) == 
+            (tri[2].x - tri[0].x) * (tri[1].y - tri[0].y))
+        {
+            continue;
+        }
+        drawn++;
+
+        SrpRCClear();
+        memset(pMask, 0, size);
+        SrpDrawPolygonFill(tri, 3);
+        SrpRasterReferencePolygon(pMask, width, tri, 3);
+        polygonsOff += SrpRasterCountOff(pMask, tri, 3) != 0;
+
+        SrpRCClear();
+        memset(pMask, 0, size);
+        SrpDrawLine(tri[0].x, tri[0].y, tri[1].x, tri[1].y);
+        SrpRasterReferenceLine(pMask, width, 
+                               tri[0].x, tri[0].y, tri[1].x, tri[1].y);
+        linesOff += SrpRasterCountOff(pMask, tri, 2) != 0;
+    }
+
+    IgFreeMemory(pMask);
 
-        xStart = xStart + slopeLeft;
-        xEnd = xEnd + slopeRight;
+    /* Time the same shapes */
+    sg_rasterSeed = 1;
+    SrpRCClear();
+    start = clock();
+    for (i = 0; i < count; i++)
+    {
+        for (k = 0; k < 3; k++)
+        {
+            tri[k].x = SrpRasterRandom(width);
+            tri[k].y = SrpRasterRandom(height);
+        }
+
+        if ((tri[1].x - tri[0].x) * (tri[2].y - tri[0].y) != 
+            (tri[2].x - tri[0].x) * (tri[1].y - tri[0].y))
+        {
+            SrpDrawPolygonFill(tri, 3);
+        }
+    }
+    polygonTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    sg_rasterSeed = 1;
+    start = clock();
+    for (i = 0; i < count; i++)
+    {
+        for (k = 0; k < 3; k++)
+        {
+            tri[k].x = SrpRasterRandom(width);
+            tri[k].y = SrpRasterRandom(height);
+        }
+
+        SrpDrawLine(tri[0].x, tri[0].y, tri[1].x, tri[1].y);
     }
+    lineTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("Debug: %d of %d triangles and %d of %d lines off the reference, "
+           "%.0f ns a triangle and %.0f ns a line.\n", 
+           polygonsOff, drawn, linesOff, drawn, 
+           polygonTime * 1.0E9 / (drawn > 0 ? drawn : 1), 
+           lineTime * 1.0E9 / count);
+
+    return polygonsOff == 0 && linesOff == 0;
 }
@@ -11,10 +11,12 @@
 #include "datadef_ig.h"
 #include "assert_ig.h"
 #include "malloc_ig.h"
+#include "thread_ig.h"
 #include "rcmanager_srp.h"
 #include "datadef_srp.h"
 #include "matrix_srp.h"
 #include "frustum_srp.h"
+#include "simd_srp.h"
 
 /*----------------------------------------------------------------------------*/
 /*                               Data Structure                               */
@@ -25,6 +27,38 @@
 #define SRP_MAX_TEXTURE_STACK_DEPTH     4
 #define SRP_MAX_VIEWPORT_STACK_DEPTH    4
 
+/* Matrices derived from the stack tops, one bit each when out of date */
+#define SRP_DERIVED_MVP                 0x00000001
+#define SRP_DERIVED_MVPV                0x00000002
+#define SRP_DERIVED_INVERSE             0x00000004
+#define SRP_DERIVED_ALL                 0x00000007
+
+/* SRP_LAZY_CLEAR clears the buffer in tiles of 4 KB, about a page */
+#define SRP_CLEAR_TILE_SHIFT            12
+#define SRP_CLEAR_TILE_SIZE             (1 << SRP_CLEAR_TILE_SHIFT)
+
+/* Buffers from this size up are cleared past the caches, they wouldn't 
+ * stay there anyway.
+ */
+#define SRP_CLEAR_STREAM_SIZE           (256 * 1024)
+
+#define SRP_PALETTE_SIZE                256
+
+/* 
+ * How pixels of a format are made and stored, picked once when an RC is 
+ * created so there's no switch on the format for each pixel.
+ */
+struct SRP_PIXEL_FUNCS_T
+{
+    int format;
+    int bit;
+    unsigned int (*pfnPack)(const SRP_RC *pRC, 
+                            int red, int green, int blue, int alpha);
+    void (*pfnSetPixel)(unsigned char *pDest, unsigned int pixel);
+    void (*pfnSetSpan)(unsigned char *pDest, unsigned int pixel, int count);
+};
+typedef struct SRP_PIXEL_FUNCS_T SRP_PIXEL_FUNCS;
+
 struct SRP_TRANSFORM_ATTRIB_T
 {
     int matrixMode;
@@ -34,6 +68,13 @@ typedef struct SRP_TRANSFORM_ATTRIB_T SRP_TRANSFORM_ATTRIB;
 struct SRP_OBJECT_ATTRIB_T
 {
     int cullFlag;
+    int cullPlaneMask;  /* Frustum planes objects are tested against */
+    int lodFlag;
+    int meshletFlag;
+    int smallFlag;
+    int streamFlag;     /* Vertices go through SoA streams */
+    float smallPixels;  /* Objects smaller on screen are culled as small */
+    int smallMode;
 };
 typedef struct SRP_OBJECT_ATTRIB_T SRP_OBJECT_ATTRIB;
 
@@ -43,11 +84,18 @@ struct SRP_POLYGON_ATTRIB_T
 };
 typedef struct SRP_POLYGON_ATTRIB_T SRP_POLYGON_ATTRIB;
 
+struct SRP_BUFFER_ATTRIB_T
+{
+    int lazyClearFlag;
+};
+typedef struct SRP_BUFFER_ATTRIB_T SRP_BUFFER_ATTRIB;
+
 struct SRP_RC_T
 {
     int width;
     int height;
     int bit;
+    int format;
     int pitch;
     int size;
     
@@ -61,10 +109,32 @@ struct SRP_RC_T
     unsigned char drawBlue;
     unsigned char drawAlpha;
 
-    unsigned char *buffer;
-    unsigned char *clearBuffer; /* Buffer with the current clearing color,
-                                 * used for speeding up SrpRCClear()
+    unsigned char *buffer;      /* The back buffer, drawn on */
+    unsigned char *pBuffers[SRP_MAX_SWAP_BUFFERS];
+    int numBuffers;
+    int backIndex;
+    int frontIndex;             /* The last one swapped to the front */
+
+    const SRP_PIXEL_FUNCS *pPixelFuncs;
+    unsigned int drawPixel;     /* The drawing color in the pixel format */
+    unsigned int clearPixel;    /* The clearing color, as many pixels of it
+                                 * as fill 32 bits
                                  */
+    unsigned char palette[SRP_PALETTE_SIZE * 3]; /* For SRP_FORMAT_INDEX8 */
+
+    unsigned char *pTilePending; /* TRUE for tiles still to be cleared */
+    int numTiles;
+    int numPending;
+    int targetLocked;            /* Locked by SrpRCLockTarget */
+
+    /* Tiles of SRP_DIRTY_TILE_SIZE pixels square, one byte each */
+    int dirtyTilesX;
+    int dirtyTilesY;
+    unsigned char *pTileDirty;     /* Front buffer's, against the last */
+    unsigned char *pTileDrawn;     /* Drawn since the last swap */
+    unsigned char *pTileLastDrawn; /* Drawn before, since the last clear */
+    int frameCleared;              /* SrpRCClear called since the last swap */
+    int allDirty;                  /* All tiles dirty on the next swap */
 
     MATRIX43F fModelViewStack[SRP_MAX_MODELVIEW_STACK_DEPTH];
     MATRIX43F fProjectionStack[SRP_MAX_PROJECTION_STACK_DEPTH];
@@ -82,58 +152,116 @@ struct SRP_RC_T
     
     float fFovy;
     float fAspect;
+    MATRIX44F fProjection;       /* Camera space to clip space */
+
+    /* Derived matrices, recomputed only when asked for and dirty */
+    MATRIX44F fModelViewProj;          /* Modelview x projection */
+    MATRIX44F fModelViewProjViewport;  /* ... x viewport */
+    MATRIX43F fInvModelView;
+    MATRIX43F fNormalMatrix;     /* Inverse transpose of modelview */
+    int derivedDirty;            /* SRP_DERIVED_* bits out of date */
 
     FRUSTUM *pFrustum;
+    FRUSTUM *pWorldFrustum;      /* pFrustum in world space */
+    MATRIX43F fWorldFrustumView; /* Modelview pWorldFrustum is built with */
+    int worldFrustumValid;
 
     SRP_TRANSFORM_ATTRIB transformAttrib;
     SRP_OBJECT_ATTRIB    objectAttrib;
     SRP_POLYGON_ATTRIB   polygonAttrib;
+    SRP_BUFFER_ATTRIB    bufferAttrib;
 };
 
-typedef struct SRP_RC_T SRP_RC;
-
 /*----------------------------------------------------------------------------*/
 /*                                Private Data                                */
 /*----------------------------------------------------------------------------*/
 
 /*------------------------------------------------------------------------------
- * pRC points to SRP's rendering context.
+ * sg_pRC points to the calling thread's current rendering context.
  */
-static SRP_RC *sg_pRC = NULL;
+static IG_THREAD_LOCAL SRP_RC *sg_pRC = NULL;
 
 /*----------------------------------------------------------------------------*/
 /*                       Private Function Declarations                        */
 /*----------------------------------------------------------------------------*/
 
-static void SrpRCInitTransform(void);
-static void SrpRCInitObject(void);
-static void SrpRCInitPolygon(void);
+static void SrpRCInitTransform(SRP_RC *pRC);
+static void SrpRCInitObject(SRP_RC *pRC);
+static void SrpRCInitPolygon(SRP_RC *pRC);
+static void SrpRCInitBuffer(SRP_RC *pRC);
 
 static void SrpRCSetCapability(int cap, int state);
 
+static void SrpRCTouchMatrix(void);
+static void SrpRCUpdateDerived(int derived);
+
+static unsigned int SrpRCPackBgra8(const SRP_RC *pRC, 
+                                   int red, int green, int blue, int alpha);
+static unsigned int SrpRCPackRgba8(const SRP_RC *pRC, 
+                                   int red, int green, int blue, int alpha);
+static unsigned int SrpRCPackRgb565(const SRP_RC *pRC, 
+                                    int red, int green, int blue, int alpha);
+static unsigned int SrpRCPackIndex8(const SRP_RC *pRC, 
+                                    int red, int green, int blue, int alpha);
+static void SrpRCSetPixel32(unsigned char *pDest, unsigned int pixel);
+static void SrpRCSetPixel16(unsigned char *pDest, unsigned int pixel);
+static void SrpRCSetPixel8(unsigned char *pDest, unsigned int pixel);
+static void SrpRCSetSpan32(unsigned char *pDest, unsigned int pixel, 
+                           int count);
+static void SrpRCSetSpan16(unsigned char *pDest, unsigned int pixel, 
+                           int count);
+static void SrpRCSetSpan8(unsigned char *pDest, unsigned int pixel, 
+                          int count);
+static const SRP_PIXEL_FUNCS* SrpRCGetPixelFuncs(int format);
+static void SrpRCUpdatePixels(SRP_RC *pRC);
+
+static void SrpRCFill(unsigned char *pDest, unsigned int pixel, int size, 
+                      int stream);
+#if defined(SRP_SIMD_X86)
+static int SrpRCFillStreamSse2(unsigned char *pDest, unsigned int pixel, 
+                               int size);
+#endif
+static void SrpRCClearTile(int tile);
+static void SrpRCFinishClear(void);
+static void SrpRCUpdateDirty(void);
+
 /*----------------------------------------------------------------------------*/
 /*                             Private Functions                              */
 /*----------------------------------------------------------------------------*/
 
-static void SrpRCInitTransform(void)
+static void SrpRCInitTransform(SRP_RC *pRC)
 {
-    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+    ASSERTMSG(pRC != NULL, "Rendering context has not been initialized.");
 
-    sg_pRC->transformAttrib.matrixMode = SRP_MODELVIEW;
+    pRC->transformAttrib.matrixMode = SRP_MODELVIEW;
 }
 
-static void SrpRCInitObject(void)
+static void SrpRCInitObject(SRP_RC *pRC)
 {
-    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+    ASSERTMSG(pRC != NULL, "Rendering context has not been initialized.");
+
+    pRC->objectAttrib.cullFlag = FALSE;
+    pRC->objectAttrib.cullPlaneMask = FRUSTUM_PLANES_ALL;
+    pRC->objectAttrib.lodFlag = FALSE;
+    pRC->objectAttrib.meshletFlag = FALSE;
+    pRC->objectAttrib.streamFlag = FALSE;
+    pRC->objectAttrib.smallFlag = FALSE;
+    pRC->objectAttrib.smallPixels = 1.0f;
+    pRC->objectAttrib.smallMode = SRP_SMALL_DROP;
+}
 
-    sg_pRC->objectAttrib.cullFlag = FALSE;
+static void SrpRCInitPolygon(SRP_RC *pRC)
+{
+    ASSERTMSG(pRC != NULL, "Rendering context has not been initialized.");
+
+    pRC->polygonAttrib.cullFlag = FALSE;
 }
 
-static void SrpRCInitPolygon(void)
+static void SrpRCInitBuffer(SRP_RC *pRC)
 {
-    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+    ASSERTMSG(pRC != NULL, "Rendering context has not been initialized.");
 
-    sg_pRC->polygonAttrib.cullFlag = FALSE;
+    pRC->bufferAttrib.lazyClearFlag = FALSE;
 }
 
 static void SrpRCSetCapability(int cap, int state)
@@ -146,143 +274,787 @@ static void SrpRCSetCapability(int cap, int state)
         sg_pRC->objectAttrib.cullFlag = state;
         break;
 
+    case SRP_LOD_OBJECT:
+        sg_pRC->objectAttrib.lodFlag = state;
+        break;
+
+    case SRP_CULL_MESHLET:
+        sg_pRC->objectAttrib.meshletFlag = state;
+        break;
+
+    case SRP_CULL_SMALL:
+        sg_pRC->objectAttrib.smallFlag = state;
+        break;
+
+    case SRP_VERTEX_STREAM:
+        sg_pRC->objectAttrib.streamFlag = state;
+        break;
+
     case SRP_CULL_FACE:
         sg_pRC->polygonAttrib.cullFlag = state;
         break;
+
+    case SRP_LAZY_CLEAR:
+        if (!state)
+        {
+            SrpRCFinishClear();
+        }
+        sg_pRC->bufferAttrib.lazyClearFlag = state;
+        break;
     default:
         ASSERTMSG(FALSE, "SrpRCEnable: unknown capability.");
         break;
     }
 }
 
+/*------------------------------------------------------------------------------
+ * void SrpRCTouchMatrix(void)
+ *
+ * Mark the matrices derived from the current stack top dirty, after 
+ * it has been changed.
+ */
+static void SrpRCTouchMatrix(void)
+{
+    switch (sg_pRC->transformAttrib.matrixMode)
+    {
+    case SRP_MODELVIEW:
+        SET_BIT(sg_pRC->derivedDirty, SRP_DERIVED_ALL);
+        break;
+    case SRP_VIEWPORT:
+        SET_BIT(sg_pRC->derivedDirty, SRP_DERIVED_MVPV);
+        break;
+    default:
+        break;
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpRCUpdateDerived(int derived)
+ *
+ * Recompute the derived matrices in derived that are dirty.
+ *
+ * The viewport matrix, laid out for (x, y, 1) by 
+ * SrpTransformerSetViewport, is expanded to take (x, y, z, w) in clip 
+ * space, so x / w and y / w of the product come out in screen space.
+ */
+static void SrpRCUpdateDerived(int derived)
+{
+    MATRIX43F *pModelView, *pViewport;
+    MATRIX44F viewport;
+    int i, j;
+
+    derived &= sg_pRC->derivedDirty;
+    if (!derived)
+    {
+        return;
+    }
+
+    pModelView = &sg_pRC->fModelViewStack[sg_pRC->stackPosM];
+
+    if ((derived & (SRP_DERIVED_MVP | SRP_DERIVED_MVPV)) && 
+        (sg_pRC->derivedDirty & SRP_DERIVED_MVP))
+    {
+        SrpMatrixMultiply43x44f(sg_pRC->fModelViewProj, *pModelView, 
+                                sg_pRC->fProjection);
+        RESET_BIT(sg_pRC->derivedDirty, SRP_DERIVED_MVP);
+    }
+
+    if (derived & SRP_DERIVED_MVPV)
+    {
+        pViewport = &sg_pRC->fViewportStack[sg_pRC->stackPosV];
+
+        memset(viewport, 0, sizeof(MATRIX44F));
+        viewport[0]  = (*pViewport)[0];
+        viewport[1]  = (*pViewport)[1];
+        viewport[4]  = (*pViewport)[3];
+        viewport[5]  = (*pViewport)[4];
+        viewport[10] = 1.0f;
+        viewport[12] = (*pViewport)[6];
+        viewport[13] = (*pViewport)[7];
+        viewport[15] = (*pViewport)[8];
+
+        SrpMatrixMultiply44f(sg_pRC->fModelViewProjViewport, 
+                             sg_pRC->fModelViewProj, viewport);
+        RESET_BIT(sg_pRC->derivedDirty, SRP_DERIVED_MVPV);
+    }
+
+    if (derived & SRP_DERIVED_INVERSE)
+    {
+        if (SrpMatrixIsRigid43f(*pModelView))
+        {
+            SrpMatrixInvertRigid43f(sg_pRC->fInvModelView, *pModelView);
+        }
+        else if (!SrpMatrixInvert43f(sg_pRC->fInvModelView, *pModelView))
+        {
+            SrpMatrixLoadIdentity43f(sg_pRC->fInvModelView);
+        }
+
+        for (i = 0; i < 3; i++)
+        {
+            for (j = 0; j < 3; j++)
+            {
+                sg_pRC->fNormalMatrix[i * 3 + j] = 
+                    sg_pRC->fInvModelView[j * 3 + i];
+            }
+        }
+        sg_pRC->fNormalMatrix[9] = 0.0f;
+        sg_pRC->fNormalMatrix[10] = 0.0f;
+        sg_pRC->fNormalMatrix[11] = 0.0f;
+
+        RESET_BIT(sg_pRC->derivedDirty, SRP_DERIVED_INVERSE);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * unsigned int SrpRCPackBgra8(const SRP_RC *pRC, 
+ *                             int red, int green, int blue, int alpha)
+ * unsigned int SrpRCPackRgba8(const SRP_RC *pRC, 
+ *                             int red, int green, int blue, int alpha)
+ * unsigned int SrpRCPackRgb565(const SRP_RC *pRC, 
+ *                              int red, int green, int blue, int alpha)
+ * unsigned int SrpRCPackIndex8(const SRP_RC *pRC, 
+ *                              int red, int green, int blue, int alpha)
+ *
+ * Make a pixel of the given rgba in each format. 32 bit pixels are 
+ * returned as their bytes would be in memory, whatever the byte order.
+ */
+static unsigned int SrpRCPackBgra8(const SRP_RC *pRC, 
+                                   int red, int green, int blue, int alpha)
+{
+    unsigned char bytes[4];
+    unsigned int pixel;
+
+    (void)pRC;
+
+    bytes[0] = (unsigned char)blue;
+    bytes[1] = (unsigned char)green;
+    bytes[2] = (unsigned char)red;
+    bytes[3] = (unsigned char)alpha;
+    memcpy(&pixel, bytes, 4);
+
+    return pixel;
+}
+
+static unsigned int SrpRCPackRgba8(const SRP_RC *pRC, 
+                                   int red, int green, int blue, int alpha)
+{
+    unsigned char bytes[4];
+    unsigned int pixel;
+
+    (void)pRC;
+
+    bytes[0] = (unsigned char)red;
+    bytes[1] = (unsigned char)green;
+    bytes[2] = (unsigned char)blue;
+    bytes[3] = (unsigned char)alpha;
+    memcpy(&pixel, bytes, 4);
+
+    return pixel;
+}
+
+static unsigned int SrpRCPackRgb565(const SRP_RC *pRC, 
+                                    int red, int green, int blue, int alpha)
+{
+    (void)pRC;
+    (void)alpha;
+
+    return ((red >> 3) << 11) | ((green >> 2) << 5) | (blue >> 3);
+}
+
+/* The nearest color in the palette, alpha is dropped */
+static unsigned int SrpRCPackIndex8(const SRP_RC *pRC, 
+                                    int red, int green, int blue, int alpha)
+{
+    int i, dr, dg, db, dist;
+    int best, bestDist;
+    const unsigned char *pColor;
+
+    (void)alpha;
+
+    best = 0;
+    bestDist = 3 * 255 * 255 + 1;
+    for (i = 0; i < SRP_PALETTE_SIZE && bestDist > 0; i++)
+    {
+        pColor = pRC->palette + i * 3;
+        dr = pColor[0] - red;
+        dg = pColor[1] - green;
+        db = pColor[2] - blue;
+        dist = dr * dr + dg * dg + db * db;
+        if (dist < bestDist)
+        {
+            best = i;
+            bestDist = dist;
+        }
+    }
+
+    return best;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpRCSetPixel32(unsigned char *pDest, unsigned int pixel)
+ * void SrpRCSetPixel16(unsigned char *pDest, unsigned int pixel)
+ * void SrpRCSetPixel8(unsigned char *pDest, unsigned int pixel)
+ * void SrpRCSetSpan32(unsigned char *pDest, unsigned int pixel, int count)
+ * void SrpRCSetSpan16(unsigned char *pDest, unsigned int pixel, int count)
+ * void SrpRCSetSpan8(unsigned char *pDest, unsigned int pixel, int count)
+ *
+ * Store a pixel, or count of them in a row, of each size. pDest is 
+ * aligned with the size, pitches are multiples of 4 bytes.
+ */
+static void SrpRCSetPixel32(unsigned char *pDest, unsigned int pixel)
+{
+    *(unsigned int *)pDest = pixel;
+}
+
+static void SrpRCSetPixel16(unsigned char *pDest, unsigned int pixel)
+{
+    *(unsigned short *)pDest = (unsigned short)pixel;
+}
+
+static void SrpRCSetPixel8(unsigned char *pDest, unsigned int pixel)
+{
+    *pDest = (unsigned char)pixel;
+}
+
+static void SrpRCSetSpan32(unsigned char *pDest, unsigned int pixel, 
+                           int count)
+{
+    int i;
+    unsigned int *p;
+
+    p = (unsigned int *)pDest;
+    for (i = 0; i < count; i++)
+    {
+        p[i] = pixel;
+    }
+}
+
+static void SrpRCSetSpan16(unsigned char *pDest, unsigned int pixel, 
+                           int count)
+{
+    int i;
+    unsigned short *p;
+
+    p = (unsigned short *)pDest;
+    for (i = 0; i < count; i++)
+    {
+        p[i] = (unsigned short)pixel;
+    }
+}
+
+static void SrpRCSetSpan8(unsigned char *pDest, unsigned int pixel, 
+                          int count)
+{
+    memset(pDest, (int)pixel, count);
+}
+
+/*------------------------------------------------------------------------------
+ * const SRP_PIXEL_FUNCS* SrpRCGetPixelFuncs(int format)
+ *
+ * Get the pixel functions of a format, NULL if it's not supported.
+ */
+static const SRP_PIXEL_FUNCS* SrpRCGetPixelFuncs(int format)
+{
+    static const SRP_PIXEL_FUNCS pixelFuncs[] = 
+    {
+        {SRP_FORMAT_BGRA8,  32, 
+         SrpRCPackBgra8,  SrpRCSetPixel32, SrpRCSetSpan32},
+        {SRP_FORMAT_RGBA8,  32, 
+         SrpRCPackRgba8,  SrpRCSetPixel32, SrpRCSetSpan32},
+        {SRP_FORMAT_RGB565, 16, 
+         SrpRCPackRgb565, SrpRCSetPixel16, SrpRCSetSpan16},
+        {SRP_FORMAT_INDEX8,  8, 
+         SrpRCPackIndex8, SrpRCSetPixel8,  SrpRCSetSpan8}
+    };
+    int i;
+
+    for (i = 0; i < (int)(sizeof(pixelFuncs) / sizeof(pixelFuncs[0])); i++)
+    {
+        if (pixelFuncs[i].format == format)
+        {
+            return &pixelFuncs[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpRCUpdatePixels(SRP_RC *pRC)
+ *
+ * Make the drawing and clearing pixels again, after the colors or the 
+ * palette have changed. The clearing pixel is repeated to fill 32 bits, 
+ * which keeps the same bytes in memory for any byte order.
+ */
+static void SrpRCUpdatePixels(SRP_RC *pRC)
+{
+    const SRP_PIXEL_FUNCS *pFuncs;
+    unsigned int pixel;
+
+    ASSERTMSG(pRC != NULL, "Rendering context has not been initialized.");
+
+    pFuncs = pRC->pPixelFuncs;
+
+    pRC->drawPixel = pFuncs->pfnPack(pRC, pRC->drawRed, 
+        pRC->drawGreen, pRC->drawBlue, pRC->drawAlpha);
+
+    pixel = pFuncs->pfnPack(pRC, pRC->clearRed, 
+        pRC->clearGreen, pRC->clearBlue, pRC->clearAlpha);
+    switch (pFuncs->bit)
+    {
+    case 16:
+        pixel = pixel | (pixel << 16);
+        break;
+    case 8:
+        pixel = pixel * 0x01010101;
+        break;
+    default:
+        break;
+    }
+    pRC->clearPixel = pixel;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpRCFill(unsigned char *pDest, unsigned int pixel, int size, 
+ *                int stream)
+ *
+ * Fill size bytes, a multiple of 4, with a 32 bit pixel. With stream 
+ * set, non-temporal stores are used where there are any, the bytes 
+ * then go to memory without evicting what's in the caches.
+ */
+static void SrpRCFill(unsigned char *pDest, unsigned int pixel, int size, 
+                      int stream)
+{
+    int i;
+    unsigned int *p;
+
+    p = (unsigned int *)pDest;
+    i = 0;
+
+#if defined(SRP_SIMD_X86)
+    if (stream && SrpSimdGetLevel() >= SRP_SIMD_SSE2)
+    {
+        /* Up to where the stores can be aligned */
+        for (; i < size && ((size_t)(pDest + i) & 15); i += 4)
+        {
+            *p++ = pixel;
+        }
+
+        i += SrpRCFillStreamSse2(pDest + i, pixel, size - i);
+        p = (unsigned int *)(pDest + i);
+    }
+#endif
+
+    for (; i < size; i += 4)
+    {
+        *p++ = pixel;
+    }
+}
+
+#if defined(SRP_SIMD_X86)
+/*------------------------------------------------------------------------------
+ * int SrpRCFillStreamSse2(unsigned char *pDest, unsigned int pixel, 
+ *                         int size)
+ *
+ * Fill with non-temporal stores, 64 bytes at a time. pDest is 16 bytes 
+ * aligned. Return how many bytes are done, the rest is left to the 
+ * caller.
+ */
+SRP_TARGET_SSE2
+static int SrpRCFillStreamSse2(unsigned char *pDest, unsigned int pixel, 
+                               int size)
+{
+    int i;
+    __m128i m;
+
+    m = _mm_set1_epi32((int)pixel);
+    for (i = 0; i + 64 <= size; i += 64)
+    {
+        _mm_stream_si128((__m128i *)(pDest + i), m);
+        _mm_stream_si128((__m128i *)(pDest + i + 16), m);
+        _mm_stream_si128((__m128i *)(pDest + i + 32), m);
+        _mm_stream_si128((__m128i *)(pDest + i + 48), m);
+    }
+
+    /* Order them before the normal stores drawing will do */
+    _mm_sfence();
+
+    return i;
+}
+#endif
+
+/*------------------------------------------------------------------------------
+ * void SrpRCClearTile(int tile)
+ *
+ * Clear a tile SRP_LAZY_CLEAR has left to be cleared. It's about to be 
+ * drawn on, so it's cleared through the caches.
+ */
+static void SrpRCClearTile(int tile)
+{
+    int offset, size;
+
+    offset = tile << SRP_CLEAR_TILE_SHIFT;
+    size = sg_pRC->size - offset < SRP_CLEAR_TILE_SIZE ? 
+           sg_pRC->size - offset : SRP_CLEAR_TILE_SIZE;
+    SrpRCFill(sg_pRC->buffer + offset, sg_pRC->clearPixel, size, FALSE);
+
+    sg_pRC->pTilePending[tile] = FALSE;
+    sg_pRC->numPending--;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpRCUpdateDirty(void)
+ *
+ * Work out the front buffer's dirty tiles when it's swapped. A frame 
+ * cleared differs from the last one where either has been drawn on 
+ * since its clear, one not cleared where it's been drawn on. A back 
+ * buffer not cleared in a longer chain holds an older frame, so all of 
+ * it is dirty then.
+ */
+static void SrpRCUpdateDirty(void)
+{
+    int i, numTiles;
+
+    numTiles = sg_pRC->dirtyTilesX * sg_pRC->dirtyTilesY;
+
+    if (!sg_pRC->frameCleared && sg_pRC->numBuffers > 1)
+    {
+        sg_pRC->allDirty = TRUE;
+    }
+
+    if (sg_pRC->allDirty)
+    {
+        memset(sg_pRC->pTileDirty, TRUE, numTiles);
+        memset(sg_pRC->pTileLastDrawn, TRUE, numTiles);
+    }
+    else if (sg_pRC->frameCleared)
+    {
+        for (i = 0; i < numTiles; i++)
+        {
+            sg_pRC->pTileDirty[i] = sg_pRC->pTileDrawn[i] | 
+                                    sg_pRC->pTileLastDrawn[i];
+        }
+        memcpy(sg_pRC->pTileLastDrawn, sg_pRC->pTileDrawn, numTiles);
+    }
+    else
+    {
+        for (i = 0; i < numTiles; i++)
+        {
+            sg_pRC->pTileDirty[i] = sg_pRC->pTileDrawn[i];
+            sg_pRC->pTileLastDrawn[i] |= sg_pRC->pTileDrawn[i];
+        }
+    }
+
+    memset(sg_pRC->pTileDrawn, FALSE, numTiles);
+    sg_pRC->frameCleared = FALSE;
+    sg_pRC->allDirty = FALSE;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpRCFinishClear(void)
+ *
+ * Clear all the tiles SRP_LAZY_CLEAR has left to be cleared, those not 
+ * drawn on since.
+ */
+static void SrpRCFinishClear(void)
+{
+    int i;
+
+    for (i = 0; i < sg_pRC->numTiles && sg_pRC->numPending > 0; i++)
+    {
+        if (sg_pRC->pTilePending[i])
+        {
+            SrpRCClearTile(i);
+        }
+    }
+}
+
 /*----------------------------------------------------------------------------*/
 /*                              Public Functions                              */
 /*----------------------------------------------------------------------------*/
 
 /*------------------------------------------------------------------------------
- * int SrpCreateRC(int width, int height, int bit)
+ * int SrpCreateRCFormat(SRP_RC **ppRC, int width, int height, int format)
  *
  * This function create a rendering context with required window size
- * and color bits. It must be called once and once only.
+ * and pixel format. Make it current with SrpRCMakeCurrent to use it.
  */
-int SrpCreateRC(int width, int height, int bit)
+int SrpCreateRCFormat(SRP_RC **ppRC, int width, int height, int format)
 {
     int i;
+    SRP_RC *pRC;
+    const SRP_PIXEL_FUNCS *pFuncs;
     
-    ASSERTMSG(sg_pRC == NULL, "SrpCreateRC shoud be called only once.");
+    ASSERTMSG(ppRC != NULL, "SrpCreateRCFormat: invalid arguments.");
 
-    if (!IgNewMemory((void **)&sg_pRC, sizeof(SRP_RC)))
+    if ((pFuncs = SrpRCGetPixelFuncs(format)) == NULL)
     {
-        printf("SrpCreateRC failed.\n");
+        printf("Error: pixel format 0x%x is not supported.\n", format);
         return FALSE;
     }
 
-    sg_pRC->width  = width;
-    sg_pRC->height = height;
-    sg_pRC->bit    = bit;
+    if (!IgNewMemory((void **)ppRC, sizeof(SRP_RC)))
+    {
+        printf("SrpCreateRCFormat failed.\n");
+        return FALSE;
+    }
+    pRC = *ppRC;
+
+    pRC->width  = width;
+    pRC->height = height;
+    pRC->bit    = pFuncs->bit;
+    pRC->format = format;
+    pRC->pPixelFuncs = pFuncs;
     /* Make the buffer alligned with 4 bytes */
-    sg_pRC->pitch  = (width * bit + 31) / 32 * 4;
-    sg_pRC->size   = sg_pRC->pitch * sg_pRC->height;
+    pRC->pitch  = (width * pRC->bit + 31) / 32 * 4;
+    pRC->size   = pRC->pitch * pRC->height;
 
-    sg_pRC->clearRed    = 0;
-    sg_pRC->clearGreen  = 0;
-    sg_pRC->clearBlue   = 0;
-    sg_pRC->clearAlpha  = 0;
+    pRC->clearRed    = 0;
+    pRC->clearGreen  = 0;
+    pRC->clearBlue   = 0;
+    pRC->clearAlpha  = 0;
     
-    sg_pRC->drawRed    = 0;
-    sg_pRC->drawGreen  = 0;
-    sg_pRC->drawBlue   = 0;
-    sg_pRC->drawAlpha  = 0;
+    pRC->drawRed    = 0;
+    pRC->drawGreen  = 0;
+    pRC->drawBlue   = 0;
+    pRC->drawAlpha  = 0;
 
-    if (!IgNewMemory((void **)&(sg_pRC->buffer), sg_pRC->size))
+    if (!IgNewMemory((void **)&(pRC->buffer), pRC->size))
     {
-        IgFreeMemory(sg_pRC);
-        printf("SrpCreateRC failed.\n");
+        IgFreeMemory(pRC);
+        printf("SrpCreateRCFormat failed.\n");
         return FALSE;
     }
     
-    memset(sg_pRC->buffer, 0, sg_pRC->size);
+    memset(pRC->buffer, 0, pRC->size);
 
-    if (!IgNewMemory((void **)&(sg_pRC->clearBuffer), sg_pRC->size))
+    pRC->pBuffers[0] = pRC->buffer;
+    pRC->numBuffers = 1;
+    pRC->backIndex = 0;
+    pRC->frontIndex = 0;
+
+    /* A 3-3-2 palette, so 8 bit colors don't come out too far off */
+    for (i = 0; i < SRP_PALETTE_SIZE; i++)
     {
-        IgFreeMemory(sg_pRC);
-        printf("SrpCreateRC failed.\n");
+        pRC->palette[i * 3 + 0] = (unsigned char)((i >> 5) * 255 / 7);
+        pRC->palette[i * 3 + 1] = (unsigned char)(((i >> 2) & 7) * 255 / 7);
+        pRC->palette[i * 3 + 2] = (unsigned char)((i & 3) * 255 / 3);
+    }
+    SrpRCUpdatePixels(pRC);
+
+    pRC->numTiles = (pRC->size + SRP_CLEAR_TILE_SIZE - 1) >> 
+                    SRP_CLEAR_TILE_SHIFT;
+    pRC->numPending = 0;
+    if (!IgNewMemory((void **)&(pRC->pTilePending), pRC->numTiles))
+    {
+        IgFreeMemory(pRC->buffer);
+        IgFreeMemory(pRC);
+        printf("SrpCreateRCFormat failed.\n");
         return FALSE;
     }
     
-    memset(sg_pRC->clearBuffer, 0, sg_pRC->size);
+    memset(pRC->pTilePending, FALSE, pRC->numTiles);
+    pRC->targetLocked = FALSE;
+
+    pRC->dirtyTilesX = (width + SRP_DIRTY_TILE_SIZE - 1) >> 
+                       SRP_DIRTY_TILE_SHIFT;
+    pRC->dirtyTilesY = (height + SRP_DIRTY_TILE_SIZE - 1) >> 
+                       SRP_DIRTY_TILE_SHIFT;
+    i = pRC->dirtyTilesX * pRC->dirtyTilesY;
+    if (!IgNewMemory((void **)&(pRC->pTileDirty), i * 3))
+    {
+        IgFreeMemory(pRC->pTilePending);
+        IgFreeMemory(pRC->buffer);
+        IgFreeMemory(pRC);
+        printf("SrpCreateRCFormat failed.\n");
+        return FALSE;
+    }
+    pRC->pTileDrawn = pRC->pTileDirty + i;
+    pRC->pTileLastDrawn = pRC->pTileDrawn + i;
+
+    /* Nothing's been presented yet */
+    memset(pRC->pTileDirty, TRUE, i * 3);
+    pRC->frameCleared = FALSE;
+    pRC->allDirty = TRUE;
 
     for (i = 0; i < SRP_MAX_MODELVIEW_STACK_DEPTH; i++)
     {
-        SrpMatrixLoadIdentity43f(sg_pRC->fModelViewStack[i]);
+        SrpMatrixLoadIdentity43f(pRC->fModelViewStack[i]);
     }
     for (i = 0; i < SRP_MAX_PROJECTION_STACK_DEPTH; i++)
     {
-        SrpMatrixLoadIdentity43f(sg_pRC->fProjectionStack[i]);
+        SrpMatrixLoadIdentity43f(pRC->fProjectionStack[i]);
     }
     for (i = 0; i < SRP_MAX_TEXTURE_STACK_DEPTH; i++)
     {
-        SrpMatrixLoadIdentity43f(sg_pRC->fTextureStack[i]);
+        SrpMatrixLoadIdentity43f(pRC->fTextureStack[i]);
     }
     for (i = 0; i < SRP_MAX_VIEWPORT_STACK_DEPTH; i++)
     {
-        SrpMatrixLoadIdentity43f(sg_pRC->fViewportStack[i]);
+        SrpMatrixLoadIdentity43f(pRC->fViewportStack[i]);
     }
     
-    sg_pRC->stackPosM = 0;
-    sg_pRC->stackPosP = 0;
-    sg_pRC->stackPosT = 0;
-    sg_pRC->stackPosV = 0;
+    pRC->stackPosM = 0;
+    pRC->stackPosP = 0;
+    pRC->stackPosT = 0;
+    pRC->stackPosV = 0;
     
-    sg_pRC->pfCurrentMatrix = sg_pRC->fModelViewStack;
-    sg_pRC->pCurrentStackPos = &sg_pRC->stackPosM;
-    sg_pRC->currentStackMaxDepth = SRP_MAX_MODELVIEW_STACK_DEPTH;
+    pRC->pfCurrentMatrix = pRC->fModelViewStack;
+    pRC->pCurrentStackPos = &pRC->stackPosM;
+    pRC->currentStackMaxDepth = SRP_MAX_MODELVIEW_STACK_DEPTH;
 
-    sg_pRC->fFovy   = 90.0f;
-    sg_pRC->fAspect = 1.0f;
+    pRC->fFovy   = 90.0f;
+    pRC->fAspect = 1.0f;
+    SrpMatrixMakePerspective44f(pRC->fProjection, pRC->fFovy, 
+                                pRC->fAspect, -2.0f, -100.0f);
+    pRC->derivedDirty = SRP_DERIVED_ALL;
 
-    SrpCreateFrustum(&sg_pRC->pFrustum, sg_pRC->fFovy, sg_pRC->fAspect, 
+    SrpCreateFrustum(&pRC->pFrustum, pRC->fFovy, pRC->fAspect, 
                      -2.0f, -100.0f);
+    SrpCreateFrustum(&pRC->pWorldFrustum, pRC->fFovy, pRC->fAspect, 
+                     -2.0f, -100.0f);
+    pRC->worldFrustumValid = FALSE;
 
-    SrpRCInitTransform();
-    SrpRCInitObject();
-    SrpRCInitPolygon();
+    SrpRCInitTransform(pRC);
+    SrpRCInitObject(pRC);
+    SrpRCInitPolygon(pRC);
+    SrpRCInitBuffer(pRC);
 
     return TRUE;
 }
 
+/*------------------------------------------------------------------------------
+ * int SrpCreateRCEx(SRP_RC **ppRC, int width, int height, int bit)
+ *
+ * This function create a rendering context with required window size
+ * and color bits, in SRP_FORMAT_BGRA8, SRP_FORMAT_RGB565 or 
+ * SRP_FORMAT_INDEX8 for 32, 16 or 8 bits. Make it current with 
+ * SrpRCMakeCurrent to use it.
+ */
+int SrpCreateRCEx(SRP_RC **ppRC, int width, int height, int bit)
+{
+    int format;
+
+    switch (bit)
+    {
+    case 32:
+        format = SRP_FORMAT_BGRA8;
+        break;
+    case 16:
+        format = SRP_FORMAT_RGB565;
+        break;
+    case 8:
+        format = SRP_FORMAT_INDEX8;
+        break;
+    default:
+        printf("Error: %d color bits is not supported.\n", bit);
+        return FALSE;
+    }
+
+    return SrpCreateRCFormat(ppRC, width, height, format);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpDeleteRCEx(SRP_RC *pRC)
+ * 
+ * This function delete a rendering context created by SrpCreateRCEx. 
+ * It's no longer current on the calling thread if it was.
+ */
+void SrpDeleteRCEx(SRP_RC *pRC)
+{
+    int i;
+
+    ASSERTMSG(pRC != NULL, "SrpDeleteRCEx: invalid arguments.");
+
+    if (pRC == sg_pRC)
+    {
+        sg_pRC = NULL;
+    }
+
+    SrpDeleteFrustum(pRC->pFrustum);
+    SrpDeleteFrustum(pRC->pWorldFrustum);
+    for (i = 0; i < pRC->numBuffers; i++)
+    {
+        IgFreeMemory(pRC->pBuffers[i]);
+    }
+    IgFreeMemory(pRC->pTilePending);
+    IgFreeMemory(pRC->pTileDirty);
+    IgFreeMemory(pRC);
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpCreateRC(int width, int height, int bit)
+ *
+ * This function create a rendering context with required window size
+ * and color bits, and makes it current. It must be called once and 
+ * once only on a thread.
+ */
+int SrpCreateRC(int width, int height, int bit)
+{
+    SRP_RC *pRC;
+
+    ASSERTMSG(sg_pRC == NULL, "SrpCreateRC shoud be called only once.");
+
+    if (!SrpCreateRCEx(&pRC, width, height, bit))
+    {
+        return FALSE;
+    }
+
+    sg_pRC = pRC;
+    return TRUE;
+}
+
 /*------------------------------------------------------------------------------
  * void SrpDeleteRC(void)
  * 
- * This function delete the rendering context. It should be called after
- * a rendering context has been created.
+ * This function delete the current rendering context. It should be 
+ * called after a rendering context has been created.
  */
 void SrpDeleteRC(void)
 {
     ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
 
-    SrpDeleteFrustum(sg_pRC->pFrustum);
-    IgFreeMemory(sg_pRC->buffer);
-    IgFreeMemory(sg_pRC->clearBuffer);
-    IgFreeMemory(sg_pRC);
+    SrpDeleteRCEx(sg_pRC);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpRCMakeCurrent(SRP_RC *pRC)
+ * SRP_RC* SrpRCGetCurrent(void)
+ *
+ * Set or get the calling thread's current rendering context.
+ */
+void SrpRCMakeCurrent(SRP_RC *pRC)
+{
+    sg_pRC = pRC;
+}
+
+SRP_RC* SrpRCGetCurrent(void)
+{
+    return sg_pRC;
 }
 
 /*------------------------------------------------------------------------------
  * int SrpRCGetWidth()
  * int SrpRCGetHeight()
  * int SrpRCGetBit(void)
+ * int SrpRCGetFormat(void)
  * int SrpRCGetPitch(void)
  * int SrpRCGetSize(void)
  * const unsigned char* SrpRCGetBuffer(void)
+ * const unsigned char* SrpRCGetFrontBuffer(void)
+ * const unsigned char* SrpRCGetPalette(void)
  * float SrpRCGetFovy(void)
  * float SrpRCGetAspect(void)
- * MATRIX43F* SrpRCGetModelView(void)
+ * const MATRIX43F* SrpRCGetModelView(void)
+ * const MATRIX44F* SrpRCGetProjection(void)
  *
  * void SrpRCSetWidth(int width)
  * void SrpRCSetHeight(int height)
  * void SrpRCSetFrustum(float fovy, float aspect, float near, float far)
  *
- * RC gets and sets.
+ * RC gets and sets. The matrices are read only, as the ones derived 
+ * from them are kept up to date only when they're changed by the 
+ * matrix functions, e.g. SrpRCLoadIdentity and SrpRCCombineMatrix43f.
  */
 int SrpRCGetWidth(void)
 {
@@ -305,6 +1077,13 @@ int SrpRCGetBit(void)
     return sg_pRC->bit;
 }
 
+int SrpRCGetFormat(void)
+{
+    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+
+    return sg_pRC->format;
+}
+
 int SrpRCGetPitch(void)
 {
     ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
@@ -316,35 +1095,120 @@ int SrpRCGetSize(void)
 {
     ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
 
-    return sg_pRC->size;
+    return sg_pRC->size;
+}
+
+const unsigned char* SrpRCGetBuffer(void)
+{
+    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+
+    /* The buffer is about to be presented, tiles left aren't drawn on */
+    SrpRCFinishClear();
+
+    return sg_pRC->buffer;
+}
+
+const unsigned char* SrpRCGetFrontBuffer(void)
+{
+    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+
+    return sg_pRC->pBuffers[sg_pRC->frontIndex];
+}
+
+const unsigned char* SrpRCGetPalette(void)
+{
+    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+
+    return sg_pRC->palette;
+}
+
+float SrpRCGetFovy(void)
+{
+    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+
+    return sg_pRC->fFovy;
+}
+
+float SrpRCGetAspect(void)
+{
+    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+
+    return sg_pRC->fAspect;
+}
+
+const MATRIX43F* SrpRCGetModelView(void)
+{
+    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+
+    return (sg_pRC->fModelViewStack + sg_pRC->stackPosM);
+}
+
+const MATRIX44F* SrpRCGetProjection(void)
+{
+    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+
+    return &sg_pRC->fProjection;
+}
+
+/*------------------------------------------------------------------------------
+ * const MATRIX44F* SrpRCGetModelViewProjection(void)
+ * const MATRIX44F* SrpRCGetModelViewProjViewport(void)
+ * const MATRIX43F* SrpRCGetInverseModelView(void)
+ * const MATRIX43F* SrpRCGetNormalMatrix(void)
+ * void SrpRCGetEyePosition(VECTOR3F out)
+ *
+ * Get the matrices derived from the current stack tops. Each is 
+ * cached, and only recomputed once a stack top it depends on has 
+ * changed. The inverse modelview takes the cheap rigid path when 
+ * the modelview is rotation and translation only.
+ *
+ * The normal matrix transforms normals into camera space, translation 
+ * being zero. The eye position is the camera in the space modelview 
+ * transforms from, world space normally.
+ */
+const MATRIX44F* SrpRCGetModelViewProjection(void)
+{
+    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+
+    SrpRCUpdateDerived(SRP_DERIVED_MVP);
+
+    return (const MATRIX44F *)&sg_pRC->fModelViewProj;
 }
 
-const unsigned char* SrpRCGetBuffer(void)
+const MATRIX44F* SrpRCGetModelViewProjViewport(void)
 {
     ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
 
-    return sg_pRC->buffer;
+    SrpRCUpdateDerived(SRP_DERIVED_MVPV);
+
+    return (const MATRIX44F *)&sg_pRC->fModelViewProjViewport;
 }
 
-float SrpRCGetFovy(void)
+const MATRIX43F* SrpRCGetInverseModelView(void)
 {
     ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
 
-    return sg_pRC->fFovy;
+    SrpRCUpdateDerived(SRP_DERIVED_INVERSE);
+
+    return (const MATRIX43F *)&sg_pRC->fInvModelView;
 }
 
-float SrpRCGetAspect(void)
+const MATRIX43F* SrpRCGetNormalMatrix(void)
 {
     ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
 
-    return sg_pRC->fAspect;
+    SrpRCUpdateDerived(SRP_DERIVED_INVERSE);
+
+    return (const MATRIX43F *)&sg_pRC->fNormalMatrix;
 }
 
-MATRIX43F* SrpRCGetModelView(void)
+void SrpRCGetEyePosition(VECTOR3F out)
 {
     ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
 
-    return (sg_pRC->fModelViewStack + sg_pRC->stackPosM);
+    SrpRCUpdateDerived(SRP_DERIVED_INVERSE);
+
+    SrpVectorCopy3f(out, sg_pRC->fInvModelView + 9);
 }
 
 void SrpRCSetWidth(int width)
@@ -370,7 +1234,10 @@ void SrpRCSetFrustum(float fovy, float aspect, float near, float far)
 
     sg_pRC->fFovy = fovy;
     sg_pRC->fAspect = aspect;
+    SrpMatrixMakePerspective44f(sg_pRC->fProjection, fovy, aspect, near, far);
+    SET_BIT(sg_pRC->derivedDirty, SRP_DERIVED_MVP | SRP_DERIVED_MVPV);
     SrpSetFrustum(sg_pRC->pFrustum, fovy, aspect, near, far);
+    sg_pRC->worldFrustumValid = FALSE;
 }
 
 void SrpRCPrintMatrix(void)
@@ -442,33 +1309,25 @@ void SrpRCPrintStack(int depth)
  */
 void SrpRCSetClearColor(int red, int green, int blue, int alpha)
 {
-    int i;
-
     ASSERTMSG(sg_pRC != NULL && red >= 0 && red <= 255 && 
         green >= 0 && green <= 255 && blue >= 0 && blue <= 255 && 
         alpha >= 0 && alpha <= 255, "SrpRCSetClearColor: invalid arguments.");
 
-    switch (sg_pRC->bit)
-    {
-    case 32:
-        sg_pRC->clearRed   = red;
-        sg_pRC->clearGreen = green;
-        sg_pRC->clearBlue  = blue;
-        sg_pRC->clearAlpha = alpha;
+    /* Tiles left by the last clear get the color it was done with */
+    SrpRCFinishClear();
 
-        for (i = 0; i < sg_pRC->size; i += 4)
-        {
-            sg_pRC->clearBuffer[i + 0] = sg_pRC->clearBlue;
-            sg_pRC->clearBuffer[i + 1] = sg_pRC->clearGreen;
-            sg_pRC->clearBuffer[i + 2] = sg_pRC->clearRed;
-            sg_pRC->clearBuffer[i + 3] = sg_pRC->clearAlpha;
-        }
-        break;
-    default:
-        ASSERTMSG(FALSE, 
-                  "SrpRCSetClearColor: current color bit is not supported.");
-        break;
+    if (red != sg_pRC->clearRed || green != sg_pRC->clearGreen || 
+        blue != sg_pRC->clearBlue || alpha != sg_pRC->clearAlpha)
+    {
+        sg_pRC->allDirty = TRUE;
     }
+
+    sg_pRC->clearRed   = red;
+    sg_pRC->clearGreen = green;
+    sg_pRC->clearBlue  = blue;
+    sg_pRC->clearAlpha = alpha;
+
+    SrpRCUpdatePixels(sg_pRC);
 }
 
 /*------------------------------------------------------------------------------
@@ -483,56 +1342,282 @@ void SrpRCSetDrawColor(int red, int green, int blue, int alpha)
         green >= 0 && green <= 255 && blue >= 0 && blue <= 255 && 
         alpha >= 0 && alpha <= 255, "SrpRCSetDrawColor: invalid arguments.");
 
-    switch (sg_pRC->bit)
-    {
-    case 32:
-        sg_pRC->drawRed   = red;
-        sg_pRC->drawGreen = green;
-        sg_pRC->drawBlue  = blue;
-        sg_pRC->drawAlpha = alpha;
-        break;
-    default:
-        ASSERTMSG(FALSE, 
-                  "SrpRCSetDrawColor: current color bit is not supported.");
-        break;
-    }
+    sg_pRC->drawRed   = red;
+    sg_pRC->drawGreen = green;
+    sg_pRC->drawBlue  = blue;
+    sg_pRC->drawAlpha = alpha;
+
+    SrpRCUpdatePixels(sg_pRC);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpRCSetPalette(const unsigned char *pPalette)
+ *
+ * This function sets the 256 colors, rgb bytes each, SRP_FORMAT_INDEX8 
+ * pixels index. The drawing and clearing colors are matched to it again, 
+ * pixels already in the buffer keep their indices.
+ */
+void SrpRCSetPalette(const unsigned char *pPalette)
+{
+    ASSERTMSG(sg_pRC != NULL && pPalette != NULL, 
+        "SrpRCSetPalette: invalid arguments.");
+
+    SrpRCFinishClear();
+
+    memcpy(sg_pRC->palette, pPalette, sizeof(sg_pRC->palette));
+    sg_pRC->allDirty = TRUE;
+
+    SrpRCUpdatePixels(sg_pRC);
 }
 
 /*------------------------------------------------------------------------------
  * void SrpRCSetPixel(size_t offset)
  *
- * This function sets the color at (sg_pRC->buffer + offset), using
- * different approach according to current color bit.
+ * This function sets the color at (sg_pRC->buffer + offset), with the 
+ * store of the pixel format.
  */
 void SrpRCSetPixel(size_t offset)
 {
     ASSERTMSG(sg_pRC != NULL && offset >= 0 && offset < sg_pRC->size, 
         "SrpRCSetPixel: invalid arguments.");
-    
-    switch (sg_pRC->bit)
+
+    if (sg_pRC->numPending > 0 && 
+        sg_pRC->pTilePending[offset >> SRP_CLEAR_TILE_SHIFT])
     {
-    case 32:
-        sg_pRC->buffer[offset + 0] = sg_pRC->drawBlue;
-        sg_pRC->buffer[offset + 1] = sg_pRC->drawGreen;
-        sg_pRC->buffer[offset + 2] = sg_pRC->drawRed;
-        sg_pRC->buffer[offset + 3] = sg_pRC->drawAlpha;
-        break;
-    default:
-        ASSERTMSG(FALSE, "SrpRCSetPixel: current color bit is not supported.");
-        break;
+        SrpRCClearTile(offset >> SRP_CLEAR_TILE_SHIFT);
+    }
+
+    sg_pRC->pPixelFuncs->pfnSetPixel(sg_pRC->buffer + offset, 
+                                     sg_pRC->drawPixel);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpRCSetSpan(size_t offset, int count)
+ *
+ * This function sets the color of count pixels in a row from 
+ * (sg_pRC->buffer + offset).
+ */
+void SrpRCSetSpan(size_t offset, int count)
+{
+    size_t end;
+    int tile;
+
+    ASSERTMSG(sg_pRC != NULL && count > 0, 
+        "SrpRCSetSpan: invalid arguments.");
+
+    end = offset + count * sg_pRC->bit / 8;
+    ASSERTMSG(end <= (size_t)sg_pRC->size, 
+        "SrpRCSetSpan: invalid arguments.");
+
+    if (sg_pRC->numPending > 0)
+    {
+        for (tile = (int)(offset >> SRP_CLEAR_TILE_SHIFT); 
+             tile <= (int)((end - 1) >> SRP_CLEAR_TILE_SHIFT); tile++)
+        {
+            if (sg_pRC->pTilePending[tile])
+            {
+                SrpRCClearTile(tile);
+            }
+        }
+    }
+
+    sg_pRC->pPixelFuncs->pfnSetSpan(sg_pRC->buffer + offset, 
+                                    sg_pRC->drawPixel, count);
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpRCSetSwapBuffers(int count)
+ *
+ * This function sets how many buffers the swap chain has, 1 to 
+ * SRP_MAX_SWAP_BUFFERS. Buffers added are cleared to 0, the back buffer 
+ * is kept, and is the front one too until the next swap. If one can't be 
+ * allocated, only the back buffer is left.
+ */
+int SrpRCSetSwapBuffers(int count)
+{
+    int i;
+    unsigned char *pTemp;
+
+    ASSERTMSG(sg_pRC != NULL && count >= 1 && count <= SRP_MAX_SWAP_BUFFERS, 
+        "SrpRCSetSwapBuffers: invalid arguments.");
+    ASSERTMSG(!sg_pRC->targetLocked, "SrpRCSetSwapBuffers: target locked.");
+
+    /* Keep the back buffer in the first */
+    pTemp = sg_pRC->pBuffers[0];
+    sg_pRC->pBuffers[0] = sg_pRC->pBuffers[sg_pRC->backIndex];
+    sg_pRC->pBuffers[sg_pRC->backIndex] = pTemp;
+    sg_pRC->backIndex = 0;
+    sg_pRC->frontIndex = 0;
+
+    for (i = count; i < sg_pRC->numBuffers; i++)
+    {
+        IgFreeMemory(sg_pRC->pBuffers[i]);
+    }
+    for (i = sg_pRC->numBuffers; i < count; i++)
+    {
+        if (!IgNewMemory((void **)&(sg_pRC->pBuffers[i]), sg_pRC->size))
+        {
+            printf("Error: not enough memory for swap buffers.\n");
+
+            /* Back to the one buffer kept */
+            for (i = i - 1; i >= 1; i--)
+            {
+                IgFreeMemory(sg_pRC->pBuffers[i]);
+            }
+            sg_pRC->numBuffers = 1;
+            sg_pRC->allDirty = TRUE;
+            return FALSE;
+        }
+        memset(sg_pRC->pBuffers[i], 0, sg_pRC->size);
+    }
+    sg_pRC->numBuffers = count;
+    sg_pRC->allDirty = TRUE;
+
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpRCSwap(void)
+ *
+ * This function makes the back buffer the front one, the frame drawn on 
+ * it done, and goes on to the next buffer in the chain. A front buffer 
+ * isn't drawn on again until numBuffers - 1 more swaps, that's how long 
+ * it can be presented from. With one buffer it's drawn on at once.
+ */
+void SrpRCSwap(void)
+{
+    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+    ASSERTMSG(!sg_pRC->targetLocked, "SrpRCSwap: target locked.");
+
+    /* The tracking of tiles is for the back buffer */
+    SrpRCFinishClear();
+    SrpRCUpdateDirty();
+
+    sg_pRC->frontIndex = sg_pRC->backIndex;
+    sg_pRC->backIndex = (sg_pRC->backIndex + 1) % sg_pRC->numBuffers;
+    sg_pRC->buffer = sg_pRC->pBuffers[sg_pRC->backIndex];
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpRCMarkDirty(int xMin, int yMin, int xMax, int yMax)
+ *
+ * This function marks the tiles a rectangle, both ends included, 
+ * overlaps as drawn on in this frame. It's clamped to the buffer.
+ */
+void SrpRCMarkDirty(int xMin, int yMin, int xMax, int yMax)
+{
+    int x, y;
+    unsigned char *pRow;
+
+    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+
+    xMin = xMin < 0 ? 0 : xMin;
+    yMin = yMin < 0 ? 0 : yMin;
+    xMax = xMax >= sg_pRC->width ? sg_pRC->width - 1 : xMax;
+    yMax = yMax >= sg_pRC->height ? sg_pRC->height - 1 : yMax;
+    if (xMin > xMax || yMin > yMax)
+    {
+        return;
+    }
+
+    xMin >>= SRP_DIRTY_TILE_SHIFT;
+    xMax >>= SRP_DIRTY_TILE_SHIFT;
+    yMin >>= SRP_DIRTY_TILE_SHIFT;
+    yMax >>= SRP_DIRTY_TILE_SHIFT;
+    for (y = yMin; y <= yMax; y++)
+    {
+        pRow = sg_pRC->pTileDrawn + y * sg_pRC->dirtyTilesX;
+        for (x = xMin; x <= xMax; x++)
+        {
+            pRow[x] = TRUE;
+        }
     }
 }
 
+/*------------------------------------------------------------------------------
+ * const unsigned char* SrpRCGetDirtyTiles(int *pTilesX, int *pTilesY)
+ *
+ * This function gets the front buffer's dirty tiles, a byte each row by 
+ * row, TRUE where it may differ from the front buffer before it. The 
+ * tiles across and down are returned in pTilesX and pTilesY.
+ */
+const unsigned char* SrpRCGetDirtyTiles(int *pTilesX, int *pTilesY)
+{
+    ASSERTMSG(sg_pRC != NULL && pTilesX != NULL && pTilesY != NULL, 
+        "SrpRCGetDirtyTiles: invalid arguments.");
+
+    *pTilesX = sg_pRC->dirtyTilesX;
+    *pTilesY = sg_pRC->dirtyTilesY;
+
+    return sg_pRC->pTileDirty;
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpRCLockTarget(SRP_TARGET *pTarget)
+ *
+ * This function locks the frame buffer for writing directly and fills 
+ * pTarget with how it's laid out. Tiles SRP_LAZY_CLEAR has left are 
+ * cleared first. It's not locked twice.
+ */
+int SrpRCLockTarget(SRP_TARGET *pTarget)
+{
+    ASSERTMSG(sg_pRC != NULL && pTarget != NULL, 
+        "SrpRCLockTarget: invalid arguments.");
+    ASSERTMSG(!sg_pRC->targetLocked, "SrpRCLockTarget: already locked.");
+
+    SrpRCFinishClear();
+
+    pTarget->pBits  = sg_pRC->buffer;
+    pTarget->pitch  = sg_pRC->pitch;
+    pTarget->format = sg_pRC->format;
+    pTarget->bit    = sg_pRC->bit;
+    pTarget->width  = sg_pRC->width;
+    pTarget->height = sg_pRC->height;
+
+    sg_pRC->targetLocked = TRUE;
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpRCUnlockTarget(void)
+ *
+ * This function unlocks the frame buffer locked by SrpRCLockTarget, the 
+ * pointer got is not to be written through any more.
+ */
+void SrpRCUnlockTarget(void)
+{
+    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+    ASSERTMSG(sg_pRC->targetLocked, "SrpRCUnlockTarget: not locked.");
+
+    sg_pRC->targetLocked = FALSE;
+}
+
 /*------------------------------------------------------------------------------
  * void SrpRCClear(void)
  *
- * This function clears The Buffer With current clearing color.
+ * This function clears The Buffer With current clearing color. With 
+ * SRP_LAZY_CLEAR enabled, tiles are only marked to be cleared, when 
+ * they're first drawn on, or when the buffer is got for the rest.
  */
 void SrpRCClear(void)
 {
     ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
 
-    memcpy(sg_pRC->buffer, sg_pRC->clearBuffer, sg_pRC->size);
+    sg_pRC->frameCleared = TRUE;
+
+    /* Direct writes to a locked target aren't seen to clear tiles first */
+    if (sg_pRC->bufferAttrib.lazyClearFlag && !sg_pRC->targetLocked)
+    {
+        memset(sg_pRC->pTilePending, TRUE, sg_pRC->numTiles);
+        sg_pRC->numPending = sg_pRC->numTiles;
+        return;
+    }
+
+    memset(sg_pRC->pTilePending, FALSE, sg_pRC->numTiles);
+    sg_pRC->numPending = 0;
+
+    SrpRCFill(sg_pRC->buffer, sg_pRC->clearPixel, sg_pRC->size, 
+              sg_pRC->size >= SRP_CLEAR_STREAM_SIZE);
 }
 
 /*------------------------------------------------------------------------------
@@ -548,6 +1633,7 @@ void SrpRCCombineMatrix43f(const MATRIX43F m)
 
     SrpMatrixMultiply43f(temp, m, *sg_pRC->pfCurrentMatrix);
     SrpMatrixCopy43f(*sg_pRC->pfCurrentMatrix, temp);
+    SrpRCTouchMatrix();
 }
 
 /*------------------------------------------------------------------------------
@@ -633,6 +1719,7 @@ void SrpRCPopMatrix(void)
     {
         (*sg_pRC->pCurrentStackPos)--;
         (sg_pRC->pfCurrentMatrix)--;
+        SrpRCTouchMatrix();
     }
 }
 
@@ -646,6 +1733,7 @@ void SrpRCLoadIdentity(void)
     ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
 
     SrpMatrixLoadIdentity43f(*sg_pRC->pfCurrentMatrix);
+    SrpRCTouchMatrix();
 }
 
 /*------------------------------------------------------------------------------
@@ -667,6 +1755,208 @@ int SrpRCIsVisible(const VECTOR3F pos, float radius)
     return SrpIsVisibleInFrustum(sg_pRC->pFrustum, pos, radius);
 }
 
+/*------------------------------------------------------------------------------
+ * int SrpRCIsInside(const VECTOR3F pos)
+ *
+ * Check if a point is inside current frustum in RC.
+ */
+int SrpRCIsInside(const VECTOR3F pos)
+{
+    ASSERTMSG(sg_pRC != NULL && sg_pRC->pFrustum != NULL, 
+              "Rendering context has not been initialized.");
+
+    return SrpIsInsideFrustum(sg_pRC->pFrustum, pos);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpRCGetOutcodeArray(const VECTOR3F *pos, int n, int planeMask, 
+ *                           int *pOutcode)
+ *
+ * Get the outcodes of n points with current frustum in RC.
+ */
+void SrpRCGetOutcodeArray(const VECTOR3F *pos, int n, int planeMask, 
+                          int *pOutcode)
+{
+    ASSERTMSG(sg_pRC != NULL && sg_pRC->pFrustum != NULL, 
+              "Rendering context has not been initialized.");
+
+    SrpGetFrustumOutcodeArray(sg_pRC->pFrustum, pos, n, planeMask, pOutcode);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpRCGetOutcodeStream(const VEC3_STREAM *pStream, int planeMask, 
+ *                            int *pOutcode)
+ *
+ * Get the outcodes of the points of a stream with current frustum in RC.
+ */
+void SrpRCGetOutcodeStream(const VEC3_STREAM *pStream, int planeMask, 
+                           int *pOutcode)
+{
+    ASSERTMSG(sg_pRC != NULL && sg_pRC->pFrustum != NULL, 
+              "Rendering context has not been initialized.");
+
+    SrpGetFrustumOutcodeStream(sg_pRC->pFrustum, pStream, planeMask, pOutcode);
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpRCClipTriangle(VECTOR3F *pPoly, int planeMask)
+ *
+ * Clip a triangle against current frustum in RC.
+ */
+int SrpRCClipTriangle(VECTOR3F *pPoly, int planeMask)
+{
+    ASSERTMSG(sg_pRC != NULL && sg_pRC->pFrustum != NULL, 
+              "Rendering context has not been initialized.");
+
+    return SrpClipTriangleInFrustum(sg_pRC->pFrustum, pPoly, planeMask);
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpRCClassifySphere(const VECTOR3F pos, float radius)
+ *
+ * Check if a sphere is outside, intersecting or completely inside 
+ * current frustum in RC, see SrpClassifySphereInFrustum.
+ */
+int SrpRCClassifySphere(const VECTOR3F pos, float radius)
+{
+    ASSERTMSG(sg_pRC != NULL && sg_pRC->pFrustum != NULL, 
+              "Rendering context has not been initialized.");
+
+    return SrpClassifySphereInFrustum(sg_pRC->pFrustum, pos, radius);
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpRCCullSphere(const VECTOR3F pos, float radius, int *pPlaneMask, 
+ *                     int *pLastPlane)
+ *
+ * Check a sphere against some planes of current frustum in RC, see 
+ * SrpCullSphereInFrustum.
+ */
+int SrpRCCullSphere(const VECTOR3F pos, float radius, int *pPlaneMask, 
+                    int *pLastPlane)
+{
+    ASSERTMSG(sg_pRC != NULL && sg_pRC->pFrustum != NULL, 
+              "Rendering context has not been initialized.");
+
+    return SrpCullSphereInFrustum(sg_pRC->pFrustum, pos, radius, 
+                                  pPlaneMask, pLastPlane);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpRCSetCullPlaneMask(int planeMask)
+ *
+ * Set the frustum planes objects are tested against when drawn, e.g. 
+ * those the node of a hierarchy being drawn is not completely inside.
+ * FRUSTUM_PLANES_ALL by default.
+ */
+void SrpRCSetCullPlaneMask(int planeMask)
+{
+    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+    ASSERTMSG((planeMask & ~FRUSTUM_PLANES_ALL) == 0, 
+              "SrpRCSetCullPlaneMask: invalid argument.");
+
+    sg_pRC->objectAttrib.cullPlaneMask = planeMask;
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpRCGetCullPlaneMask(void)
+ *
+ * Get the frustum planes objects are tested against when drawn.
+ */
+int SrpRCGetCullPlaneMask(void)
+{
+    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+
+    return sg_pRC->objectAttrib.cullPlaneMask;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpRCSetSmallObject(float pixels, int mode)
+ *
+ * Set how SRP_CULL_SMALL works. Objects whose projected diameter is 
+ * under pixels are dropped with SRP_SMALL_DROP, or drawn as a single 
+ * point with SRP_SMALL_SPLAT. 1 pixel and SRP_SMALL_DROP by default.
+ */
+void SrpRCSetSmallObject(float pixels, int mode)
+{
+    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+    ASSERTMSG(pixels >= 0.0f && 
+              (mode == SRP_SMALL_DROP || mode == SRP_SMALL_SPLAT), 
+              "SrpRCSetSmallObject: invalid arguments.");
+
+    sg_pRC->objectAttrib.smallPixels = pixels;
+    sg_pRC->objectAttrib.smallMode = mode;
+}
+
+/*------------------------------------------------------------------------------
+ * float SrpRCGetSmallPixels(void)
+ * int SrpRCGetSmallMode(void)
+ *
+ * Get how SRP_CULL_SMALL works, see SrpRCSetSmallObject.
+ */
+float SrpRCGetSmallPixels(void)
+{
+    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+
+    return sg_pRC->objectAttrib.smallPixels;
+}
+
+int SrpRCGetSmallMode(void)
+{
+    ASSERTMSG(sg_pRC != NULL, "Rendering context has not been initialized.");
+
+    return sg_pRC->objectAttrib.smallMode;
+}
+
+/*------------------------------------------------------------------------------
+ * const FRUSTUM* SrpRCGetWorldFrustum(void)
+ *
+ * Get current frustum in world space, i.e. in the space current 
+ * modelview matrix transforms from, so spheres in world space are 
+ * tested without being transformed. It's only rebuilt when the 
+ * modelview matrix or the frustum has changed, once a frame normally.
+ */
+const FRUSTUM* SrpRCGetWorldFrustum(void)
+{
+    const MATRIX43F *pModelView;
+
+    ASSERTMSG(sg_pRC != NULL && sg_pRC->pFrustum != NULL, 
+              "Rendering context has not been initialized.");
+
+    pModelView = SrpRCGetModelView();
+    if (!sg_pRC->worldFrustumValid || 
+        memcmp(sg_pRC->fWorldFrustumView, *pModelView, sizeof(MATRIX43F)))
+    {
+        SrpTransformFrustum(sg_pRC->pWorldFrustum, sg_pRC->pFrustum, 
+                            *pModelView);
+        SrpMatrixCopy43f(sg_pRC->fWorldFrustumView, *pModelView);
+        sg_pRC->worldFrustumValid = TRUE;
+    }
+
+    return sg_pRC->pWorldFrustum;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpRCCullSpheresBatch(const float *x, const float *y, 
+ *                            const float *z, const float *r, int n, 
+ *                            byte *pVisible)
+ *
+ * Check if n spheres in world space are visible with current frustum 
+ * in RC, with current modelview matrix as the world to camera 
+ * transformation.
+ */
+void SrpRCCullSpheresBatch(const float *x, const float *y, 
+                           const float *z, const float *r, int n, 
+                           byte *pVisible)
+{
+    ASSERTMSG(sg_pRC != NULL && sg_pRC->pFrustum != NULL, 
+              "Rendering context has not been initialized.");
+
+    /* Centers are tested as they are, in world space */
+    SrpCullSpheresBatch(SrpRCGetWorldFrustum(), NULL, x, y, z, r, n, 
+                        pVisible);
+}
+
 /*------------------------------------------------------------------------------
  * void SrpRCEnable(int cap)
  *
@@ -701,9 +1991,24 @@ int SrpRCIsEnabled(int cap)
     case SRP_CULL_OBJECT:
         return sg_pRC->objectAttrib.cullFlag;
 
+    case SRP_LOD_OBJECT:
+        return sg_pRC->objectAttrib.lodFlag;
+
+    case SRP_CULL_MESHLET:
+        return sg_pRC->objectAttrib.meshletFlag;
+
+    case SRP_CULL_SMALL:
+        return sg_pRC->objectAttrib.smallFlag;
+
+    case SRP_VERTEX_STREAM:
+        return sg_pRC->objectAttrib.streamFlag;
+
     case SRP_CULL_FACE:
         return sg_pRC->polygonAttrib.cullFlag;
 
+    case SRP_LAZY_CLEAR:
+        return sg_pRC->bufferAttrib.lazyClearFlag;
+
     default:
         ASSERTMSG(FALSE, "SrpRCIsEnabled: unknown capability.");
         return FALSE;
@@ -19,6 +19,7 @@
 #include "raster_srp.h"
 #include "vector_srp.h"
 #include "matrix_srp.h"
+#include "frustum_srp.h"
 
 /*----------------------------------------------------------------------------*/
 /*                               Data Structure                               */
@@ -60,10 +61,199 @@ struct RENDER_LIST_T
 /*                       Private Function Declarations                        */
 /*----------------------------------------------------------------------------*/
 
+static int SrpClipTriangleNear(VECTOR4F out[4], const VECTOR4F in[3]);
+static void SrpDivideTriangle(TRIANGLE_INDIE *pTri, const VECTOR4F a, 
+                              const VECTOR4F b, const VECTOR4F c);
+static int SrpTransRenderListToClip(RENDER_LIST *pRl, const MATRIX44F m);
+
 /*----------------------------------------------------------------------------*/
 /*                             Private Functions                              */
 /*----------------------------------------------------------------------------*/
 
+/*------------------------------------------------------------------------------
+ * int SrpClipTriangleNear(VECTOR4F out[4], const VECTOR4F in[3])
+ *
+ * Clip a triangle in clip space against the near plane z = -w, 
+ * the only one dividing by w can't cope with. Return how many 
+ * vertices the clipped polygon has in out, 3 or 4, in the same 
+ * winding, or 0 if none is left.
+ */
+static int SrpClipTriangleNear(VECTOR4F out[4], const VECTOR4F in[3])
+{
+    int i, j, k, n;
+    float di, dj, t;
+
+    n = 0;
+    for (i = 0; i < 3; i++)
+    {
+        j = (i + 1) % 3;
+        di = in[i][2] + in[i][3];
+        dj = in[j][2] + in[j][3];
+
+        if (di >= 0.0f)
+        {
+            SrpVectorCopy4f(out[n++], in[i]);
+        }
+
+        /* The edge crosses the plane */
+        if ((di >= 0.0f) != (dj >= 0.0f))
+        {
+            t = di / (di - dj);
+            for (k = 0; k < 4; k++)
+            {
+                out[n][k] = in[i][k] + t * (in[j][k] - in[i][k]);
+            }
+            n++;
+        }
+    }
+
+    return n;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpDivideTriangle(TRIANGLE_INDIE *pTri, const VECTOR4F a, 
+ *                        const VECTOR4F b, const VECTOR4F c)
+ *
+ * Divide clip space vertices a, b and c by w into the triangle. Each 
+ * coordinate is divided, not multiplied by a reciprocal, so a vertex 
+ * clipped to x = w, say, lands on x = 1 exactly.
+ */
+static void SrpDivideTriangle(TRIANGLE_INDIE *pTri, const VECTOR4F a, 
+                              const VECTOR4F b, const VECTOR4F c)
+{
+    const float *v[3];
+    int j;
+
+    v[0] = a;
+    v[1] = b;
+    v[2] = c;
+
+    for (j = 0; j < 3; j++)
+    {
+        pTri->vList[j][0] = v[j][0] / v[j][3];
+        pTri->vList[j][1] = v[j][1] / v[j][3];
+        pTri->vList[j][2] = v[j][2] / v[j][3];
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpTransRenderListToClip(RENDER_LIST *pRl, const MATRIX44F m)
+ *
+ * Transform render list into clip space with m, see 
+ * SrpTransRenderListCamToClip.
+ *
+ * Triangles are kept in place, which is fine as triPtr[i] points to 
+ * triData[i] and the kept ones never get ahead of i. The second half 
+ * of a triangle cut in two by the near plane takes the slot of one 
+ * dropped before it if there is any, otherwise it goes after the last 
+ * one for now, and is moved down at the end.
+ */
+static int SrpTransRenderListToClip(RENDER_LIST *pRl, const MATRIX44F m)
+{
+    VECTOR4F clip[3], poly[4];
+    int code[3];
+    TRIANGLE_INDIE *pTri, *pDst;
+    int i, j, n, numVerts, numKept, numExtra, numLost;
+
+    n = pRl->numTriangles;
+    numKept = 0;
+    numExtra = 0;
+    numLost = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        pTri = pRl->triPtr[i];
+        if (!pTri)
+        {
+            ASSERTMSG(FALSE, "SrpTransRenderListToClip: \
+invalid TRIANGLE_INDIE pointer.");
+            return FALSE;
+        }
+
+        SrpMatrixTransformVectors44f(clip, (const VECTOR3F *)pTri->vList, 
+                                     3, m);
+        for (j = 0; j < 3; j++)
+        {
+            code[j] = SrpGetClipOutcode(clip[j]);
+        }
+
+        /* All three vertices outside of the same plane */
+        if (code[0] & code[1] & code[2])
+        {
+            continue;
+        }
+
+        if ((code[0] | code[1] | code[2]) & FRUSTUM_PLANE_NEAR)
+        {
+            numVerts = SrpClipTriangleNear(poly, (const VECTOR4F *)clip);
+            if (numVerts < 3)
+            {
+                continue;
+            }
+        }
+        else
+        {
+            numVerts = 3;
+            for (j = 0; j < 3; j++)
+            {
+                SrpVectorCopy4f(poly[j], clip[j]);
+            }
+        }
+
+        pDst = &pRl->triData[numKept];
+        if (pDst != pTri)
+        {
+            *pDst = *pTri;
+        }
+        SrpDivideTriangle(pDst, poly[0], poly[1], poly[2]);
+        pRl->triPtr[numKept++] = pDst;
+
+        if (numVerts < 4)
+        {
+            continue;
+        }
+
+        if (numKept <= i)
+        {
+            /* Slot numKept held a dropped triangle, already read */
+            pRl->triData[numKept] = *pDst;
+            SrpDivideTriangle(&pRl->triData[numKept], 
+                              poly[0], poly[2], poly[3]);
+            pRl->triPtr[numKept] = &pRl->triData[numKept];
+            numKept++;
+        }
+        else if (n + numExtra < RENDER_LIST_MAX_TRIANGLES)
+        {
+            pRl->triData[n + numExtra] = *pDst;
+            SrpDivideTriangle(&pRl->triData[n + numExtra], 
+                              poly[0], poly[2], poly[3]);
+            numExtra++;
+        }
+        else
+        {
+            numLost++;
+        }
+    }
+
+    for (j = 0; j < numExtra; j++)
+    {
+        pRl->triData[numKept] = pRl->triData[n + j];
+        pRl->triPtr[numKept] = &pRl->triData[numKept];
+        numKept++;
+    }
+
+    pRl->numTriangles = numKept;
+
+    if (numLost > 0)
+    {
+        printf("Error: render list is full, %d near plane triangles \
+lost.\n", numLost);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
 /*----------------------------------------------------------------------------*/
 /*                              Public Functions                              */
 /*----------------------------------------------------------------------------*/
@@ -238,7 +428,7 @@ void SrpTransRenderListLocToCam(RENDER_LIST *pRl)
     VECTOR3F tempVector;
     TRIANGLE_INDIE *pTri;
     int i, j;
-    MATRIX43F *modelView;
+    const MATRIX43F *modelView;
 
     ASSERTMSG(pRl != NULL, "SrpTransRenderListLocToCam: invalid arguments.");
 
@@ -272,13 +462,16 @@ void SrpTransRenderListCamToProj(RENDER_LIST *pRl)
     TRIANGLE_INDIE *pTri;
     int i, j;
     float fovy, aspect;
+#if defined(SRP_FAST_MATH)
+    float d;
+#endif
 
     ASSERTMSG(pRl != NULL, "SrpTransRenderListCamToProj: invalid arguments.");
 
     fovy = SrpRCGetFovy();
     aspect = SrpRCGetAspect();
 
-    oneOverTanTheta = 1.0f / tanf(SrpMathDegToRadf(fovy / 2.0f));
+    oneOverTanTheta = 1.0f / SrpMathTanf(SrpMathDegToRadf(fovy / 2.0f));
 
     for (i = 0; i < pRl->numTriangles; i++)
     {
@@ -293,17 +486,56 @@ invalid TRIANGLE_INDIE pointer.");
         /*
          * Xp = Xc * d / Zc, Yp = Yc * d * aspect / Zc.
          * We use right-handed system, so d = -1 / tan. 
+         * With SRP_FAST_MATH take one reciprocal of Zc per vertex instead 
+         * of two divisions, it rounds twice so it's kept out of the 
+         * default build.
          */
         for (j = 0; j < 3; j++)
         {
+#if defined(SRP_FAST_MATH)
+            d = -oneOverTanTheta * SrpMathRcpf(pTri->vList[j][2]);
+            pTri->vList[j][0] *= d;
+            pTri->vList[j][1] *= d * aspect;
+#else
             pTri->vList[j][0] = -1.0f * pTri->vList[j][0] * 
                 oneOverTanTheta / pTri->vList[j][2];
             pTri->vList[j][1] = -1.0f * pTri->vList[j][1] * 
                 oneOverTanTheta * aspect / pTri->vList[j][2];
+#endif
         }
     }
 }
 
+/*------------------------------------------------------------------------------
+ * int SrpTransRenderListCamToClip(RENDER_LIST *pRl)
+ * int SrpTransRenderListLocToClip(RENDER_LIST *pRl)
+ *
+ * Transform render list from camera space, or straight from local 
+ * space with the fused modelview and projection matrix, into 
+ * homogeneous clip space. Triangles with all vertices outside of 
+ * one plane are dropped by their outcodes, and those crossing the 
+ * near plane are clipped there, at most one new triangle each. What 
+ * is left is divided by w into projection space, as 
+ * SrpTransRenderListCamToProj would leave it but with z in [-1, 1].
+ *
+ * Return:
+ *     TRUE if successful; FALSE if the render list had no room left 
+ *     for the extra triangles, which are then lost.
+ */
+int SrpTransRenderListCamToClip(RENDER_LIST *pRl)
+{
+    ASSERTMSG(pRl != NULL, "SrpTransRenderListCamToClip: invalid arguments.");
+
+    return SrpTransRenderListToClip(pRl, *SrpRCGetProjection());
+}
+
+int SrpTransRenderListLocToClip(RENDER_LIST *pRl)
+{
+    ASSERTMSG(pRl != NULL, "SrpTransRenderListLocToClip: invalid arguments.");
+
+    return SrpTransRenderListToClip(pRl, *SrpRCGetModelViewProjection());
+}
+
 /*------------------------------------------------------------------------------
  * void SrpTransRenderListProjToScr(RENDER_LIST *pRl)
  *
@@ -0,0 +1,465 @@
+/*******************************************************************************
+ * File   : scene_srp.c
+ * Content: Scene graph
+ *
+ * Coder  : Ean Jee
+ * Time   : 2026-10-19 13:52
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <math.h>
+#include "datadef_ig.h"
+#include "assert_ig.h"
+#include "malloc_ig.h"
+#include "datadef_srp.h"
+#include "math_srp.h"
+#include "vector_srp.h"
+#include "matrix_srp.h"
+#include "quaternion_srp.h"
+#include "frustum_srp.h"
+#include "rcmanager_srp.h"
+#include "scene_srp.h"
+
+/*----------------------------------------------------------------------------*/
+/*                               Data Structure                               */
+/*----------------------------------------------------------------------------*/
+
+#define SCENE_NODE_CLEAN          0x00000000
+#define SCENE_NODE_DIRTY_WORLD    0x00000001 /* Local transformation changed */
+#define SCENE_NODE_DIRTY_BOUNDS   0x00000002 /* Something below changed */
+
+struct SCENE_NODE_T
+{
+    int dirty;
+
+    SCENE_NODE *pParent;
+    SCENE_NODE *pFirstChild;
+    SCENE_NODE *pNextSibling;
+
+    OBJECT *pObj;
+
+    VECTOR3F translation;   /* Local transformation relative to the parent */
+    QUATERNION orientation;
+    VECTOR3F scale;
+
+    MATRIX43F world;        /* Local to world */
+
+    VECTOR3F center;        /* Bounding sphere of the subtree in world space */
+    float radius;           /* Negative if the subtree is empty */
+
+    int cullPlane;          /* Frustum plane which culled it last time */
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                Private Data                                */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                       Private Function Declarations                        */
+/*----------------------------------------------------------------------------*/
+
+static void SrpSceneNodeMarkDirty(SCENE_NODE *pNode, int flag);
+static float SrpSceneMatrixMaxScale(const MATRIX43F m);
+static void SrpSceneMergeSphere(VECTOR3F center, float *pRadius, 
+                                const VECTOR3F center2, float radius2);
+static void SrpSceneNodeUpdate(SCENE_NODE *pNode, const MATRIX43F parentWorld,
+                               int force);
+static void SrpSceneNodeDraw(SCENE_NODE *pNode, RENDER_LIST *pRl, 
+                             const FRUSTUM *pFrustum, int planeMask);
+
+/*----------------------------------------------------------------------------*/
+/*                             Private Functions                              */
+/*----------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------
+ * void SrpSceneNodeMarkDirty(SCENE_NODE *pNode, int flag)
+ *
+ * Mark a node dirty, and the bounds of its ancestors, so the update 
+ * knows which paths to walk down.
+ */
+static void SrpSceneNodeMarkDirty(SCENE_NODE *pNode, int flag)
+{
+    SET_BIT(pNode->dirty, flag | SCENE_NODE_DIRTY_BOUNDS);
+
+    for (pNode = pNode->pParent; pNode != NULL; pNode = pNode->pParent)
+    {
+        /* The rest of the path has been marked already */
+        if (pNode->dirty & SCENE_NODE_DIRTY_BOUNDS)
+        {
+            break;
+        }
+        SET_BIT(pNode->dirty, SCENE_NODE_DIRTY_BOUNDS);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * float SrpSceneMatrixMaxScale(const MATRIX43F m)
+ *
+ * Get the largest scale factor of a matrix, the length of its longest 
+ * row of the linear transformation portion.
+ */
+static float SrpSceneMatrixMaxScale(const MATRIX43F m)
+{
+    float maxScale;
+
+    maxScale = SrpMathMax(SrpVectorLengthSquared3f(&m[0]), 
+                          SrpVectorLengthSquared3f(&m[3]));
+    maxScale = SrpMathMax(maxScale, SrpVectorLengthSquared3f(&m[6]));
+
+    return sqrtf(maxScale);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpSceneMergeSphere(VECTOR3F center, float *pRadius, 
+ *                          const VECTOR3F center2, float radius2)
+ *
+ * Grow sphere (center, *pRadius) to enclose sphere (center2, radius2).
+ * An empty sphere has a negative radius.
+ */
+static void SrpSceneMergeSphere(VECTOR3F center, float *pRadius, 
+                                const VECTOR3F center2, float radius2)
+{
+    VECTOR3F offset;
+    float distance, radius;
+
+    if (radius2 < 0.0f)
+    {
+        return;
+    }
+
+    SrpVectorSubtract3f(offset, center2, center);
+    distance = SrpVectorLength3f(offset);
+
+    /* The second one is already inside */
+    if (*pRadius >= 0.0f && distance + radius2 <= *pRadius)
+    {
+        return;
+    }
+
+    /* The first one is empty or inside the second one */
+    if (*pRadius < 0.0f || distance + *pRadius <= radius2)
+    {
+        SrpVectorCopy3f(center, center2);
+        *pRadius = radius2;
+        return;
+    }
+
+    /* Slide the center towards the second one, by the radius grown */
+    radius = (distance + *pRadius + radius2) * 0.5f;
+    SrpVectorScale3f(offset, offset, (radius - *pRadius) / distance);
+    SrpVectorAdd3f(center, center, offset);
+    *pRadius = radius;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpSceneNodeUpdate(SCENE_NODE *pNode, const MATRIX43F parentWorld,
+ *                         int force)
+ *
+ * Update the world matrices down dirty subtrees, then bounds on the way
+ * back up. force is set if an ancestor's world matrix has changed.
+ */
+static void SrpSceneNodeUpdate(SCENE_NODE *pNode, const MATRIX43F parentWorld,
+                               int force)
+{
+    int i;
+    float radius;
+    VECTOR3F center;
+    MATRIX43F local;
+    SCENE_NODE *pChild;
+
+    if (!force && pNode->dirty == SCENE_NODE_CLEAN)
+    {
+        return;
+    }
+
+    if (force || pNode->dirty & SCENE_NODE_DIRTY_WORLD)
+    {
+        /* Scale, rotate, then translate, as objects do */
+        SrpQuaternionToMatrix43f(local, pNode->orientation);
+        for (i = 0; i < 9; i++)
+        {
+            local[i] *= pNode->scale[i / 3];
+        }
+        SrpVectorCopy3f(&local[9], pNode->translation);
+
+        SrpMatrixMultiply43f(pNode->world, local, parentWorld);
+        force = TRUE;
+    }
+
+    for (pChild = pNode->pFirstChild; pChild != NULL; 
+         pChild = pChild->pNextSibling)
+    {
+        SrpSceneNodeUpdate(pChild, pNode->world, force);
+    }
+
+    pNode->radius = -1.0f;
+    if (pNode->pObj != NULL)
+    {
+        SrpGetObjectBounds(pNode->pObj, center, &radius);
+        SrpMatrixTransformVector3f(pNode->center, center, pNode->world);
+        pNode->radius = radius * SrpSceneMatrixMaxScale(pNode->world);
+    }
+
+    for (pChild = pNode->pFirstChild; pChild != NULL; 
+         pChild = pChild->pNextSibling)
+    {
+        SrpSceneMergeSphere(pNode->center, &pNode->radius, 
+                            pChild->center, pChild->radius);
+    }
+
+    CLEAN_BIT(pNode->dirty);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpSceneNodeDraw(SCENE_NODE *pNode, RENDER_LIST *pRl, 
+ *                       const FRUSTUM *pFrustum, int planeMask)
+ *
+ * Draw a subtree, skipping it as a whole if its bounds are invisible.
+ * Only the planes of pFrustum, in world space, in planeMask are tested, 
+ * the parent is completely inside the others.
+ */
+static void SrpSceneNodeDraw(SCENE_NODE *pNode, RENDER_LIST *pRl, 
+                             const FRUSTUM *pFrustum, int planeMask)
+{
+    SCENE_NODE *pChild;
+
+    if (pNode->radius <= 0.0f)
+    {
+        return;
+    }
+
+    /* One test culls the whole subtree */
+    if (pFrustum != NULL && planeMask != 0 && 
+        SrpCullSphereInFrustum(pFrustum, pNode->center, pNode->radius, 
+                               &planeMask, &pNode->cullPlane) == 
+        FRUSTUM_OUTSIDE)
+    {
+        return;
+    }
+
+    if (pNode->pObj != NULL)
+    {
+        SrpRCSetCullPlaneMask(planeMask);
+        SrpRCPushMatrix();
+        SrpRCCombineMatrix43f(pNode->world);
+        SrpDrawObject(pNode->pObj, pRl);
+        SrpRCPopMatrix();
+    }
+
+    for (pChild = pNode->pFirstChild; pChild != NULL; 
+         pChild = pChild->pNextSibling)
+    {
+        SrpSceneNodeDraw(pChild, pRl, pFrustum, planeMask);
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/*                              Public Functions                              */
+/*----------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------
+ * int SrpCreateSceneNode(SCENE_NODE **ppNode, OBJECT *pObj)
+ *
+ * Create scene node with identity local transformation. pObj may be 
+ * NULL for a node grouping its children.
+ */
+int SrpCreateSceneNode(SCENE_NODE **ppNode, OBJECT *pObj)
+{
+    SCENE_NODE *pNode;
+
+    ASSERTMSG(ppNode != NULL, "SrpCreateSceneNode: invalid arguments.");
+
+    if (!IgNewMemory((void **)ppNode, sizeof(SCENE_NODE)))
+    {
+        printf("Error: create scene node failed.\n");
+        return FALSE;
+    }
+
+    pNode = *ppNode;
+    pNode->dirty = SCENE_NODE_DIRTY_WORLD | SCENE_NODE_DIRTY_BOUNDS;
+    pNode->pParent = NULL;
+    pNode->pFirstChild = NULL;
+    pNode->pNextSibling = NULL;
+    pNode->pObj = pObj;
+
+    SrpVectorCopy3f(pNode->translation, ZERO_VECTOR);
+    SrpQuaternionLoadIdentity(pNode->orientation);
+    SrpVectorLoad3f(pNode->scale, 1.0f, 1.0f, 1.0f);
+    SrpMatrixLoadIdentity43f(pNode->world);
+
+    SrpVectorCopy3f(pNode->center, ZERO_VECTOR);
+    pNode->radius = -1.0f;
+    pNode->cullPlane = 0;
+
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpDeleteSceneNode(SCENE_NODE *pNode)
+ *
+ * Delete scene node and its subtree. Objects are not deleted.
+ */
+void SrpDeleteSceneNode(SCENE_NODE *pNode)
+{
+    SCENE_NODE *pChild, *pNext;
+
+    ASSERTMSG(pNode != NULL, "SrpDeleteSceneNode: invalid arguments.");
+
+    SrpSceneNodeDetach(pNode);
+
+    for (pChild = pNode->pFirstChild; pChild != NULL; pChild = pNext)
+    {
+        pNext = pChild->pNextSibling;
+        pChild->pParent = NULL;
+        SrpDeleteSceneNode(pChild);
+    }
+
+    IgFreeMemory(pNode);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpSceneNodeAddChild(SCENE_NODE *pParent, SCENE_NODE *pChild)
+ *
+ * Add a child to a node, the child must not have a parent yet.
+ */
+void SrpSceneNodeAddChild(SCENE_NODE *pParent, SCENE_NODE *pChild)
+{
+    ASSERTMSG(pParent != NULL && pChild != NULL && pChild->pParent == NULL &&
+              pParent != pChild, "SrpSceneNodeAddChild: invalid arguments.");
+
+    pChild->pParent = pParent;
+    pChild->pNextSibling = pParent->pFirstChild;
+    pParent->pFirstChild = pChild;
+
+    /* The child's world matrix depends on its new parent now */
+    SrpSceneNodeMarkDirty(pChild, SCENE_NODE_DIRTY_WORLD);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpSceneNodeDetach(SCENE_NODE *pNode)
+ *
+ * Detach a node with its subtree from its parent.
+ */
+void SrpSceneNodeDetach(SCENE_NODE *pNode)
+{
+    SCENE_NODE **ppLink;
+
+    ASSERTMSG(pNode != NULL, "SrpSceneNodeDetach: invalid arguments.");
+
+    if (pNode->pParent == NULL)
+    {
+        return;
+    }
+
+    SrpSceneNodeMarkDirty(pNode->pParent, SCENE_NODE_DIRTY_BOUNDS);
+
+    for (ppLink = &pNode->pParent->pFirstChild; *ppLink != pNode; 
+         ppLink = &(*ppLink)->pNextSibling)
+    {
+        ;
+    }
+    *ppLink = pNode->pNextSibling;
+
+    pNode->pParent = NULL;
+    pNode->pNextSibling = NULL;
+    SET_BIT(pNode->dirty, SCENE_NODE_DIRTY_WORLD | SCENE_NODE_DIRTY_BOUNDS);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpSceneNodeSetTranslation(SCENE_NODE *pNode, 
+ *                                 float x, float y, float z)
+ * void SrpSceneNodeSetOrientation(SCENE_NODE *pNode, 
+ *                                 const QUATERNION orientation)
+ * void SrpSceneNodeSetScale(SCENE_NODE *pNode, float x, float y, float z)
+ *
+ * Set the local transformation of a node, relative to its parent.
+ */
+void SrpSceneNodeSetTranslation(SCENE_NODE *pNode, float x, float y, float z)
+{
+    ASSERTMSG(pNode != NULL, "SrpSceneNodeSetTranslation: invalid arguments.");
+
+    SrpVectorLoad3f(pNode->translation, x, y, z);
+    SrpSceneNodeMarkDirty(pNode, SCENE_NODE_DIRTY_WORLD);
+}
+
+void SrpSceneNodeSetOrientation(SCENE_NODE *pNode, 
+                                const QUATERNION orientation)
+{
+    ASSERTMSG(pNode != NULL, "SrpSceneNodeSetOrientation: invalid arguments.");
+
+    SrpQuaternionCopy(pNode->orientation, orientation);
+    SrpSceneNodeMarkDirty(pNode, SCENE_NODE_DIRTY_WORLD);
+}
+
+void SrpSceneNodeSetScale(SCENE_NODE *pNode, float x, float y, float z)
+{
+    ASSERTMSG(pNode != NULL, "SrpSceneNodeSetScale: invalid arguments.");
+
+    SrpVectorLoad3f(pNode->scale, x, y, z);
+    SrpSceneNodeMarkDirty(pNode, SCENE_NODE_DIRTY_WORLD);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpSceneNodeInvalidate(SCENE_NODE *pNode)
+ *
+ * Tell the node its object has been moved, so its bounds are updated.
+ */
+void SrpSceneNodeInvalidate(SCENE_NODE *pNode)
+{
+    ASSERTMSG(pNode != NULL, "SrpSceneNodeInvalidate: invalid arguments.");
+
+    SrpSceneNodeMarkDirty(pNode, SCENE_NODE_DIRTY_BOUNDS);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpSceneNodeGetBounds(const SCENE_NODE *pNode, VECTOR3F center, 
+ *                            float *pRadius)
+ *
+ * Get the bounding sphere of a node and its subtree in world space, as
+ * of the last update. radius is negative if there is nothing to bound.
+ */
+void SrpSceneNodeGetBounds(const SCENE_NODE *pNode, VECTOR3F center, 
+                           float *pRadius)
+{
+    ASSERTMSG(pNode != NULL && pRadius != NULL, 
+              "SrpSceneNodeGetBounds: invalid arguments.");
+
+    SrpVectorCopy3f(center, pNode->center);
+    *pRadius = pNode->radius;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpSceneUpdate(SCENE_NODE *pRoot)
+ *
+ * Update world matrices and bounds of the nodes changed since last time.
+ * Clean subtrees are not visited at all.
+ */
+void SrpSceneUpdate(SCENE_NODE *pRoot)
+{
+    MATRIX43F identity;
+
+    ASSERTMSG(pRoot != NULL && pRoot->pParent == NULL, 
+              "SrpSceneUpdate: invalid arguments.");
+
+    SrpMatrixLoadIdentity43f(identity);
+    SrpSceneNodeUpdate(pRoot, identity, FALSE);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpSceneDraw(SCENE_NODE *pRoot, RENDER_LIST *pRl)
+ *
+ * Update the scene, then draw every object of it into render list, 
+ * with current modelview matrix as the world to camera transformation.
+ */
+void SrpSceneDraw(SCENE_NODE *pRoot, RENDER_LIST *pRl)
+{
+    ASSERTMSG(pRoot != NULL && pRl != NULL, 
+              "SrpSceneDraw: invalid arguments.");
+
+    SrpSceneUpdate(pRoot);
+    SrpSceneNodeDraw(pRoot, pRl, 
+                     SrpRCIsEnabled(SRP_CULL_OBJECT) ? 
+                     SrpRCGetWorldFrustum() : NULL, 
+                     FRUSTUM_PLANES_ALL);
+    SrpRCSetCullPlaneMask(FRUSTUM_PLANES_ALL);
+}
@@ -0,0 +1,148 @@
+/*******************************************************************************
+ * File   : simd_srp.c
+ * Content: SIMD level detection
+ *
+ * Coder  : Ean Jee
+ * Time   : 2026-10-19 10:20
+ ******************************************************************************/
+
+#include <stdio.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include "datadef_ig.h"
+#include "assert_ig.h"
+#include "thread_ig.h"
+#include "simd_srp.h"
+
+/*----------------------------------------------------------------------------*/
+/*                               Data Structure                               */
+/*----------------------------------------------------------------------------*/
+
+/* Not detected yet */
+#define SIMD_LEVEL_UNKNOWN        -1
+
+/*----------------------------------------------------------------------------*/
+/*                                Private Data                                */
+/*----------------------------------------------------------------------------*/
+
+/* Shared by the threads rendering with their own RCs */
+static volatile int sg_detected = SIMD_LEVEL_UNKNOWN;
+static volatile int sg_level = SIMD_LEVEL_UNKNOWN;
+
+/*----------------------------------------------------------------------------*/
+/*                       Private Function Declarations                        */
+/*----------------------------------------------------------------------------*/
+
+static int SrpSimdDetect(void);
+
+/*----------------------------------------------------------------------------*/
+/*                             Private Functions                              */
+/*----------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------
+ * int SrpSimdDetect(void)
+ *
+ * Ask the CPU which instruction sets it has, AVX ones also need the OS 
+ * to save the wider registers.
+ */
+static int SrpSimdDetect(void)
+{
+#if defined(SRP_SIMD_X86) && defined(__GNUC__)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return SRP_SIMD_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        return SRP_SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return SRP_SIMD_SSE2;
+    }
+
+    return SRP_SIMD_NONE;
+#elif defined(SRP_SIMD_X86) && defined(_MSC_VER)
+    int info[4], maxLeaf, level;
+    unsigned long long xcr0;
+
+    __cpuid(info, 0);
+    maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    if (!(info[3] & (1 << 26)))
+    {
+        return SRP_SIMD_NONE;
+    }
+    level = SRP_SIMD_SSE2;
+
+    /* FMA and OSXSAVE, then YMM state enabled by the OS */
+    if (maxLeaf < 7 || !(info[2] & (1 << 12)) || !(info[2] & (1 << 27)))
+    {
+        return level;
+    }
+    xcr0 = _xgetbv(0);
+    if ((xcr0 & 0x06) != 0x06)
+    {
+        return level;
+    }
+
+    __cpuidex(info, 7, 0);
+    if (info[1] & (1 << 5))
+    {
+        level = SRP_SIMD_AVX2;
+
+        /* AVX-512F, with opmask and ZMM state enabled too */
+        if ((info[1] & (1 << 16)) && (xcr0 & 0xE6) == 0xE6)
+        {
+            level = SRP_SIMD_AVX512;
+        }
+    }
+
+    return level;
+#else
+    return SRP_SIMD_NONE;
+#endif
+}
+
+/*----------------------------------------------------------------------------*/
+/*                              Public Functions                              */
+/*----------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------
+ * int SrpSimdGetLevel(void)
+ *
+ * Get the SIMD level used by the batch functions.
+ */
+int SrpSimdGetLevel(void)
+{
+    int level;
+
+    /* Threads getting here at once all detect the same level */
+    level = IgAtomicLoad(&sg_level);
+    if (level == SIMD_LEVEL_UNKNOWN)
+    {
+        level = SrpSimdDetect();
+        IgAtomicStore(&sg_detected, level);
+        IgAtomicStore(&sg_level, level);
+    }
+
+    return level;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpSimdSetLevel(int level)
+ *
+ * Limit the SIMD level used by the batch functions.
+ */
+void SrpSimdSetLevel(int level)
+{
+    ASSERTMSG(level >= SRP_SIMD_NONE && level <= SRP_SIMD_AVX512, 
+              "SrpSimdSetLevel: invalid arguments.");
+
+    SrpSimdGetLevel();
+    IgAtomicStore(&sg_level, level < sg_detected ? level : sg_detected);
+}
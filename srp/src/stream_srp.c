@@ -0,0 +1,780 @@
+/*******************************************************************************
+ * File   : stream_srp.c
+ * Content: Vector streams, arrays of 3D vectors stored as x, y and z planes
+ *
+ * Coder  : Ean Jee
+ * Time   : 2026-10-19 14:20
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <memory.h>
+#include <math.h>
+#include "datadef_ig.h"
+#include "assert_ig.h"
+#include "malloc_ig.h"
+#include "math_srp.h"
+#include "stream_srp.h"
+#include "simd_srp.h"
+
+/*----------------------------------------------------------------------------*/
+/*                               Data Structure                               */
+/*----------------------------------------------------------------------------*/
+
+/* Planes are aligned to, and padded to a multiple of, this many bytes */
+#define STREAM_ALIGN              64
+#define STREAM_ALIGN_FLOATS       (STREAM_ALIGN / sizeof(float))
+
+/*----------------------------------------------------------------------------*/
+/*                                Private Data                                */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                       Private Function Declarations                        */
+/*----------------------------------------------------------------------------*/
+
+#if defined(SRP_SIMD_X86)
+static int SrpStreamDotSse2(float *out, const VEC3_STREAM *u, 
+                            const VEC3_STREAM *v);
+static int SrpStreamDotAvx2(float *out, const VEC3_STREAM *u, 
+                            const VEC3_STREAM *v);
+static int SrpStreamCrossSse2(VEC3_STREAM *out, const VEC3_STREAM *u, 
+                              const VEC3_STREAM *v);
+static int SrpStreamCrossAvx2(VEC3_STREAM *out, const VEC3_STREAM *u, 
+                              const VEC3_STREAM *v);
+static int SrpStreamNormalizeSse2(VEC3_STREAM *out, const VEC3_STREAM *v);
+static int SrpStreamNormalizeAvx2(VEC3_STREAM *out, const VEC3_STREAM *v);
+static int SrpStreamTransformSse2(VEC3_STREAM *out, const VEC3_STREAM *v, 
+                                  const MATRIX43F m);
+static int SrpStreamTransformAvx2(VEC3_STREAM *out, const VEC3_STREAM *v, 
+                                  const MATRIX43F m);
+static int SrpStreamPlaneDistanceSse2(float *pDist, const PLANE plane, 
+                                      const VEC3_STREAM *v);
+static int SrpStreamPlaneDistanceAvx2(float *pDist, const PLANE plane, 
+                                      const VEC3_STREAM *v);
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*                             Private Functions                              */
+/*----------------------------------------------------------------------------*/
+
+#if defined(SRP_SIMD_X86)
+/*------------------------------------------------------------------------------
+ * The kernels below do 4 or 8 vectors per iteration, loading each plane 
+ * as it is. They return how many vectors are done, the rest is left to 
+ * the caller. AVX-512 adds little over AVX2 here, so that level uses 
+ * the AVX2 ones. Their arithmetic is in the same order as the array 
+ * versions in matrix_srp.c, vector_srp.c and plane_srp.c, so streams 
+ * and arrays give the same results, but for the last few vectors one 
+ * side may leave to the scalar code.
+ */
+
+/*------------------------------------------------------------------------------
+ * int SrpStreamDotSse2(float *out, const VEC3_STREAM *u, 
+ *                      const VEC3_STREAM *v)
+ * int SrpStreamDotAvx2(float *out, const VEC3_STREAM *u, 
+ *                      const VEC3_STREAM *v)
+ */
+SRP_TARGET_SSE2
+static int SrpStreamDotSse2(float *out, const VEC3_STREAM *u, 
+                            const VEC3_STREAM *v)
+{
+    int i;
+
+    for (i = 0; i + 4 <= u->count; i += 4)
+    {
+        _mm_storeu_ps(out + i, 
+            _mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(_mm_loadu_ps(u->x + i), _mm_loadu_ps(v->x + i)), 
+                _mm_mul_ps(_mm_loadu_ps(u->y + i), _mm_loadu_ps(v->y + i))), 
+                _mm_mul_ps(_mm_loadu_ps(u->z + i), _mm_loadu_ps(v->z + i))));
+    }
+
+    return i;
+}
+
+SRP_TARGET_AVX2
+static int SrpStreamDotAvx2(float *out, const VEC3_STREAM *u, 
+                            const VEC3_STREAM *v)
+{
+    int i;
+
+    for (i = 0; i + 8 <= u->count; i += 8)
+    {
+        _mm256_storeu_ps(out + i, 
+            _mm256_add_ps(_mm256_add_ps(
+                _mm256_mul_ps(_mm256_loadu_ps(u->x + i), 
+                              _mm256_loadu_ps(v->x + i)), 
+                _mm256_mul_ps(_mm256_loadu_ps(u->y + i), 
+                              _mm256_loadu_ps(v->y + i))), 
+                _mm256_mul_ps(_mm256_loadu_ps(u->z + i), 
+                              _mm256_loadu_ps(v->z + i))));
+    }
+
+    return i;
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpStreamCrossSse2(VEC3_STREAM *out, const VEC3_STREAM *u, 
+ *                        const VEC3_STREAM *v)
+ * int SrpStreamCrossAvx2(VEC3_STREAM *out, const VEC3_STREAM *u, 
+ *                        const VEC3_STREAM *v)
+ */
+SRP_TARGET_SSE2
+static int SrpStreamCrossSse2(VEC3_STREAM *out, const VEC3_STREAM *u, 
+                              const VEC3_STREAM *v)
+{
+    int i;
+    __m128 ux, uy, uz, vx, vy, vz;
+
+    for (i = 0; i + 4 <= u->count; i += 4)
+    {
+        ux = _mm_loadu_ps(u->x + i);
+        uy = _mm_loadu_ps(u->y + i);
+        uz = _mm_loadu_ps(u->z + i);
+        vx = _mm_loadu_ps(v->x + i);
+        vy = _mm_loadu_ps(v->y + i);
+        vz = _mm_loadu_ps(v->z + i);
+
+        _mm_storeu_ps(out->x + i, _mm_sub_ps(_mm_mul_ps(uy, vz), 
+                                             _mm_mul_ps(uz, vy)));
+        _mm_storeu_ps(out->y + i, _mm_sub_ps(_mm_mul_ps(uz, vx), 
+                                             _mm_mul_ps(ux, vz)));
+        _mm_storeu_ps(out->z + i, _mm_sub_ps(_mm_mul_ps(ux, vy), 
+                                             _mm_mul_ps(uy, vx)));
+    }
+
+    return i;
+}
+
+SRP_TARGET_AVX2
+static int SrpStreamCrossAvx2(VEC3_STREAM *out, const VEC3_STREAM *u, 
+                              const VEC3_STREAM *v)
+{
+    int i;
+    __m256 ux, uy, uz, vx, vy, vz;
+
+    for (i = 0; i + 8 <= u->count; i += 8)
+    {
+        ux = _mm256_loadu_ps(u->x + i);
+        uy = _mm256_loadu_ps(u->y + i);
+        uz = _mm256_loadu_ps(u->z + i);
+        vx = _mm256_loadu_ps(v->x + i);
+        vy = _mm256_loadu_ps(v->y + i);
+        vz = _mm256_loadu_ps(v->z + i);
+
+        _mm256_storeu_ps(out->x + i, _mm256_sub_ps(_mm256_mul_ps(uy, vz), 
+                                                   _mm256_mul_ps(uz, vy)));
+        _mm256_storeu_ps(out->y + i, _mm256_sub_ps(_mm256_mul_ps(uz, vx), 
+                                                   _mm256_mul_ps(ux, vz)));
+        _mm256_storeu_ps(out->z + i, _mm256_sub_ps(_mm256_mul_ps(ux, vy), 
+                                                   _mm256_mul_ps(uy, vx)));
+    }
+
+    return i;
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpStreamNormalizeSse2(VEC3_STREAM *out, const VEC3_STREAM *v)
+ * int SrpStreamNormalizeAvx2(VEC3_STREAM *out, const VEC3_STREAM *v)
+ */
+SRP_TARGET_SSE2
+static int SrpStreamNormalizeSse2(VEC3_STREAM *out, const VEC3_STREAM *v)
+{
+    int i;
+    __m128 x, y, z, lengthSq, scale, keep;
+
+    for (i = 0; i + 4 <= v->count; i += 4)
+    {
+        x = _mm_loadu_ps(v->x + i);
+        y = _mm_loadu_ps(v->y + i);
+        z = _mm_loadu_ps(v->z + i);
+
+        lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), 
+                                         _mm_mul_ps(y, y)), 
+                              _mm_mul_ps(z, z));
+#if defined(SRP_FAST_MATH)
+        scale = _mm_rsqrt_ps(lengthSq);
+        scale = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), scale), 
+                           _mm_sub_ps(_mm_set1_ps(3.0f), 
+                                      _mm_mul_ps(_mm_mul_ps(lengthSq, 
+                                                            scale), 
+                                                 scale)));
+#else
+        scale = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSq));
+#endif
+
+        /* Zero vectors are left as they are */
+        keep = _mm_cmplt_ps(lengthSq, 
+                            _mm_set1_ps(EPSILON_E6F * EPSILON_E6F));
+        scale = _mm_or_ps(_mm_and_ps(keep, _mm_set1_ps(1.0f)), 
+                          _mm_andnot_ps(keep, scale));
+
+        _mm_storeu_ps(out->x + i, _mm_mul_ps(x, scale));
+        _mm_storeu_ps(out->y + i, _mm_mul_ps(y, scale));
+        _mm_storeu_ps(out->z + i, _mm_mul_ps(z, scale));
+    }
+
+    return i;
+}
+
+SRP_TARGET_AVX2
+static int SrpStreamNormalizeAvx2(VEC3_STREAM *out, const VEC3_STREAM *v)
+{
+    int i;
+    __m256 x, y, z, lengthSq, scale, keep;
+
+    for (i = 0; i + 8 <= v->count; i += 8)
+    {
+        x = _mm256_loadu_ps(v->x + i);
+        y = _mm256_loadu_ps(v->y + i);
+        z = _mm256_loadu_ps(v->z + i);
+
+        lengthSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), 
+                                               _mm256_mul_ps(y, y)), 
+                                 _mm256_mul_ps(z, z));
+#if defined(SRP_FAST_MATH)
+        scale = _mm256_rsqrt_ps(lengthSq);
+        scale = _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), scale), 
+                              _mm256_fnmadd_ps(_mm256_mul_ps(lengthSq, 
+                                                             scale), 
+                                               scale, 
+                                               _mm256_set1_ps(3.0f)));
+#else
+        scale = _mm256_div_ps(_mm256_set1_ps(1.0f), 
+                              _mm256_sqrt_ps(lengthSq));
+#endif
+
+        /* Zero vectors are left as they are */
+        keep = _mm256_cmp_ps(lengthSq, 
+                             _mm256_set1_ps(EPSILON_E6F * EPSILON_E6F), 
+                             _CMP_LT_OQ);
+        scale = _mm256_blendv_ps(scale, _mm256_set1_ps(1.0f), keep);
+
+        _mm256_storeu_ps(out->x + i, _mm256_mul_ps(x, scale));
+        _mm256_storeu_ps(out->y + i, _mm256_mul_ps(y, scale));
+        _mm256_storeu_ps(out->z + i, _mm256_mul_ps(z, scale));
+    }
+
+    return i;
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpStreamTransformSse2(VEC3_STREAM *out, const VEC3_STREAM *v, 
+ *                            const MATRIX43F m)
+ * int SrpStreamTransformAvx2(VEC3_STREAM *out, const VEC3_STREAM *v, 
+ *                            const MATRIX43F m)
+ */
+SRP_TARGET_SSE2
+static int SrpStreamTransformSse2(VEC3_STREAM *out, const VEC3_STREAM *v, 
+                                  const MATRIX43F m)
+{
+    int i, j;
+    __m128 r[12], x, y, z;
+
+    for (j = 0; j < 12; j++)
+    {
+        r[j] = _mm_set1_ps(m[j]);
+    }
+
+    for (i = 0; i + 4 <= v->count; i += 4)
+    {
+        x = _mm_loadu_ps(v->x + i);
+        y = _mm_loadu_ps(v->y + i);
+        z = _mm_loadu_ps(v->z + i);
+
+        _mm_storeu_ps(out->x + i, 
+                      _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, r[0]), 
+                                                       _mm_mul_ps(y, r[3])), 
+                                            _mm_mul_ps(z, r[6])), r[9]));
+        _mm_storeu_ps(out->y + i, 
+                      _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, r[1]), 
+                                                       _mm_mul_ps(y, r[4])), 
+                                            _mm_mul_ps(z, r[7])), r[10]));
+        _mm_storeu_ps(out->z + i, 
+                      _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, r[2]), 
+                                                       _mm_mul_ps(y, r[5])), 
+                                            _mm_mul_ps(z, r[8])), r[11]));
+    }
+
+    return i;
+}
+
+SRP_TARGET_AVX2
+static int SrpStreamTransformAvx2(VEC3_STREAM *out, const VEC3_STREAM *v, 
+                                  const MATRIX43F m)
+{
+    int i, j;
+    __m256 r[12], x, y, z;
+
+    for (j = 0; j < 12; j++)
+    {
+        r[j] = _mm256_set1_ps(m[j]);
+    }
+
+    for (i = 0; i + 8 <= v->count; i += 8)
+    {
+        x = _mm256_loadu_ps(v->x + i);
+        y = _mm256_loadu_ps(v->y + i);
+        z = _mm256_loadu_ps(v->z + i);
+
+        _mm256_storeu_ps(out->x + i, 
+                         _mm256_add_ps(_mm256_fmadd_ps(z, r[6], 
+                             _mm256_fmadd_ps(y, r[3], 
+                                             _mm256_mul_ps(x, r[0]))), r[9]));
+        _mm256_storeu_ps(out->y + i, 
+                         _mm256_add_ps(_mm256_fmadd_ps(z, r[7], 
+                             _mm256_fmadd_ps(y, r[4], 
+                                             _mm256_mul_ps(x, r[1]))), r[10]));
+        _mm256_storeu_ps(out->z + i, 
+                         _mm256_add_ps(_mm256_fmadd_ps(z, r[8], 
+                             _mm256_fmadd_ps(y, r[5], 
+                                             _mm256_mul_ps(x, r[2]))), r[11]));
+    }
+
+    return i;
+}
+
+/*------------------------------------------------------------------------------
+ * int SrpStreamPlaneDistanceSse2(float *pDist, const PLANE plane, 
+ *                                const VEC3_STREAM *v)
+ * int SrpStreamPlaneDistanceAvx2(float *pDist, const PLANE plane, 
+ *                                const VEC3_STREAM *v)
+ */
+SRP_TARGET_SSE2
+static int SrpStreamPlaneDistanceSse2(float *pDist, const PLANE plane, 
+                                      const VEC3_STREAM *v)
+{
+    int i;
+    __m128 a, b, c, d;
+
+    a = _mm_set1_ps(plane[0]);
+    b = _mm_set1_ps(plane[1]);
+    c = _mm_set1_ps(plane[2]);
+    d = _mm_set1_ps(plane[3]);
+
+    for (i = 0; i + 4 <= v->count; i += 4)
+    {
+        _mm_storeu_ps(pDist + i, 
+            _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(a, _mm_loadu_ps(v->x + i)), 
+                _mm_mul_ps(b, _mm_loadu_ps(v->y + i))), 
+                _mm_mul_ps(c, _mm_loadu_ps(v->z + i))), d));
+    }
+
+    return i;
+}
+
+SRP_TARGET_AVX2
+static int SrpStreamPlaneDistanceAvx2(float *pDist, const PLANE plane, 
+                                      const VEC3_STREAM *v)
+{
+    int i;
+    __m256 a, b, c, d;
+
+    a = _mm256_set1_ps(plane[0]);
+    b = _mm256_set1_ps(plane[1]);
+    c = _mm256_set1_ps(plane[2]);
+    d = _mm256_set1_ps(plane[3]);
+
+    for (i = 0; i + 8 <= v->count; i += 8)
+    {
+        _mm256_storeu_ps(pDist + i, 
+            _mm256_add_ps(_mm256_fmadd_ps(c, _mm256_loadu_ps(v->z + i), 
+                _mm256_fmadd_ps(b, _mm256_loadu_ps(v->y + i), 
+                    _mm256_mul_ps(a, _mm256_loadu_ps(v->x + i)))), d));
+    }
+
+    return i;
+}
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*                              Public Functions                              */
+/*----------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------
+ * int SrpCreateVec3Stream(VEC3_STREAM **ppStream, int count)
+ *
+ * Create a stream of count vectors. The planes share one block, each 
+ * aligned and padded to STREAM_ALIGN bytes.
+ */
+int SrpCreateVec3Stream(VEC3_STREAM **ppStream, int count)
+{
+    VEC3_STREAM *pStream;
+    size_t planeSize;
+    float *pPlanes;
+
+    ASSERTMSG(ppStream != NULL && count >= 0, 
+              "SrpCreateVec3Stream: invalid arguments.");
+
+    if (!IgNewMemory((void **)ppStream, sizeof(VEC3_STREAM)))
+    {
+        printf("Error: create vector stream failed.\n");
+        return FALSE;
+    }
+    pStream = *ppStream;
+
+    planeSize = (count + STREAM_ALIGN_FLOATS - 1) / STREAM_ALIGN_FLOATS * 
+                STREAM_ALIGN_FLOATS;
+    if (!IgNewMemory(&pStream->pBlock, 
+                     (planeSize * 3 + STREAM_ALIGN_FLOATS) * sizeof(float)))
+    {
+        IgFreeMemory(pStream);
+        printf("Error: create vector stream failed.\n");
+        return FALSE;
+    }
+
+    pPlanes = (float *)(((size_t)pStream->pBlock + STREAM_ALIGN - 1) & 
+                        ~(size_t)(STREAM_ALIGN - 1));
+    pStream->x = pPlanes;
+    pStream->y = pPlanes + planeSize;
+    pStream->z = pPlanes + planeSize * 2;
+    pStream->count = count;
+
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpDeleteVec3Stream(VEC3_STREAM *pStream)
+ *
+ * Delete a stream created by SrpCreateVec3Stream.
+ */
+void SrpDeleteVec3Stream(VEC3_STREAM *pStream)
+{
+    ASSERTMSG(pStream != NULL && pStream->pBlock != NULL, 
+              "SrpDeleteVec3Stream: invalid arguments.");
+
+    IgFreeMemory(pStream->pBlock);
+    IgFreeMemory(pStream);
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpVec3StreamView(VEC3_STREAM *pView, const VEC3_STREAM *pStream, 
+ *                        int first, int count)
+ *
+ * Make pView a view of count vectors of pStream from vector first on, 
+ * e.g. to work on a meshlet's vertices only. The view is only valid 
+ * as long as pStream is.
+ */
+void SrpVec3StreamView(VEC3_STREAM *pView, const VEC3_STREAM *pStream, 
+                       int first, int count)
+{
+    ASSERTMSG(pView != NULL && pStream != NULL && first >= 0 && 
+              count >= 0 && first + count <= pStream->count, 
+              "SrpVec3StreamView: invalid arguments.");
+
+    pView->x = pStream->x + first;
+    pView->y = pStream->y + first;
+    pView->z = pStream->z + first;
+    pView->count = count;
+    pView->pBlock = NULL;
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpVec3StreamLoad(VEC3_STREAM *pStream, const VECTOR3F *v)
+ * void SrpVec3StreamStore(VECTOR3F *v, const VEC3_STREAM *pStream)
+ *
+ * Load a stream from an array of vectors, or store it into one.
+ */
+void SrpVec3StreamLoad(VEC3_STREAM *pStream, const VECTOR3F *v)
+{
+    int i;
+
+    ASSERTMSG(pStream != NULL && v != NULL, 
+              "SrpVec3StreamLoad: invalid arguments.");
+
+    for (i = 0; i < pStream->count; i++)
+    {
+        pStream->x[i] = v[i][0];
+        pStream->y[i] = v[i][1];
+        pStream->z[i] = v[i][2];
+    }
+}
+
+void SrpVec3StreamStore(VECTOR3F *v, const VEC3_STREAM *pStream)
+{
+    int i;
+
+    ASSERTMSG(pStream != NULL && v != NULL, 
+              "SrpVec3StreamStore: invalid arguments.");
+
+    for (i = 0; i < pStream->count; i++)
+    {
+        v[i][0] = pStream->x[i];
+        v[i][1] = pStream->y[i];
+        v[i][2] = pStream->z[i];
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpVec3StreamAdd(VEC3_STREAM *out, const VEC3_STREAM *u, 
+ *                       const VEC3_STREAM *v)
+ * void SrpVec3StreamSubtract(VEC3_STREAM *out, const VEC3_STREAM *u, 
+ *                            const VEC3_STREAM *v)
+ * void SrpVec3StreamScale(VEC3_STREAM *out, const VEC3_STREAM *v, 
+ *                         float scale)
+ *
+ * out = u + v, out = u - v and out = v * scale. Plain loops over the 
+ * planes, which compilers turn into SIMD on their own.
+ */
+void SrpVec3StreamAdd(VEC3_STREAM *out, const VEC3_STREAM *u, 
+                      const VEC3_STREAM *v)
+{
+    int i;
+
+    ASSERTMSG(out != NULL && u != NULL && v != NULL && 
+              out->count == u->count && u->count == v->count, 
+              "SrpVec3StreamAdd: invalid arguments.");
+
+    for (i = 0; i < u->count; i++)
+    {
+        out->x[i] = u->x[i] + v->x[i];
+        out->y[i] = u->y[i] + v->y[i];
+        out->z[i] = u->z[i] + v->z[i];
+    }
+}
+
+void SrpVec3StreamSubtract(VEC3_STREAM *out, const VEC3_STREAM *u, 
+                           const VEC3_STREAM *v)
+{
+    int i;
+
+    ASSERTMSG(out != NULL && u != NULL && v != NULL && 
+              out->count == u->count && u->count == v->count, 
+              "SrpVec3StreamSubtract: invalid arguments.");
+
+    for (i = 0; i < u->count; i++)
+    {
+        out->x[i] = u->x[i] - v->x[i];
+        out->y[i] = u->y[i] - v->y[i];
+        out->z[i] = u->z[i] - v->z[i];
+    }
+}
+
+void SrpVec3StreamScale(VEC3_STREAM *out, const VEC3_STREAM *v, float scale)
+{
+    int i;
+
+    ASSERTMSG(out != NULL && v != NULL && out->count == v->count, 
+              "SrpVec3StreamScale: invalid arguments.");
+
+    for (i = 0; i < v->count; i++)
+    {
+        out->x[i] = v->x[i] * scale;
+        out->y[i] = v->y[i] * scale;
+        out->z[i] = v->z[i] * scale;
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpVec3StreamDotProduct(float *out, const VEC3_STREAM *u, 
+ *                              const VEC3_STREAM *v)
+ *
+ * out[i] = u[i] . v[i]
+ *
+ * Runs with the widest SIMD level SrpSimdGetLevel() gives.
+ */
+void SrpVec3StreamDotProduct(float *out, const VEC3_STREAM *u, 
+                             const VEC3_STREAM *v)
+{
+    int i;
+
+    ASSERTMSG(out != NULL && u != NULL && v != NULL && 
+              u->count == v->count, 
+              "SrpVec3StreamDotProduct: invalid arguments.");
+
+    i = 0;
+#if defined(SRP_SIMD_X86)
+    switch (SrpSimdGetLevel())
+    {
+    case SRP_SIMD_AVX512:
+    case SRP_SIMD_AVX2:
+        i = SrpStreamDotAvx2(out, u, v);
+        break;
+    case SRP_SIMD_SSE2:
+        i = SrpStreamDotSse2(out, u, v);
+        break;
+    default:
+        break;
+    }
+#endif
+
+    for (; i < u->count; i++)
+    {
+        out[i] = u->x[i] * v->x[i] + u->y[i] * v->y[i] + u->z[i] * v->z[i];
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpVec3StreamCrossProduct(VEC3_STREAM *out, const VEC3_STREAM *u, 
+ *                                const VEC3_STREAM *v)
+ *
+ * out[i] = u[i] X v[i]
+ *
+ * Runs with the widest SIMD level SrpSimdGetLevel() gives.
+ */
+void SrpVec3StreamCrossProduct(VEC3_STREAM *out, const VEC3_STREAM *u, 
+                               const VEC3_STREAM *v)
+{
+    int i;
+    float x, y, z;
+
+    ASSERTMSG(out != NULL && u != NULL && v != NULL && 
+              out->count == u->count && u->count == v->count, 
+              "SrpVec3StreamCrossProduct: invalid arguments.");
+
+    i = 0;
+#if defined(SRP_SIMD_X86)
+    switch (SrpSimdGetLevel())
+    {
+    case SRP_SIMD_AVX512:
+    case SRP_SIMD_AVX2:
+        i = SrpStreamCrossAvx2(out, u, v);
+        break;
+    case SRP_SIMD_SSE2:
+        i = SrpStreamCrossSse2(out, u, v);
+        break;
+    default:
+        break;
+    }
+#endif
+
+    for (; i < u->count; i++)
+    {
+        x = u->y[i] * v->z[i] - u->z[i] * v->y[i];
+        y = u->z[i] * v->x[i] - u->x[i] * v->z[i];
+        z = u->x[i] * v->y[i] - u->y[i] * v->x[i];
+        out->x[i] = x;
+        out->y[i] = y;
+        out->z[i] = z;
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpVec3StreamNormalize(VEC3_STREAM *out, const VEC3_STREAM *v)
+ *
+ * Normalize every vector as SrpVectorNormalizeArray3f does, zero 
+ * vectors are copied silently.
+ *
+ * Runs with the widest SIMD level SrpSimdGetLevel() gives.
+ */
+void SrpVec3StreamNormalize(VEC3_STREAM *out, const VEC3_STREAM *v)
+{
+    int i;
+    float lengthSq, scale;
+
+    ASSERTMSG(out != NULL && v != NULL && out->count == v->count, 
+              "SrpVec3StreamNormalize: invalid arguments.");
+
+    i = 0;
+#if defined(SRP_SIMD_X86)
+    switch (SrpSimdGetLevel())
+    {
+    case SRP_SIMD_AVX512:
+    case SRP_SIMD_AVX2:
+        i = SrpStreamNormalizeAvx2(out, v);
+        break;
+    case SRP_SIMD_SSE2:
+        i = SrpStreamNormalizeSse2(out, v);
+        break;
+    default:
+        break;
+    }
+#endif
+
+    for (; i < v->count; i++)
+    {
+        lengthSq = v->x[i] * v->x[i] + v->y[i] * v->y[i] + 
+                   v->z[i] * v->z[i];
+        scale = lengthSq < EPSILON_E6F * EPSILON_E6F ? 
+                1.0f : SrpMathRsqrtf(lengthSq);
+        out->x[i] = v->x[i] * scale;
+        out->y[i] = v->y[i] * scale;
+        out->z[i] = v->z[i] * scale;
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpVec3StreamTransform(VEC3_STREAM *out, const VEC3_STREAM *v, 
+ *                             const MATRIX43F m)
+ *
+ * Transform every vector with 4X3 matrix m, out[i] = v[i] * m.
+ *
+ * Runs with the widest SIMD level SrpSimdGetLevel() gives.
+ */
+void SrpVec3StreamTransform(VEC3_STREAM *out, const VEC3_STREAM *v, 
+                            const MATRIX43F m)
+{
+    int i;
+    float x, y, z;
+
+    ASSERTMSG(out != NULL && v != NULL && m != NULL && 
+              out->count == v->count, 
+              "SrpVec3StreamTransform: invalid arguments.");
+
+    i = 0;
+#if defined(SRP_SIMD_X86)
+    switch (SrpSimdGetLevel())
+    {
+    case SRP_SIMD_AVX512:
+    case SRP_SIMD_AVX2:
+        i = SrpStreamTransformAvx2(out, v, m);
+        break;
+    case SRP_SIMD_SSE2:
+        i = SrpStreamTransformSse2(out, v, m);
+        break;
+    default:
+        break;
+    }
+#endif
+
+    for (; i < v->count; i++)
+    {
+        x = v->x[i];
+        y = v->y[i];
+        z = v->z[i];
+        out->x[i] = x * m[0] + y * m[3] + z * m[6] + m[9];
+        out->y[i] = x * m[1] + y * m[4] + z * m[7] + m[10];
+        out->z[i] = x * m[2] + y * m[5] + z * m[8] + m[11];
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpVec3StreamPlaneDistance(float *pDist, const PLANE plane, 
+ *                                 const VEC3_STREAM *v)
+ *
+ * Get the distance from every vector to a plane, see 
+ * SrpPlaneGetDistance.
+ *
+ * Runs with the widest SIMD level SrpSimdGetLevel() gives.
+ */
+void SrpVec3StreamPlaneDistance(float *pDist, const PLANE plane, 
+                                const VEC3_STREAM *v)
+{
+    int i;
+
+    ASSERTMSG(pDist != NULL && plane != NULL && v != NULL, 
+              "SrpVec3StreamPlaneDistance: invalid arguments.");
+
+    i = 0;
+#if defined(SRP_SIMD_X86)
+    switch (SrpSimdGetLevel())
+    {
+    case SRP_SIMD_AVX512:
+    case SRP_SIMD_AVX2:
+        i = SrpStreamPlaneDistanceAvx2(pDist, plane, v);
+        break;
+    case SRP_SIMD_SSE2:
+        i = SrpStreamPlaneDistanceSse2(pDist, plane, v);
+        break;
+    default:
+        break;
+    }
+#endif
+
+    for (; i < v->count; i++)
+    {
+        pDist[i] = plane[0] * v->x[i] + plane[1] * v->y[i] + 
+                   plane[2] * v->z[i] + plane[3];
+    }
+}
@@ -260,6 +260,9 @@ and up vector are parallel to each other.");
  * |   0      0   0  0 |
  *
  * Combine the current projection matrix in RC with that matrix.
+ * A 4X3 matrix can't divide by z, so the RC also builds the real 
+ * projection into clip space from the same parameters, see 
+ * SrpRCGetProjection.
  */
 void SrpTransformerSetProjection(float fovy, float aspect,
                                  float near, float far)
@@ -271,7 +274,7 @@ void SrpTransformerSetProjection(float fovy, float aspect,
               aspect > 0.0f && near < -1.0f && far < near,
               "SrpTransformerSetProjection: invalid arguments.");
 
-    oneOverTanTheta = 1.0f / tanf(SrpMathDegToRadf(fovy / 2.0f));
+    oneOverTanTheta = 1.0f / SrpMathTanf(SrpMathDegToRadf(fovy / 2.0f));
 
     proj[0] = oneOverTanTheta;
     proj[1] = 0.0f;
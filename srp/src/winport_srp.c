@@ -11,6 +11,7 @@
 #include "datadef_ig.h"
 #include "assert_ig.h"
 #include "malloc_ig.h"
+#include "datadef_srp.h"
 #include "winport_srp.h"
 #include "rcmanager_srp.h"
 
@@ -22,8 +23,14 @@
 /*                                Private Data                                */
 /*----------------------------------------------------------------------------*/
 
-static HBITMAP sg_hBitmap;
-static HDC sg_hdcReal, sg_hdcMem;
+/* The front buffer as a top-down DIB, with masks or colors after it */
+static struct
+{
+    BITMAPINFOHEADER bmiHeader;
+    RGBQUAD bmiColors[256];
+} sg_bmi;
+
+static HDC sg_hdcReal;
 static LARGE_INTEGER sg_lastTime;
 static LARGE_INTEGER sg_ticksPerSecond;
 static int sg_hiResTimer;
@@ -37,27 +44,152 @@ static void (*sg_pDemoQuit)(void);
 /*                       Private Function Declarations                        */
 /*----------------------------------------------------------------------------*/
 
+static void SrpSetupBitmapInfo(void);
+static void SrpBlitRows(int x, int y, int width, int height);
 static void SrpFlipBuffers(void);
 
 /*----------------------------------------------------------------------------*/
 /*                             Private Functions                              */
 /*----------------------------------------------------------------------------*/
 
+/*------------------------------------------------------------------------------
+ * static void SrpSetupBitmapInfo(void)
+ *
+ * Describe the RC's front buffer to GDI, so it's drawn in place with no 
+ * copy. The palette is read again every time as it may have changed.
+ */
+static void SrpSetupBitmapInfo(void)
+{
+    DWORD *pMasks;
+    const unsigned char *pPalette;
+    int i;
+
+    sg_bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    sg_bmi.bmiHeader.biWidth = SrpRCGetPitch() * 8 / SrpRCGetBit();
+    sg_bmi.bmiHeader.biPlanes = 1;
+    sg_bmi.bmiHeader.biBitCount = (WORD)SrpRCGetBit();
+    sg_bmi.bmiHeader.biCompression = BI_RGB;
+    sg_bmi.bmiHeader.biSizeImage = 0;
+    sg_bmi.bmiHeader.biXPelsPerMeter = 0;
+    sg_bmi.bmiHeader.biYPelsPerMeter = 0;
+    sg_bmi.bmiHeader.biClrUsed = 0;
+    sg_bmi.bmiHeader.biClrImportant = 0;
+
+    pMasks = (DWORD *)sg_bmi.bmiColors;
+    switch (SrpRCGetFormat())
+    {
+    case SRP_FORMAT_RGBA8:
+        sg_bmi.bmiHeader.biCompression = BI_BITFIELDS;
+        pMasks[0] = 0x000000FF;
+        pMasks[1] = 0x0000FF00;
+        pMasks[2] = 0x00FF0000;
+        break;
+    case SRP_FORMAT_RGB565:
+        sg_bmi.bmiHeader.biCompression = BI_BITFIELDS;
+        pMasks[0] = 0xF800;
+        pMasks[1] = 0x07E0;
+        pMasks[2] = 0x001F;
+        break;
+    case SRP_FORMAT_INDEX8:
+        pPalette = SrpRCGetPalette();
+        for (i = 0; i < 256; i++)
+        {
+            sg_bmi.bmiColors[i].rgbRed      = pPalette[i * 3 + 0];
+            sg_bmi.bmiColors[i].rgbGreen    = pPalette[i * 3 + 1];
+            sg_bmi.bmiColors[i].rgbBlue     = pPalette[i * 3 + 2];
+            sg_bmi.bmiColors[i].rgbReserved = 0;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * static void SrpBlitRows(int x, int y, int width, int height)
+ *
+ * Draw a rectangle of the front buffer on the window. The rows are 
+ * passed as a DIB of their own, starting at row y, so the source origin 
+ * is always its top left whichever way GDI counts the rows.
+ */
+static void SrpBlitRows(int x, int y, int width, int height)
+{
+    sg_bmi.bmiHeader.biHeight = -height;
+
+    SetDIBitsToDevice(sg_hdcReal, x, y, width, height, x, 0, 0, height, 
+                      SrpRCGetFrontBuffer() + y * SrpRCGetPitch(), 
+                      (BITMAPINFO *)&sg_bmi, DIB_RGB_COLORS);
+}
+
+/*------------------------------------------------------------------------------
+ * static void SrpFlipBuffers(void)
+ *
+ * Show the frame just drawn. Only the runs of dirty tiles in each row 
+ * are drawn, or the whole frame in one go if every tile is dirty. The 
+ * fps text is left out of them and drawn over at last, so it doesn't 
+ * flicker.
+ */
 static void SrpFlipBuffers(void)
 {
-    int ret;
     char fpsString[32];
     int stringSize;
+    SIZE textSize;
+    const unsigned char *pDirty;
+    int tilesX, tilesY, width, height;
+    int x, y, xEnd, yMax, xMax, i;
 
-    ret = SetBitmapBits(sg_hBitmap, SrpRCGetSize(), SrpRCGetBuffer());
-    ASSERT(ret != 0);
+    SrpRCSwap();
+    SrpSetupBitmapInfo();
 
-    /* Show the fps */
     stringSize = sprintf(fpsString, "%8.2lfFPS", sg_fps);
-    TextOut(sg_hdcMem, 0, 0, fpsString, stringSize);
-    
-    BitBlt(sg_hdcReal, 0, 0, SrpRCGetWidth(), SrpRCGetHeight(), 
-           sg_hdcMem, 0, 0, SRCCOPY);
+    GetTextExtentPoint32(sg_hdcReal, fpsString, stringSize, &textSize);
+    ExcludeClipRect(sg_hdcReal, 0, 0, textSize.cx, textSize.cy);
+
+    width = SrpRCGetWidth();
+    height = SrpRCGetHeight();
+    pDirty = SrpRCGetDirtyTiles(&tilesX, &tilesY);
+    i = 0;
+    while (i < tilesX * tilesY && pDirty[i])
+    {
+        i++;
+    }
+
+    if (i == tilesX * tilesY)
+    {
+        SrpBlitRows(0, 0, width, height);
+    }
+    else
+    {
+        for (y = 0; y < tilesY; y++)
+        {
+            yMax = (y + 1) * SRP_DIRTY_TILE_SIZE;
+            yMax = yMax < height ? yMax : height;
+
+            for (x = 0; x < tilesX; x = xEnd)
+            {
+                xEnd = x + 1;
+                if (!pDirty[y * tilesX + x])
+                {
+                    continue;
+                }
+
+                while (xEnd < tilesX && pDirty[y * tilesX + xEnd])
+                {
+                    xEnd++;
+                }
+                xMax = xEnd * SRP_DIRTY_TILE_SIZE;
+                xMax = xMax < width ? xMax : width;
+
+                SrpBlitRows(x * SRP_DIRTY_TILE_SIZE, y * SRP_DIRTY_TILE_SIZE, 
+                            xMax - x * SRP_DIRTY_TILE_SIZE, 
+                            yMax - y * SRP_DIRTY_TILE_SIZE);
+            }
+        }
+    }
+
+    /* Show the fps */
+    SelectClipRgn(sg_hdcReal, NULL);
+    TextOut(sg_hdcReal, 0, 0, fpsString, stringSize);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -66,6 +198,13 @@ static void SrpFlipBuffers(void)
 
 extern void SrpDemoCallback(void);
 
+/*------------------------------------------------------------------------------
+ * int SrpInit(HWND hwnd, int width, int height, int bit)
+ *
+ * Create the rendering context for a window, and the timer and font the 
+ * fps is shown with, then get the demo's entries from SrpDemoCallback 
+ * and initialize it. Return FALSE if any of it fails.
+ */
 int SrpInit(HWND hwnd, int width, int height, int bit)
 {
     HFONT hFont;
@@ -82,25 +221,6 @@ int SrpInit(HWND hwnd, int width, int height, int bit)
         return FALSE;
     }
 
-    if ((sg_hdcMem = CreateCompatibleDC(sg_hdcReal)) == NULL)
-    {
-        printf("SrpInit failed.\n");
-        return FALSE;
-    }        
-
-    if ((sg_hBitmap = CreateCompatibleBitmap(sg_hdcReal, width, height)) 
-        == NULL)
-    {
-        printf("SrpInit failed.\n");
-        return FALSE;
-    }
-
-    if (SelectObject(sg_hdcMem, sg_hBitmap) == NULL)
-    {
-        printf("SrpInit failed.\n");
-        return FALSE;
-    }
-
     /* Get timer */
     if (!QueryPerformanceFrequency(&sg_ticksPerSecond))
     {
@@ -122,11 +242,11 @@ int SrpInit(HWND hwnd, int width, int height, int bit)
                        ANSI_CHARSET, OUT_TT_PRECIS, CLIP_DEFAULT_PRECIS, 
                        ANTIALIASED_QUALITY, FF_DONTCARE | DEFAULT_PITCH, 
                        "Lucida Console");
-    SelectObject(sg_hdcMem, hFont);
+    SelectObject(sg_hdcReal, hFont);
     DeleteObject(hFont);
-    SetTextColor(sg_hdcMem, RGB(255,255,255));
-    SetBkColor(sg_hdcMem, RGB(0,0,0));
-    SetBkMode(sg_hdcMem, OPAQUE);
+    SetTextColor(sg_hdcReal, RGB(255,255,255));
+    SetBkColor(sg_hdcReal, RGB(0,0,0));
+    SetBkMode(sg_hdcReal, OPAQUE);
 
     sg_pDemoInit = NULL;
     sg_pDemoMain = NULL;
@@ -146,6 +266,12 @@ with a call of SrpWinportSetDemoEntry().\n");
     return TRUE;
 }
 
+/*------------------------------------------------------------------------------
+ * void SrpMain(void)
+ *
+ * Run the demo for one frame, with the time since the last one, and 
+ * show what it drew.
+ */
 void SrpMain(void)
 {
     LARGE_INTEGER currentTime;
@@ -174,15 +300,43 @@ void SrpMain(void)
     SrpFlipBuffers();
 }
 
+/*------------------------------------------------------------------------------
+ * void SrpRepaint(void)
+ *
+ * Draw the whole front buffer on the window again, for WM_PAINT. Nothing 
+ * is rendered, and the dirty tiles are left as they are.
+ */
+void SrpRepaint(void)
+{
+    if (sg_hdcReal == NULL)
+    {
+        return;
+    }
+
+    SrpSetupBitmapInfo();
+    SrpBlitRows(0, 0, SrpRCGetWidth(), SrpRCGetHeight());
+}
+
+/*------------------------------------------------------------------------------
+ * void SrpQuit(HWND hwnd)
+ *
+ * Quit the demo, delete the rendering context and release the window's 
+ * device context.
+ */
 void SrpQuit(HWND hwnd)
 {
     (*sg_pDemoQuit)();
     SrpDeleteRC();
-    DeleteObject(sg_hBitmap);
-    DeleteDC(sg_hdcMem);
     ReleaseDC(hwnd, sg_hdcReal);
 }
 
+/*------------------------------------------------------------------------------
+ * void SrpWinportSetDemoEntry(void (*init)(void), void (*main)(float), 
+ *                             void (*quit)(void))
+ *
+ * Set the functions the demo is initialized, run every frame, and quit 
+ * with. Demos call it from SrpDemoCallback.
+ */
 void SrpWinportSetDemoEntry(void (*init)(void), void (*main)(float), 
                             void (*quit)(void))
 {
@@ -0,0 +1,55 @@
+/*******************************************************************************
+ * File   : thread_ig.h
+ * Content: Threads, semaphores and atomic operations
+ *
+ * Coder  : Ean Jee
+ * Time   : 2026-10-19 10:12
+ ******************************************************************************/
+
+#ifndef _THREAD_IG_H
+#define _THREAD_IG_H
+
+/*
+ * Storage class of a variable each thread has its own copy of.
+ */
+#ifdef _MSC_VER
+#define IG_THREAD_LOCAL __declspec(thread)
+#else
+#define IG_THREAD_LOCAL __thread
+#endif /* _MSC_VER */
+
+/*
+ * A thread runs pfEntry(pArg) until it returns.
+ */
+struct IG_THREAD_T;
+typedef struct IG_THREAD_T IG_THREAD;
+
+typedef void (*IG_THREAD_ENTRY)(void *pArg);
+
+/*
+ * A counting semaphore, waiting on it blocks while the count is 0.
+ */
+struct IG_SEMAPHORE_T;
+typedef struct IG_SEMAPHORE_T IG_SEMAPHORE;
+
+extern int IgCreateThread(IG_THREAD **ppThread, IG_THREAD_ENTRY pfEntry, 
+                          void *pArg);
+extern void IgJoinThread(IG_THREAD *pThread);
+
+extern int IgCreateSemaphore(IG_SEMAPHORE **ppSem, int count);
+extern void IgDeleteSemaphore(IG_SEMAPHORE *pSem);
+extern void IgPostSemaphore(IG_SEMAPHORE *pSem);
+extern void IgWaitSemaphore(IG_SEMAPHORE *pSem);
+
+/*
+ * Loads have acquire semantics and stores have release semantics, so that 
+ * data written before a store is visible to the thread loading it.
+ */
+extern int IgAtomicLoad(volatile int *pValue);
+extern void IgAtomicStore(volatile int *pValue, int value);
+extern int IgAtomicExchange(volatile int *pValue, int value);
+
+extern void IgSpinLock(volatile int *pLock);
+extern void IgSpinUnlock(volatile int *pLock);
+
+#endif /* _THREAD_IG_H */
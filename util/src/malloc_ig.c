@@ -12,11 +12,23 @@
 #include "assert_ig.h"
 #include "block_ig.h"
 #include "malloc_ig.h"
+#include "thread_ig.h"
 
 /*----------------------------------------------------------------------------*/
 /*                            Private data/functions                          */
 /*----------------------------------------------------------------------------*/
 
+#ifndef NDEBUG
+
+/*------------------------------------------------------------------------------
+ * s_blockLock guards the memory log, as blocks may be allocated and freed
+ * by more than one thread.
+ */
+
+static volatile int s_blockLock = 0;
+
+#endif /* NDEBUG */
+
 /*----------------------------------------------------------------------------*/
 /*                               Public functions                             */
 /*----------------------------------------------------------------------------*/
@@ -51,11 +63,13 @@ int IgNewMemory(void **new, size_t size)
             /* If unable to create the block information,
              * fake a total memory failure.
              */
+            IgSpinLock(&s_blockLock);
             if (!IgCreateBlockInfo(*ppbNew, size))
             {
                 free(*ppbNew);
                 *ppbNew = NULL;
             }
+            IgSpinUnlock(&s_blockLock);
         }
     }
 #endif /* NDEBUG*/
@@ -91,7 +105,9 @@ int IgResizeMemory(void **toResize, size_t newSize)
 
 #ifndef NDEBUG
     {
+        IgSpinLock(&s_blockLock);
         oldSize = IgSizeOfBlock(*ppbOld);
+        IgSpinUnlock(&s_blockLock);
 
         /* If the block is shrinking, pre-fill the soon-to-be-released
          * memory. If the block is expanding, force it to move (instead
@@ -120,7 +136,9 @@ int IgResizeMemory(void **toResize, size_t newSize)
     {
 #ifndef NDEBUG
         {
+            IgSpinLock(&s_blockLock);
             IgUpdateBlockInfo(*ppbOld, pbNew, newSize);
+            IgSpinUnlock(&s_blockLock);
 
             /* If expanding, initialize the new tail. */
             if (newSize > oldSize)
@@ -149,8 +167,14 @@ void IgFreeMemory(void *toFree)
 {
 #ifndef NDEBUG
     {
-        memset(toFree, GARBAGE, IgSizeOfBlock(toFree));
+        size_t size;
+
+        IgSpinLock(&s_blockLock);
+        size = IgSizeOfBlock(toFree);
         IgFreeBlockInfo(toFree);
+        IgSpinUnlock(&s_blockLock);
+
+        memset(toFree, GARBAGE, size);
     }
 #endif /* NDEBUG */
 
@@ -0,0 +1,306 @@
+/*******************************************************************************
+ * File   : thread_ig.c
+ * Content: Threads, semaphores and atomic operations
+ *
+ * Coder  : Ean Jee
+ * Time   : 2026-10-19 10:20
+ ******************************************************************************/
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif /* _WIN32 */
+
+#include "datadef_ig.h"
+#include "assert_ig.h"
+#include "malloc_ig.h"
+#include "thread_ig.h"
+
+/*----------------------------------------------------------------------------*/
+/*                            Private data/functions                          */
+/*----------------------------------------------------------------------------*/
+
+struct IG_THREAD_T
+{
+#ifdef _WIN32
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif /* _WIN32 */
+
+    IG_THREAD_ENTRY pfEntry;
+    void *pArg;
+};
+
+struct IG_SEMAPHORE_T
+{
+#ifdef _WIN32
+    HANDLE handle;
+#else
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int count;
+#endif /* _WIN32 */
+};
+
+/*------------------------------------------------------------------------------
+ * IgThreadProc runs the entry of a thread with the signature the platform
+ * expects.
+ */
+#ifdef _WIN32
+static DWORD WINAPI IgThreadProc(LPVOID pParam)
+{
+    IG_THREAD *pThread = (IG_THREAD *)pParam;
+
+    pThread->pfEntry(pThread->pArg);
+
+    return 0;
+}
+#else
+static void* IgThreadProc(void *pParam)
+{
+    IG_THREAD *pThread = (IG_THREAD *)pParam;
+
+    pThread->pfEntry(pThread->pArg);
+
+    return NULL;
+}
+#endif /* _WIN32 */
+
+/*----------------------------------------------------------------------------*/
+/*                               Public functions                             */
+/*----------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------------
+ * int IgCreateThread(IG_THREAD **ppThread, IG_THREAD_ENTRY pfEntry, 
+ *                    void *pArg)
+ *
+ * IgCreateThread starts a thread running pfEntry(pArg).
+ * 
+ * Return:
+ *     TRUE if successful; otherwise, FALSE.
+ */
+int IgCreateThread(IG_THREAD **ppThread, IG_THREAD_ENTRY pfEntry, 
+                   void *pArg)
+{
+    IG_THREAD *pThread;
+
+    ASSERTMSG(ppThread != NULL && pfEntry != NULL, 
+              "IgCreateThread: invalid arguments.");
+
+    if (!IgNewMemory((void **)ppThread, sizeof(IG_THREAD)))
+    {
+        return FALSE;
+    }
+
+    pThread = *ppThread;
+    pThread->pfEntry = pfEntry;
+    pThread->pArg = pArg;
+
+#ifdef _WIN32
+    pThread->handle = CreateThread(NULL, 0, IgThreadProc, pThread, 0, NULL);
+    if (pThread->handle == NULL)
+#else
+    if (pthread_create(&pThread->handle, NULL, IgThreadProc, pThread) != 0)
+#endif /* _WIN32 */
+    {
+        IgFreeMemory(pThread);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * void IgJoinThread(IG_THREAD *pThread)
+ *
+ * IgJoinThread waits for a thread to return from its entry, and deletes it.
+ */
+void IgJoinThread(IG_THREAD *pThread)
+{
+    ASSERTMSG(pThread != NULL, "IgJoinThread: invalid argument.");
+
+#ifdef _WIN32
+    WaitForSingleObject(pThread->handle, INFINITE);
+    CloseHandle(pThread->handle);
+#else
+    pthread_join(pThread->handle, NULL);
+#endif /* _WIN32 */
+
+    IgFreeMemory(pThread);
+}
+
+/*------------------------------------------------------------------------------
+ * int IgCreateSemaphore(IG_SEMAPHORE **ppSem, int count)
+ *
+ * IgCreateSemaphore creates a semaphore with an initial count.
+ * 
+ * Return:
+ *     TRUE if successful; otherwise, FALSE.
+ */
+int IgCreateSemaphore(IG_SEMAPHORE **ppSem, int count)
+{
+    IG_SEMAPHORE *pSem;
+
+    ASSERTMSG(ppSem != NULL && count >= 0, 
+              "IgCreateSemaphore: invalid arguments.");
+
+    if (!IgNewMemory((void **)ppSem, sizeof(IG_SEMAPHORE)))
+    {
+        return FALSE;
+    }
+    pSem = *ppSem;
+
+#ifdef _WIN32
+    pSem->handle = CreateSemaphore(NULL, count, 0x7fffffff, NULL);
+    if (pSem->handle == NULL)
+    {
+        IgFreeMemory(pSem);
+        return FALSE;
+    }
+#else
+    if (pthread_mutex_init(&pSem->mutex, NULL) != 0)
+    {
+        IgFreeMemory(pSem);
+        return FALSE;
+    }
+
+    if (pthread_cond_init(&pSem->cond, NULL) != 0)
+    {
+        pthread_mutex_destroy(&pSem->mutex);
+        IgFreeMemory(pSem);
+        return FALSE;
+    }
+
+    pSem->count = count;
+#endif /* _WIN32 */
+
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * void IgDeleteSemaphore(IG_SEMAPHORE *pSem)
+ *
+ * IgDeleteSemaphore deletes a semaphore no thread is waiting on.
+ */
+void IgDeleteSemaphore(IG_SEMAPHORE *pSem)
+{
+    ASSERTMSG(pSem != NULL, "IgDeleteSemaphore: invalid argument.");
+
+#ifdef _WIN32
+    CloseHandle(pSem->handle);
+#else
+    pthread_cond_destroy(&pSem->cond);
+    pthread_mutex_destroy(&pSem->mutex);
+#endif /* _WIN32 */
+
+    IgFreeMemory(pSem);
+}
+
+/*------------------------------------------------------------------------------
+ * void IgPostSemaphore(IG_SEMAPHORE *pSem)
+ *
+ * IgPostSemaphore increments the count, waking up a waiting thread if any.
+ */
+void IgPostSemaphore(IG_SEMAPHORE *pSem)
+{
+    ASSERTMSG(pSem != NULL, "IgPostSemaphore: invalid argument.");
+
+#ifdef _WIN32
+    ReleaseSemaphore(pSem->handle, 1, NULL);
+#else
+    pthread_mutex_lock(&pSem->mutex);
+    pSem->count++;
+    pthread_cond_signal(&pSem->cond);
+    pthread_mutex_unlock(&pSem->mutex);
+#endif /* _WIN32 */
+}
+
+/*------------------------------------------------------------------------------
+ * void IgWaitSemaphore(IG_SEMAPHORE *pSem)
+ *
+ * IgWaitSemaphore blocks until the count is positive, then decrements it.
+ */
+void IgWaitSemaphore(IG_SEMAPHORE *pSem)
+{
+    ASSERTMSG(pSem != NULL, "IgWaitSemaphore: invalid argument.");
+
+#ifdef _WIN32
+    WaitForSingleObject(pSem->handle, INFINITE);
+#else
+    pthread_mutex_lock(&pSem->mutex);
+    while (pSem->count == 0)
+    {
+        pthread_cond_wait(&pSem->cond, &pSem->mutex);
+    }
+    pSem->count--;
+    pthread_mutex_unlock(&pSem->mutex);
+#endif /* _WIN32 */
+}
+
+/*------------------------------------------------------------------------------
+ * int IgAtomicLoad(volatile int *pValue)
+ * void IgAtomicStore(volatile int *pValue, int value)
+ * int IgAtomicExchange(volatile int *pValue, int value)
+ *
+ * Atomic operations on an int shared between threads. IgAtomicExchange
+ * stores value and returns the previous one, as a full barrier.
+ */
+int IgAtomicLoad(volatile int *pValue)
+{
+#ifdef _WIN32
+    return InterlockedCompareExchange((volatile LONG *)pValue, 0, 0);
+#else
+    return __atomic_load_n(pValue, __ATOMIC_ACQUIRE);
+#endif /* _WIN32 */
+}
+
+void IgAtomicStore(volatile int *pValue, int value)
+{
+#ifdef _WIN32
+    InterlockedExchange((volatile LONG *)pValue, value);
+#else
+    __atomic_store_n(pValue, value, __ATOMIC_RELEASE);
+#endif /* _WIN32 */
+}
+
+int IgAtomicExchange(volatile int *pValue, int value)
+{
+#ifdef _WIN32
+    return InterlockedExchange((volatile LONG *)pValue, value);
+#else
+    return __atomic_exchange_n(pValue, value, __ATOMIC_SEQ_CST);
+#endif /* _WIN32 */
+}
+
+/*------------------------------------------------------------------------------
+ * void IgSpinLock(volatile int *pLock)
+ * void IgSpinUnlock(volatile int *pLock)
+ *
+ * A lock for very short critical sections, *pLock must start as 0.
+ */
+void IgSpinLock(volatile int *pLock)
+{
+    while (IgAtomicExchange(pLock, 1))
+    {
+        /* Wait with loads rather than exchanges, to keep the cache line
+         * from bouncing between cores.
+         */
+        while (IgAtomicLoad(pLock))
+        {
+#ifdef _WIN32
+            SwitchToThread();
+#else
+            sched_yield();
+#endif /* _WIN32 */
+        }
+    }
+}
+
+void IgSpinUnlock(volatile int *pLock)
+{
+    IgAtomicStore(pLock, 0);
+}